@@ -0,0 +1,104 @@
+# Embeds compiled SPIR-V shaders into a generated C++ header, so that shaders can be used
+# without reading any files at runtime. Each shader becomes a constexpr uint32_t array,
+# which is suitably aligned for VkShaderModuleCreateInfo::pCode. The array names are
+# derived from the file names, e.g. "triangle.vert.spv" becomes kTriangleVertSpv.
+#
+# Usage:
+#   grace_embed_shaders(<target>
+#                       HEADER <header name, e.g. embedded_shaders.hpp>
+#                       [NAMESPACE <namespace>]
+#                       SHADERS <SPIR-V files>...)
+#
+# The generated header is added to the include directories of the target, and is
+# regenerated whenever any of the shaders change.
+
+if (CMAKE_SCRIPT_MODE_FILE)
+  # Invoked at build time as: cmake -DGRACE_EMBED_OUTPUT=... -P GraceEmbedShaders.cmake
+  set(GRACE_EMBED_CONTENTS "// Generated by grace_embed_shaders, do not edit.\n")
+  string(APPEND GRACE_EMBED_CONTENTS "#pragma once\n\n#include <cstdint>\n\n")
+
+  if (GRACE_EMBED_NAMESPACE)
+    string(APPEND GRACE_EMBED_CONTENTS "namespace ${GRACE_EMBED_NAMESPACE} {\n\n")
+  endif ()
+
+  foreach (shader_file IN LISTS GRACE_EMBED_SHADERS)
+    file(READ "${shader_file}" shader_hex HEX)
+    string(LENGTH "${shader_hex}" shader_hex_length)
+
+    math(EXPR shader_remainder "${shader_hex_length} % 8")
+    if (shader_hex_length EQUAL 0 OR NOT shader_remainder EQUAL 0)
+      message(FATAL_ERROR "${shader_file} is not valid SPIR-V code")
+    endif ()
+
+    # Convert the file name to an identifier, e.g. "triangle.vert.spv" -> kTriangleVertSpv
+    get_filename_component(shader_name "${shader_file}" NAME)
+    string(REGEX MATCHALL "[A-Za-z0-9]+" shader_name_parts "${shader_name}")
+    set(shader_identifier "k")
+
+    foreach (part IN LISTS shader_name_parts)
+      string(SUBSTRING "${part}" 0 1 part_head)
+      string(SUBSTRING "${part}" 1 -1 part_tail)
+      string(TOUPPER "${part_head}" part_head)
+      string(APPEND shader_identifier "${part_head}${part_tail}")
+    endforeach ()
+
+    # SPIR-V words are stored in little-endian byte order, and are written six per line
+    string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1u," shader_words "${shader_hex}")
+    string(REPEAT "0x........u," 6 shader_line_pattern)
+    string(REGEX REPLACE
+           "(${shader_line_pattern})"
+           "\\1\n    "
+           shader_words
+           "${shader_words}")
+    string(REPLACE "u,0x" "u, 0x" shader_words "${shader_words}")
+    string(STRIP "${shader_words}" shader_words)
+
+    string(APPEND GRACE_EMBED_CONTENTS
+           "inline constexpr std::uint32_t ${shader_identifier}[] = {\n"
+           "    ${shader_words}\n"
+           "};\n\n")
+  endforeach ()
+
+  if (GRACE_EMBED_NAMESPACE)
+    string(APPEND GRACE_EMBED_CONTENTS "}  // namespace ${GRACE_EMBED_NAMESPACE}\n")
+  endif ()
+
+  # Avoid touching the header if nothing changed, to prevent needless recompilation
+  file(CONFIGURE OUTPUT "${GRACE_EMBED_OUTPUT}" CONTENT "${GRACE_EMBED_CONTENTS}" @ONLY)
+  return()
+endif ()
+
+function(grace_embed_shaders target)
+  cmake_parse_arguments(PARSE_ARGV 1 GRACE_EMBED "" "HEADER;NAMESPACE" "SHADERS")
+
+  if (NOT GRACE_EMBED_HEADER)
+    message(FATAL_ERROR "grace_embed_shaders requires a HEADER name")
+  endif ()
+
+  if (NOT GRACE_EMBED_SHADERS)
+    message(FATAL_ERROR "grace_embed_shaders requires at least one shader")
+  endif ()
+
+  set(shader_files "")
+  foreach (shader IN LISTS GRACE_EMBED_SHADERS)
+    get_filename_component(shader_file "${shader}" ABSOLUTE)
+    list(APPEND shader_files "${shader_file}")
+  endforeach ()
+
+  set(output_dir "${CMAKE_CURRENT_BINARY_DIR}/grace_embedded_shaders/${target}")
+  set(output_file "${output_dir}/${GRACE_EMBED_HEADER}")
+
+  add_custom_command(OUTPUT "${output_file}"
+                     COMMAND ${CMAKE_COMMAND}
+                             "-DGRACE_EMBED_SHADERS=${shader_files}"
+                             "-DGRACE_EMBED_NAMESPACE=${GRACE_EMBED_NAMESPACE}"
+                             "-DGRACE_EMBED_OUTPUT=${output_file}"
+                             -P "${CMAKE_CURRENT_FUNCTION_LIST_FILE}"
+                     DEPENDS ${shader_files} "${CMAKE_CURRENT_FUNCTION_LIST_FILE}"
+                     COMMENT "Embedding shaders in ${GRACE_EMBED_HEADER}"
+                     VERBATIM
+                     )
+
+  target_sources(${target} PRIVATE "${output_file}")
+  target_include_directories(${target} PRIVATE "${output_dir}")
+endfunction()
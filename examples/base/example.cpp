@@ -196,7 +196,10 @@ Example::Example(const char* name)
 
   mRenderPass = RenderPassBuilder {mDevice}
                     .color_attachment(mSwapchain.info().image_format)
-                    .depth_attachment(mSwapchain.info().depth_buffer_format)
+                    .depth_attachment(mSwapchain.info().depth_buffer_format,
+                                      VK_IMAGE_LAYOUT_UNDEFINED,
+                                      VK_SAMPLE_COUNT_1_BIT,
+                                      VK_ATTACHMENT_STORE_OP_DONT_CARE)
                     .begin_subpass()
                     .use_color_attachment(0)
                     .use_depth_attachment(1)
@@ -208,7 +211,8 @@ Example::Example(const char* name)
     throw std::runtime_error {"Could not create render pass"};
   }
 
-  mPipelineCache = PipelineCache::make(mDevice, nullptr, 0, 0, &result);
+  mPipelineCache =
+      PipelineCache::load_or_create(mDevice, mGPU, kPipelineCachePath, &result);
   if (!mPipelineCache) {
     std::cerr << "Could not create pipeline cache: " << to_string(result) << '\n';
     throw std::runtime_error {"Could not create pipeline cache"};
@@ -327,6 +331,12 @@ void Example::start()
     std::cerr << "vkDeviceWaitIdle failed: " << to_string(wait_result) << '\n';
   }
 
+  // Persist compiled pipelines so that subsequent runs start faster.
+  if (const auto save_result = mPipelineCache.save(kPipelineCachePath);
+      save_result != VK_SUCCESS) {
+    std::cerr << "Could not save pipeline cache: " << to_string(save_result) << '\n';
+  }
+
   mWindow.hide();
 }
 
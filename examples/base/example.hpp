@@ -37,6 +37,7 @@ namespace grace::examples {
 
 inline constexpr ApiVersion kTargetVulkanVersion = {1, 2};
 inline constexpr usize kMaxFramesInFlight = 2;
+inline constexpr const char* kPipelineCachePath = "pipeline_cache.bin";
 
 #ifdef NDEBUG
 inline const std::vector<const char*> kEnabledLayers;
@@ -29,6 +29,8 @@
 
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "triangle_shaders.hpp"
+
 namespace grace::examples {
 
 TriangleExample::TriangleExample()
@@ -59,8 +61,8 @@ TriangleExample::TriangleExample()
           .with_render_pass(mRenderPass, 0)
           .with_layout(mPipelineLayout)
           .with_cache(mPipelineCache)
-          .vertex_shader("shaders/triangle.vert.spv")
-          .fragment_shader("shaders/triangle.frag.spv")
+          .vertex_shader(kTriangleVertSpv)
+          .fragment_shader(kTriangleFragSpv)
           .vertex_input_binding(0, sizeof(Vertex))
           .vertex_attribute(0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, position))
           .vertex_attribute(0, 1, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, color))
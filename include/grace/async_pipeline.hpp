@@ -0,0 +1,138 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <future>  // future
+
+#include <vulkan/vulkan.h>
+
+#include "common.hpp"
+#include "pipeline.hpp"
+#include "thread_pool.hpp"
+
+namespace grace {
+
+/**
+ * A graphics pipeline that is compiled in the background.
+ *
+ * \details Compiling a pipeline may take a long time, so blocking the render thread
+ *          until a new pipeline is compiled causes frame time spikes. An asynchronous
+ *          pipeline instead provides a fallback pipeline, e.g. a simpler shader or a
+ *          pipeline linked from pipeline libraries, until the requested pipeline is
+ *          ready. Without a fallback, draws that use the pipeline should be skipped.
+ *
+ * \note Asynchronous pipelines are not thread-safe, and are intended to be polled by a
+ *       single thread, e.g. the render thread.
+ */
+class AsyncPipeline final {
+ public:
+  AsyncPipeline() = default;
+
+  /**
+   * Creates an asynchronous pipeline from a pending pipeline.
+   *
+   * \param pending  the pending pipeline, e.g. from a pipeline library cache.
+   * \param fallback the pipeline used until the pending pipeline is ready, may be null.
+   */
+  explicit AsyncPipeline(std::future<GraphicsPipelineResult> pending,
+                         VkPipeline fallback = VK_NULL_HANDLE) noexcept;
+
+  AsyncPipeline(AsyncPipeline&& other) noexcept = default;
+  AsyncPipeline(const AsyncPipeline& other) = delete;
+
+  auto operator=(AsyncPipeline&& other) noexcept -> AsyncPipeline& = default;
+  auto operator=(const AsyncPipeline& other) -> AsyncPipeline& = delete;
+
+  /**
+   * Requests a pipeline to be compiled on a thread pool.
+   *
+   * \details This function returns immediately.
+   *
+   * \param builder  the pipeline builder that describes the pipeline, which is copied.
+   * \param pool     the thread pool that compiles the pipeline.
+   * \param fallback the pipeline used until the requested pipeline is ready, may be null.
+   *
+   * \return an asynchronous pipeline.
+   */
+  [[nodiscard]] static auto request(const GraphicsPipelineBuilder& builder,
+                                    ThreadPool& pool,
+                                    VkPipeline fallback = VK_NULL_HANDLE)
+      -> AsyncPipeline;
+
+  /**
+   * Blocks until the requested pipeline is no longer pending.
+   */
+  void wait();
+
+  /**
+   * Binds the best available pipeline to the graphics bind point.
+   *
+   * \param cmd_buf the command buffer that will record the command.
+   *
+   * \return true if a pipeline was bound; false if there is nothing to bind.
+   */
+  auto bind(VkCommandBuffer cmd_buf) -> bool;
+
+  /**
+   * Indicates whether the requested pipeline has been compiled successfully.
+   *
+   * \return true if the requested pipeline is available; false otherwise.
+   */
+  [[nodiscard]] auto ready() -> bool;
+
+  /**
+   * Indicates whether the requested pipeline is still being compiled.
+   *
+   * \return true if compilation hasn't finished yet; false otherwise.
+   */
+  [[nodiscard]] auto pending() -> bool;
+
+  /**
+   * Returns the best available pipeline.
+   *
+   * \return the requested pipeline if it's ready, otherwise the fallback pipeline.
+   */
+  [[nodiscard]] auto get() -> VkPipeline;
+
+  /**
+   * Returns the outcome of the pipeline compilation.
+   *
+   * \return `VK_NOT_READY` while the pipeline is pending, `VK_ERROR_UNKNOWN` if no
+   *         pipeline was requested, otherwise the result code.
+   */
+  [[nodiscard]] auto result() -> VkResult;
+
+  [[nodiscard]] auto fallback() const noexcept -> VkPipeline { return mFallback; }
+
+ private:
+  std::future<GraphicsPipelineResult> mPending;
+  GraphicsPipeline mPipeline;
+  VkPipeline mFallback {VK_NULL_HANDLE};
+  VkResult mResult {VK_ERROR_UNKNOWN};
+
+  void _poll();
+};
+
+}  // namespace grace
@@ -166,10 +166,29 @@ class Buffer final {
    *
    * \param data      the data to store in the buffer.
    * \param data_size the size of the data in bytes.
+   * \param offset    the offset into the buffer at which the data is stored, in bytes.
    *
    * \return `VK_SUCCESS` if the buffer was successfully updated, or an error otherwise.
    */
-  auto set_data(const void* data, uint64 data_size) -> VkResult;
+  auto set_data(const void* data, uint64 data_size, uint64 offset = 0) -> VkResult;
+
+  /**
+   * Maps the buffer memory into the host address space.
+   *
+   * \details This is useful for writing data directly into the buffer, e.g., when
+   *          decoding files into staging buffers, which avoids intermediate copies.
+   *          Each successful call must be matched by a call to `unmap()`.
+   *
+   * \note This function is only usable for buffers that are host-visible.
+   *
+   * \param[out] result the resulting error code.
+   *
+   * \return a pointer to the mapped memory, or null if the memory couldn't be mapped.
+   */
+  [[nodiscard]] auto map(VkResult* result = nullptr) -> void*;
+
+  /// Unmaps memory previously mapped with `map()`.
+  void unmap() noexcept;
 
   void bind_as_vertex_buffer(VkCommandBuffer cmd_buffer);
 
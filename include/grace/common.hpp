@@ -24,16 +24,19 @@
 
 #pragma once
 
-#include <array>    // size
-#include <cstddef>  // size_t
-#include <cstdint>  // uint32_t, uint64_t
-#include <limits>   // numeric_limits
+#include <array>       // size
+#include <cstddef>     // size_t
+#include <cstdint>     // uint8_t, uint16_t, uint32_t, uint64_t
+#include <functional>  // hash
+#include <limits>      // numeric_limits
 
 #include <vulkan/vulkan.h>
 
 namespace grace {
 
 using usize = std::size_t;
+using uint8 = std::uint8_t;
+using uint16 = std::uint16_t;
 using uint32 = std::uint32_t;
 using uint64 = std::uint64_t;
 using int32 = std::int32_t;
@@ -41,6 +44,9 @@ using int32 = std::int32_t;
 inline constexpr uint32 kMaxU32 = std::numeric_limits<uint32>::max();
 inline constexpr uint64 kMaxU64 = std::numeric_limits<uint64>::max();
 
+inline constexpr uint64 kFnv1aOffsetBasis = 0xCBF29CE484222325;
+inline constexpr uint64 kFnv1aPrime = 0x100000001B3;
+
 [[nodiscard]] auto to_string(VkResult result) -> const char*;
 
 template <typename Container>
@@ -61,4 +67,32 @@ template <typename Container>
   return !container.empty() ? container.data() : nullptr;
 }
 
+/**
+ * Computes the 64-bit FNV-1a hash of a sequence of bytes.
+ *
+ * \details Unlike `std::hash`, the resulting hash values are stable across runs and
+ *          platforms, which makes them suitable for persistent keys. A previous hash can
+ *          be provided as the seed in order to hash several byte sequences incrementally.
+ *
+ * \param data the bytes that will be hashed.
+ * \param size the number of bytes.
+ * \param seed the initial hash value.
+ *
+ * \return a hash of the bytes.
+ */
+[[nodiscard]] auto fnv1a_hash(const void* data, usize size, uint64 seed = kFnv1aOffsetBasis)
+    -> uint64;
+
+/**
+ * Mixes the hash of a value into an existing hash value.
+ *
+ * \param[in,out] seed  the hash value that will be updated.
+ * \param         value the value that will be hashed.
+ */
+template <typename T>
+void hash_combine(usize& seed, const T& value)
+{
+  seed ^= std::hash<T> {}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
 }  // namespace grace
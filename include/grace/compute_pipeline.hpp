@@ -0,0 +1,228 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <span>    // span
+#include <string>  // string
+
+#include <vulkan/vulkan.h>
+
+#include "common.hpp"
+#include "pipeline.hpp"
+#include "pipeline_feedback.hpp"
+#include "shader_library.hpp"
+#include "shader_module.hpp"
+#include "specialization_constants.hpp"
+
+namespace grace {
+
+/**
+ * Returns the number of workgroups required to cover a number of invocations.
+ *
+ * \param invocation_count the total number of invocations, e.g. the number of elements.
+ * \param local_size       the number of invocations per workgroup.
+ *
+ * \return the number of workgroups, rounded up.
+ */
+[[nodiscard]] constexpr auto get_group_count(const uint32 invocation_count,
+                                             const uint32 local_size) noexcept -> uint32
+{
+  // Avoids the overflow of adding local_size - 1 to large invocation counts
+  return (local_size != 0) ? invocation_count / local_size +
+                                 static_cast<uint32>(invocation_count % local_size != 0)
+                           : 0;
+}
+
+/**
+ * Records a one-dimensional compute dispatch.
+ *
+ * \param cmd_buf          the command buffer that will record the dispatch.
+ * \param invocation_count the total number of invocations.
+ * \param local_size       the local workgroup size of the compute shader.
+ */
+void cmd_dispatch_1d(VkCommandBuffer cmd_buf, uint32 invocation_count, uint32 local_size);
+
+/**
+ * Records a two-dimensional compute dispatch, e.g. for image processing.
+ *
+ * \param cmd_buf    the command buffer that will record the dispatch.
+ * \param extent     the total number of invocations in each dimension.
+ * \param local_size the local workgroup size of the compute shader.
+ */
+void cmd_dispatch_2d(VkCommandBuffer cmd_buf,
+                     const VkExtent2D& extent,
+                     const VkExtent2D& local_size);
+
+/**
+ * Records a three-dimensional compute dispatch.
+ *
+ * \param cmd_buf    the command buffer that will record the dispatch.
+ * \param extent     the total number of invocations in each dimension.
+ * \param local_size the local workgroup size of the compute shader.
+ */
+void cmd_dispatch_3d(VkCommandBuffer cmd_buf,
+                     const VkExtent3D& extent,
+                     const VkExtent3D& local_size);
+
+class ComputePipeline final : public Pipeline {
+ public:
+  using Pipeline::Pipeline;
+
+  [[nodiscard]] static auto make(VkDevice device,
+                                 const VkComputePipelineCreateInfo& pipeline_info,
+                                 VkPipelineCache cache = VK_NULL_HANDLE,
+                                 VkResult* result = nullptr) -> ComputePipeline;
+
+  /// Binds the pipeline to the compute bind point.
+  void bind(VkCommandBuffer cmd_buf);
+};
+
+class ComputePipelineBuilder final {
+ public:
+  using Self = ComputePipelineBuilder;
+
+  explicit ComputePipelineBuilder(VkDevice device);
+
+  /**
+   * Resets the internal state.
+   *
+   * \return the pipeline builder itself.
+   */
+  auto reset() -> Self&;
+
+  /**
+   * Specifies the pipeline layout.
+   *
+   * \note This function must be called in order to be able to build the pipeline.
+   *
+   * \param layout the associated pipeline layout.
+   *
+   * \return the pipeline builder itself.
+   */
+  auto with_layout(VkPipelineLayout layout) -> Self&;
+
+  /**
+   * Specifies the associated pipeline cache.
+   *
+   * \param cache a pipeline cache.
+   *
+   * \return the pipeline builder itself.
+   */
+  auto with_cache(VkPipelineCache cache) -> Self&;
+
+  /**
+   * Specifies a shader library used to load shaders specified by file paths.
+   *
+   * \param library a shader library that outlives the builder, or null.
+   *
+   * \return the pipeline builder itself.
+   */
+  auto with_shader_library(ShaderLibrary* library) -> Self&;
+
+  /**
+   * Specifies a callback that receives the creation statistics of built pipelines.
+   *
+   * \note If feedback is not enabled, or the Vulkan headers lack the extension, the
+   *       callback still receives each built pipeline, but with no statistics and with
+   *       `valid` set to false.
+   *
+   * \param callback         the feedback callback, or null.
+   * \param feedback_enabled whether the device enables VK_EXT_pipeline_creation_feedback
+   *                         (or Vulkan 1.3).
+   *
+   * \return the pipeline builder itself.
+   */
+  auto with_feedback_callback(PipelineFeedbackCallback callback,
+                              bool feedback_enabled) -> Self&;
+
+  /**
+   * Specifies the compute shader that will be used.
+   *
+   * \note This function must be called in order to be able to build the pipeline.
+   *
+   * \param shader_path the file path to the compiled compute shader.
+   * \param entry_name  the name of the entry point function.
+   *
+   * \return the pipeline builder itself.
+   */
+  auto shader(const char* shader_path, const char* entry_name = "main") -> Self&;
+
+  /**
+   * Specifies the compute shader that will be used, as an existing shader module.
+   *
+   * \param shader_module a shader module that outlives any pipeline builds.
+   * \param entry_name    the name of the entry point function.
+   *
+   * \return the pipeline builder itself.
+   */
+  auto shader(VkShaderModule shader_module, const char* entry_name = "main") -> Self&;
+
+  /**
+   * Specifies the compute shader that will be used, as in-memory SPIR-V code.
+   *
+   * \param code       the compiled shader code, which outlives any pipeline builds.
+   * \param entry_name the name of the entry point function.
+   *
+   * \return the pipeline builder itself.
+   */
+  auto shader(std::span<const uint32> code, const char* entry_name = "main") -> Self&;
+
+  /**
+   * Specifies the specialization constant values used by the compute shader.
+   *
+   * \details This is useful for specifying the local workgroup size at pipeline creation.
+   *
+   * \param constants the specialization constant values, which are copied.
+   *
+   * \return the pipeline builder itself.
+   */
+  auto specialization(const SpecializationConstants& constants) -> Self&;
+
+  /**
+   * Attempts to create the specified pipeline.
+   *
+   * \param[out] result the resulting error code.
+   *
+   * \return a potentially null compute pipeline.
+   */
+  [[nodiscard]] auto build(VkResult* result = nullptr) const -> ComputePipeline;
+
+ private:
+  VkDevice mDevice {VK_NULL_HANDLE};
+  VkPipelineLayout mLayout {VK_NULL_HANDLE};
+  VkPipelineCache mCache {VK_NULL_HANDLE};
+  ShaderLibrary* mShaderLibrary {nullptr};
+  PipelineFeedbackCallback mFeedbackCallback;
+  bool mFeedbackEnabled {false};
+  std::string mShaderPath;
+  std::string mEntryName;
+  VkShaderModule mShaderModule {VK_NULL_HANDLE};
+  std::span<const uint32> mShaderCode;
+  SpecializationConstants mConstants;
+
+  [[nodiscard]] auto _is_complete() const -> bool;
+};
+
+}  // namespace grace
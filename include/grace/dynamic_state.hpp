@@ -0,0 +1,239 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>  // array
+
+#include <vulkan/vulkan.h>
+
+#include "common.hpp"
+
+namespace grace {
+
+#ifdef VK_EXT_extended_dynamic_state
+
+/**
+ * A subset of the pipeline states made dynamic by `VK_EXT_extended_dynamic_state`.
+ *
+ * \details The viewport and scissor with count states, and the vertex input binding
+ *          stride state, are deliberately excluded. They replace the regular viewport
+ *          and scissor dynamic states, and change how viewports, scissors and vertex
+ *          buffers must be bound, so they can't simply be added to existing pipelines.
+ *          Enable them individually where needed.
+ */
+inline constexpr std::array kExtendedDynamicStates = {
+    VK_DYNAMIC_STATE_CULL_MODE_EXT,
+    VK_DYNAMIC_STATE_FRONT_FACE_EXT,
+    VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT,
+    VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT,
+    VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT,
+    VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT,
+    VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE_EXT,
+    VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT,
+    VK_DYNAMIC_STATE_STENCIL_OP_EXT,
+};
+
+#endif  // VK_EXT_extended_dynamic_state
+
+#ifdef VK_EXT_extended_dynamic_state2
+
+/**
+ * The pipeline states made dynamic by `VK_EXT_extended_dynamic_state2`.
+ *
+ * \note The logic operator state is guarded by the `extendedDynamicState2LogicOp`
+ *       feature.
+ */
+inline constexpr std::array kExtendedDynamicStates2 = {
+    VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT,
+    VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT,
+    VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE_EXT,
+    VK_DYNAMIC_STATE_LOGIC_OP_EXT,
+};
+
+#endif  // VK_EXT_extended_dynamic_state2
+
+#ifdef VK_EXT_extended_dynamic_state3
+
+/**
+ * A subset of the pipeline states made dynamic by `VK_EXT_extended_dynamic_state3`.
+ *
+ * \note Each of these states is guarded by an individual device feature.
+ */
+inline constexpr std::array kExtendedDynamicStates3 = {
+    VK_DYNAMIC_STATE_POLYGON_MODE_EXT,
+    VK_DYNAMIC_STATE_DEPTH_CLAMP_ENABLE_EXT,
+    VK_DYNAMIC_STATE_LOGIC_OP_ENABLE_EXT,
+};
+
+#endif  // VK_EXT_extended_dynamic_state3
+
+struct ExtendedDynamicStateSupport final {
+  bool state1 : 1 {false};  ///< Support for all of `kExtendedDynamicStates`.
+  bool state2 : 1 {false};  ///< Support for all of `kExtendedDynamicStates2`.
+  bool state3 : 1 {false};  ///< Support for all of `kExtendedDynamicStates3`.
+};
+
+/**
+ * Queries the extended dynamic state features supported by a physical device.
+ *
+ * \param gpu the physical device to query.
+ *
+ * \return the supported extended dynamic state feature sets.
+ */
+[[nodiscard]] auto get_extended_dynamic_state_support(VkPhysicalDevice gpu)
+    -> ExtendedDynamicStateSupport;
+
+struct ExtendedDynamicStateFunctions final {
+#ifdef VK_EXT_extended_dynamic_state
+  PFN_vkCmdSetCullModeEXT vkCmdSetCullModeEXT {nullptr};
+  PFN_vkCmdSetFrontFaceEXT vkCmdSetFrontFaceEXT {nullptr};
+  PFN_vkCmdSetPrimitiveTopologyEXT vkCmdSetPrimitiveTopologyEXT {nullptr};
+  PFN_vkCmdSetDepthTestEnableEXT vkCmdSetDepthTestEnableEXT {nullptr};
+  PFN_vkCmdSetDepthWriteEnableEXT vkCmdSetDepthWriteEnableEXT {nullptr};
+  PFN_vkCmdSetDepthCompareOpEXT vkCmdSetDepthCompareOpEXT {nullptr};
+  PFN_vkCmdSetDepthBoundsTestEnableEXT vkCmdSetDepthBoundsTestEnableEXT {nullptr};
+  PFN_vkCmdSetStencilTestEnableEXT vkCmdSetStencilTestEnableEXT {nullptr};
+  PFN_vkCmdSetStencilOpEXT vkCmdSetStencilOpEXT {nullptr};
+#endif  // VK_EXT_extended_dynamic_state
+
+#ifdef VK_EXT_extended_dynamic_state2
+  PFN_vkCmdSetDepthBiasEnableEXT vkCmdSetDepthBiasEnableEXT {nullptr};
+  PFN_vkCmdSetPrimitiveRestartEnableEXT vkCmdSetPrimitiveRestartEnableEXT {nullptr};
+  PFN_vkCmdSetRasterizerDiscardEnableEXT vkCmdSetRasterizerDiscardEnableEXT {nullptr};
+  PFN_vkCmdSetLogicOpEXT vkCmdSetLogicOpEXT {nullptr};
+#endif  // VK_EXT_extended_dynamic_state2
+
+#ifdef VK_EXT_extended_dynamic_state3
+  PFN_vkCmdSetPolygonModeEXT vkCmdSetPolygonModeEXT {nullptr};
+  PFN_vkCmdSetDepthClampEnableEXT vkCmdSetDepthClampEnableEXT {nullptr};
+  PFN_vkCmdSetLogicOpEnableEXT vkCmdSetLogicOpEnableEXT {nullptr};
+#endif  // VK_EXT_extended_dynamic_state3
+};
+
+/**
+ * Loads the functions provided by the extended dynamic state extensions.
+ *
+ * \param device a logical device with the extensions enabled.
+ *
+ * \return the extension functions, which are null for extensions that aren't enabled.
+ */
+[[nodiscard]] auto get_extended_dynamic_state_functions(VkDevice device)
+    -> ExtendedDynamicStateFunctions;
+
+#ifdef VK_EXT_extended_dynamic_state
+
+void cmd_set_primitive_topology(const ExtendedDynamicStateFunctions& functions,
+                                VkCommandBuffer cmd_buf,
+                                VkPrimitiveTopology topology);
+
+/**
+ * Sets the dynamic cull mode and front face state.
+ *
+ * \param functions  the extended dynamic state functions.
+ * \param cmd_buf    the command buffer that will record the commands.
+ * \param cull_mode  the primitive culling mode.
+ * \param front_face the winding order used to determine the front faces of triangles.
+ */
+void cmd_set_cull_mode(const ExtendedDynamicStateFunctions& functions,
+                       VkCommandBuffer cmd_buf,
+                       VkCullModeFlags cull_mode,
+                       VkFrontFace front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE);
+
+/**
+ * Sets the dynamic depth test, depth write and depth compare operator state.
+ *
+ * \param functions     the extended dynamic state functions.
+ * \param cmd_buf       the command buffer that will record the commands.
+ * \param test_enabled  whether fragment depth testing is enabled.
+ * \param write_enabled whether depth writes are enabled.
+ * \param compare_op    the depth comparison operator.
+ */
+void cmd_set_depth_test(const ExtendedDynamicStateFunctions& functions,
+                        VkCommandBuffer cmd_buf,
+                        bool test_enabled,
+                        bool write_enabled,
+                        VkCompareOp compare_op = VK_COMPARE_OP_LESS);
+
+void cmd_set_depth_bounds_test(const ExtendedDynamicStateFunctions& functions,
+                               VkCommandBuffer cmd_buf,
+                               bool enabled);
+
+/**
+ * Sets the dynamic stencil test state.
+ *
+ * \details The compare and write masks, as well as the reference values, of the stencil
+ *          operation specifications are ignored, since they are separate dynamic states.
+ *
+ * \param functions the extended dynamic state functions.
+ * \param cmd_buf   the command buffer that will record the commands.
+ * \param enabled   whether stencil testing is enabled.
+ * \param front     the front stencil operation specification.
+ * \param back      the back stencil operation specification.
+ */
+void cmd_set_stencil_test(const ExtendedDynamicStateFunctions& functions,
+                          VkCommandBuffer cmd_buf,
+                          bool enabled,
+                          const VkStencilOpState& front = {},
+                          const VkStencilOpState& back = {});
+
+#endif  // VK_EXT_extended_dynamic_state
+
+#ifdef VK_EXT_extended_dynamic_state2
+
+void cmd_set_depth_bias_enable(const ExtendedDynamicStateFunctions& functions,
+                               VkCommandBuffer cmd_buf,
+                               bool enabled);
+
+void cmd_set_primitive_restart_enable(const ExtendedDynamicStateFunctions& functions,
+                                      VkCommandBuffer cmd_buf,
+                                      bool enabled);
+
+void cmd_set_rasterizer_discard_enable(const ExtendedDynamicStateFunctions& functions,
+                                       VkCommandBuffer cmd_buf,
+                                       bool enabled);
+
+void cmd_set_logic_op(const ExtendedDynamicStateFunctions& functions,
+                      VkCommandBuffer cmd_buf,
+                      VkLogicOp logic_op);
+
+#endif  // VK_EXT_extended_dynamic_state2
+
+#ifdef VK_EXT_extended_dynamic_state3
+
+void cmd_set_polygon_mode(const ExtendedDynamicStateFunctions& functions,
+                          VkCommandBuffer cmd_buf,
+                          VkPolygonMode polygon_mode);
+
+void cmd_set_depth_clamp_enable(const ExtendedDynamicStateFunctions& functions,
+                                VkCommandBuffer cmd_buf,
+                                bool enabled);
+
+void cmd_set_logic_op_enable(const ExtendedDynamicStateFunctions& functions,
+                             VkCommandBuffer cmd_buf,
+                             bool enabled);
+
+#endif  // VK_EXT_extended_dynamic_state3
+
+}  // namespace grace
@@ -0,0 +1,102 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <filesystem>     // path, file_time_type
+#include <string>         // string
+#include <unordered_map>  // unordered_map
+#include <vector>         // vector
+
+#include "common.hpp"
+
+namespace grace {
+
+/**
+ * Detects modifications of a set of files.
+ *
+ * \details On Linux, the parent directories of the watched files are monitored with
+ *          inotify, which also catches editors that save files by renaming a temporary
+ *          file. Elsewhere, or if inotify is unavailable, the modification times of the
+ *          watched files are compared on every poll instead.
+ *
+ * \note File watchers are not thread-safe.
+ */
+class FileWatcher final {
+ public:
+  FileWatcher();
+
+  FileWatcher(const FileWatcher& other) = delete;
+  FileWatcher(FileWatcher&& other) = delete;
+
+  auto operator=(const FileWatcher& other) -> FileWatcher& = delete;
+  auto operator=(FileWatcher&& other) -> FileWatcher& = delete;
+
+  ~FileWatcher() noexcept;
+
+  /**
+   * Starts watching a file for modifications.
+   *
+   * \param path the file path, which doesn't need to exist yet.
+   *
+   * \return true if the file is watched; false otherwise.
+   */
+  auto watch(const std::filesystem::path& path) -> bool;
+
+  /**
+   * Returns the watched files that have been modified since the previous poll.
+   *
+   * \details This function doesn't block.
+   *
+   * \return the normalized paths of the modified files, without duplicates.
+   */
+  [[nodiscard]] auto poll() -> std::vector<std::filesystem::path>;
+
+  /// Indicates whether modifications are detected by polling modification times.
+  [[nodiscard]] auto is_polling() const noexcept -> bool { return mInotify == -1; }
+
+  [[nodiscard]] auto watched_count() const noexcept -> usize { return mFiles.size(); }
+
+ private:
+  // Normalized file path -> last known modification time (only used when polling)
+  std::unordered_map<std::string, std::filesystem::file_time_type> mFiles;
+  std::unordered_map<int, std::filesystem::path> mDirectories;  // Watch -> directory
+  int mInotify {-1};
+
+  [[nodiscard]] auto _poll_inotify() -> std::vector<std::filesystem::path>;
+
+  [[nodiscard]] auto _poll_modification_times() -> std::vector<std::filesystem::path>;
+};
+
+/**
+ * Normalizes a file path, so that different spellings of a path compare equal.
+ *
+ * \param path a file path, which doesn't need to exist.
+ *
+ * \return the absolute and lexically normal file path.
+ */
+[[nodiscard]] auto normalize_file_path(const std::filesystem::path& path)
+    -> std::filesystem::path;
+
+}  // namespace grace
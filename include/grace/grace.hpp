@@ -25,32 +25,52 @@
 #pragma once
 
 #include "allocator.hpp"
+#include "async_pipeline.hpp"
 #include "buffer.hpp"
 #include "command_pool.hpp"
 #include "common.hpp"
+#include "compute_pipeline.hpp"
 #include "context.hpp"
 #include "debug.hpp"
 #include "descriptor_pool.hpp"
 #include "descriptor_set_layout.hpp"
 #include "descriptors.hpp"
 #include "device.hpp"
+#include "dynamic_state.hpp"
 #include "extras/sdl.hpp"
 #include "extras/window.hpp"
 #include "fence.hpp"
+#include "file_watcher.hpp"
 #include "framebuffer.hpp"
 #include "image.hpp"
 #include "image_view.hpp"
 #include "instance.hpp"
+#include "mapped_file.hpp"
 #include "physical_device.hpp"
 #include "pipeline.hpp"
 #include "pipeline_cache.hpp"
+#include "pipeline_cache_pool.hpp"
+#include "pipeline_feedback.hpp"
 #include "pipeline_layout.hpp"
+#include "pipeline_library.hpp"
+#include "pipeline_manifest.hpp"
+#include "pipeline_registry.hpp"
+#include "pixel_conversion.hpp"
 #include "queue.hpp"
 #include "render_pass.hpp"
+#include "rendering.hpp"
 #include "sampler.hpp"
+#include "sampler_cache.hpp"
 #include "semaphore.hpp"
+#include "shader_hot_reload.hpp"
+#include "shader_library.hpp"
 #include "shader_module.hpp"
+#include "shader_object.hpp"
+#include "shader_reflection.hpp"
+#include "specialization_constants.hpp"
 #include "surface.hpp"
 #include "swapchain.hpp"
 #include "texture.hpp"
+#include "texture_loader.hpp"
+#include "thread_pool.hpp"
 #include "version.hpp"
@@ -24,11 +24,15 @@
 
 #pragma once
 
+#include <vector>  // vector
+
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
 #include "common.hpp"
 #include "context.hpp"
+#include "image_view.hpp"
+#include "pixel_conversion.hpp"
 
 namespace grace {
 
@@ -61,14 +65,61 @@ namespace grace {
                                    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT)
     -> VkImageCreateInfo;
 
+/**
+ * Indicates whether image usage flags only describe framebuffer attachment usage.
+ *
+ * \details Attachment-only images, such as depth buffers and multisampled color targets,
+ *          are never used in transfer operations, and can be backed by lazily allocated
+ *          memory if the `VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT` flag is included.
+ *
+ * \param usage the image usage flags.
+ *
+ * \return true if the usage flags only contain attachment flags; false otherwise.
+ */
+[[nodiscard]] auto is_attachment_only_usage(VkImageUsageFlags usage) -> bool;
+
 [[nodiscard]] auto get_max_image_mip_levels(const VkExtent3D& extent) -> uint32;
 
+/**
+ * Returns the size of a single texel of an uncompressed color or depth format.
+ *
+ * \param format the texel data format.
+ *
+ * \return the texel size in bytes, or 0 for compressed, multi-planar, combined
+ *         depth/stencil and unknown formats.
+ */
+[[nodiscard]] auto get_format_texel_size(VkFormat format) noexcept -> uint32;
+
+/**
+ * Creates a buffer-to-image copy region specification.
+ *
+ * \param buffer_offset the offset into the source buffer, in bytes.
+ * \param image_offset  the texel offset of the destination region.
+ * \param image_extent  the size of the destination region, in texels.
+ * \param row_pitch     the length of source rows in texels, or 0 for tightly packed rows.
+ * \param mip_level     the destination mipmap level.
+ * \param array_layer   the destination array layer.
+ * \param aspects       the destination image aspects.
+ *
+ * \return a buffer-to-image copy region.
+ */
+[[nodiscard]] auto make_buffer_image_copy(
+    uint64 buffer_offset,
+    const VkOffset3D& image_offset,
+    const VkExtent3D& image_extent,
+    uint32 row_pitch = 0,
+    uint32 mip_level = 0,
+    uint32 array_layer = 0,
+    VkImageAspectFlags aspects = VK_IMAGE_ASPECT_COLOR_BIT) -> VkBufferImageCopy;
+
 void cmd_change_image_layout(VkCommandBuffer cmd_buf,
                              VkImage image,
                              VkImageLayout old_layout,
                              VkImageLayout new_layout,
                              uint32 base_mip_level,
-                             uint32 mip_level_count);
+                             uint32 mip_level_count,
+                             uint32 base_array_layer = 0,
+                             uint32 array_layer_count = 1);
 
 void cmd_copy_buffer_to_image(VkCommandBuffer cmd_buf,
                               VkBuffer buffer,
@@ -76,12 +127,59 @@ void cmd_copy_buffer_to_image(VkCommandBuffer cmd_buf,
                               const VkExtent3D& image_extent,
                               VkImageLayout image_layout);
 
+void cmd_copy_buffer_to_image(VkCommandBuffer cmd_buf,
+                              VkBuffer buffer,
+                              VkImage image,
+                              VkImageLayout image_layout,
+                              const VkBufferImageCopy* regions,
+                              uint32 region_count);
+
+/// Describes an update of a rectangular region of an image.
+struct ImageRegion final {
+  const void* data {nullptr};   ///< The source texel data.
+  uint64 data_size {0};         ///< The size of the source data in bytes.
+  VkOffset3D offset {0, 0, 0};  ///< The texel offset of the region.
+  VkExtent3D extent {0, 0, 0};  ///< The size of the region in texels.
+  uint32 row_pitch {0};         ///< The source row length in texels (0 if packed).
+  uint32 mip_level {0};         ///< The target mipmap level.
+  uint32 array_layer {0};       ///< The target array layer.
+};
+
+#ifdef VK_EXT_host_image_copy
+
+struct HostImageCopyFunctions final {
+  PFN_vkCopyMemoryToImageEXT vkCopyMemoryToImageEXT {nullptr};
+  PFN_vkTransitionImageLayoutEXT vkTransitionImageLayoutEXT {nullptr};
+};
+
+/**
+ * Loads the functions provided by the `VK_EXT_host_image_copy` extension.
+ *
+ * \param device a logical device with the extension enabled.
+ *
+ * \return the extension functions, which are null if the extension isn't enabled.
+ */
+[[nodiscard]] auto get_host_image_copy_functions(VkDevice device)
+    -> HostImageCopyFunctions;
+
+/**
+ * Indicates whether a physical device supports host image copies.
+ *
+ * \param gpu the physical device to query.
+ *
+ * \return true if the `hostImageCopy` feature is supported; false otherwise.
+ */
+[[nodiscard]] auto is_host_image_copy_supported(VkPhysicalDevice gpu) -> bool;
+
+#endif  // VK_EXT_host_image_copy
+
 struct ImageInfo final {
   VkExtent3D extent {0, 0, 0};
   VkImageLayout layout {VK_IMAGE_LAYOUT_UNDEFINED};
   VkFormat format {VK_FORMAT_UNDEFINED};
   VkSampleCountFlagBits samples {VK_SAMPLE_COUNT_1_BIT};
   uint32 mip_levels {1};
+  uint32 array_layers {1};
 
   void copy_from(const VkImageCreateInfo& image_info);
 };
@@ -139,17 +237,222 @@ class Image final {
                                  VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT,
                                  VkResult* result = nullptr) -> Image;
 
+  /**
+   * Creates a transient attachment image, e.g. for depth buffers or multisampled targets.
+   *
+   * \details The image is created with the `VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT`
+   *          flag and without any transfer usage flags, and is backed by lazily
+   *          allocated memory when such memory is available, which means that it may
+   *          consume little or no physical memory on tiled GPUs. Regular device local
+   *          memory is used as a fallback.
+   *
+   * \note The contents of transient attachments should never be needed after a render
+   *       pass, i.e. the store operation should be `VK_ATTACHMENT_STORE_OP_DONT_CARE`.
+   *
+   * \param      allocator the associated memory allocator.
+   * \param      extent    the image dimensions.
+   * \param      format    the texel data format.
+   * \param      usage     the attachment usage flags.
+   * \param      samples   the number of samples per texel.
+   * \param[out] result    the resulting error code.
+   *
+   * \return a potentially null image.
+   */
+  [[nodiscard]] static auto make_transient(
+      VmaAllocator allocator,
+      const VkExtent3D& extent,
+      VkFormat format,
+      VkImageUsageFlags usage,
+      VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT,
+      VkResult* result = nullptr) -> Image;
+
   auto set_data(const CommandContext& ctx,
                 VmaAllocator allocator,
                 const void* data,
                 uint64 data_size) -> VkResult;
 
+  /**
+   * Updates the contents of the image, converting the texels during the upload.
+   *
+   * \details The texels are converted directly into the mapped staging buffer, so each
+   *          texel is only touched once on the CPU. This is useful for source formats
+   *          that are rarely supported with optimal tiling, such as RGB8. Mipmaps are
+   *          generated after the upload.
+   *
+   * \param ctx         the associated command context.
+   * \param allocator   the allocator used to create the staging buffer.
+   * \param data        the source texel data.
+   * \param texel_count the number of source texels.
+   * \param conversion  the conversion applied to the source texels.
+   *
+   * \return `VK_SUCCESS` if the image was updated;
+   *         `VK_ERROR_FORMAT_NOT_SUPPORTED` if the converted texels don't match the
+   *         image format;
+   *         `VK_ERROR_VALIDATION_FAILED_EXT` if the texel count doesn't match the image
+   *         extent;
+   *         or another error otherwise.
+   */
+  auto set_data(const CommandContext& ctx,
+                VmaAllocator allocator,
+                const void* data,
+                uint64 texel_count,
+                PixelConversion conversion) -> VkResult;
+
+  /**
+   * Updates a region of the image.
+   *
+   * \details Only the specified region is uploaded, which makes this function suitable
+   *          for incremental updates of large images, such as glyph atlases. The image
+   *          is left in its previous layout, or in
+   *          `VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL` if the previous layout was
+   *          undefined.
+   *
+   * \note Mipmaps are not regenerated by this function.
+   *
+   * \param ctx         the associated command context.
+   * \param allocator   the allocator used to create the staging buffer.
+   * \param data        the source texel data.
+   * \param data_size   the size of the source data in bytes.
+   * \param offset      the texel offset of the region.
+   * \param extent      the size of the region in texels.
+   * \param row_pitch   the source row length in texels (0 for tightly packed rows).
+   * \param mip_level   the target mipmap level.
+   * \param array_layer the target array layer.
+   *
+   * \return `VK_SUCCESS` if the region was updated; `VK_ERROR_VALIDATION_FAILED_EXT` if
+   *         the region is outside of the image or the data doesn't cover it; or another
+   *         error otherwise.
+   */
+  auto update_region(const CommandContext& ctx,
+                     VmaAllocator allocator,
+                     const void* data,
+                     uint64 data_size,
+                     const VkOffset3D& offset,
+                     const VkExtent3D& extent,
+                     uint32 row_pitch = 0,
+                     uint32 mip_level = 0,
+                     uint32 array_layer = 0) -> VkResult;
+
+  /**
+   * Updates several regions of the image using a single staging buffer and submission.
+   *
+   * \details The data of each region is placed at an offset in the staging buffer that
+   *          is a multiple of both the texel size and 4 bytes, or of 16 bytes if the
+   *          texel size of the image format is unknown, see `get_format_texel_size`.
+   *          Each region must be within the bounds of its mipmap level and array layer,
+   *          and the size of its data is validated against its extent and row pitch,
+   *          unless the texel size is unknown.
+   *
+   * \param ctx       the associated command context.
+   * \param allocator the allocator used to create the staging buffer.
+   * \param regions   the regions that will be updated.
+   *
+   * \return `VK_SUCCESS` if the regions were updated; `VK_ERROR_VALIDATION_FAILED_EXT`
+   *         if a region is outside of the image or its data doesn't cover it; or another
+   *         error otherwise.
+   */
+  auto update_regions(const CommandContext& ctx,
+                      VmaAllocator allocator,
+                      const std::vector<ImageRegion>& regions) -> VkResult;
+
+#ifdef VK_EXT_host_image_copy
+
+  /**
+   * Writes texel data to the image directly from host memory.
+   *
+   * \details This function uses the `VK_EXT_host_image_copy` extension to copy the
+   *          data into the image and transition its layout on the host, without any
+   *          staging buffer or queue submission. The entire first mipmap level is
+   *          written, other mipmap levels are not generated.
+   *
+   * \note The image must have been created with the `VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT`
+   *       usage flag, and the target layout must be one of the layouts reported by
+   *       `VkPhysicalDeviceHostImageCopyPropertiesEXT::pCopyDstLayouts`.
+   *
+   * \param functions the host image copy extension functions.
+   * \param data      the source texel data, tightly packed.
+   * \param layout    the layout of the image after the copy.
+   *
+   * \return `VK_SUCCESS` if the data was written, or an error otherwise.
+   */
+  auto host_copy(const HostImageCopyFunctions& functions,
+                 const void* data,
+                 VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+      -> VkResult;
+
+  /**
+   * Writes several regions of texel data to the image directly from host memory.
+   *
+   * \details The image is transitioned to the target layout on the host first, which
+   *          preserves the image contents unless the current layout is undefined.
+   *
+   * \param functions the host image copy extension functions.
+   * \param regions   the regions that will be written.
+   * \param layout    the layout of the image after the copy.
+   *
+   * \return `VK_SUCCESS` if the data was written, or an error otherwise.
+   */
+  auto host_copy(const HostImageCopyFunctions& functions,
+                 const std::vector<ImageRegion>& regions,
+                 VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+      -> VkResult;
+
+#endif  // VK_EXT_host_image_copy
+
   void change_layout(const CommandContext& ctx, VkImageLayout new_layout);
 
   void copy_buffer(const CommandContext& ctx, VkBuffer buffer);
 
   void generate_mipmaps(const CommandContext& ctx);
 
+  /**
+   * Records a layout transition of all mipmap levels of the image.
+   *
+   * \param cmd_buf    the command buffer that will record the transition.
+   * \param new_layout the new image layout.
+   */
+  void cmd_change_layout(VkCommandBuffer cmd_buf, VkImageLayout new_layout);
+
+  /**
+   * Records a copy of the contents of a buffer into the first mipmap level of the image.
+   *
+   * \param cmd_buf the command buffer that will record the copy.
+   * \param buffer  the source buffer.
+   */
+  void cmd_copy_buffer(VkCommandBuffer cmd_buf, VkBuffer buffer);
+
+  /**
+   * Records the generation of all mipmap levels from the first mipmap level.
+   *
+   * \details This is useful for batching mipmap generation of several images into a
+   *          single submission. The image is left in the
+   *          `VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL` layout.
+   *
+   * \pre The image must be in the `VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL` layout.
+   *
+   * \param cmd_buf the command buffer that will record the mipmap generation.
+   */
+  void cmd_generate_mipmaps(VkCommandBuffer cmd_buf);
+
+  /**
+   * Returns a view into the image, creating it if necessary.
+   *
+   * \details Views are memoized by the image, so repeated requests for equivalent views
+   *          are cheap. This is useful for per-mip or per-layer views, e.g., when
+   *          generating mipmaps in compute shaders or rendering into array layers. The
+   *          views are destroyed along with the image.
+   *
+   * \note An undefined format in the view specification is replaced with the format of
+   *       the image.
+   *
+   * \param      key    the image view specification.
+   * \param[out] result the resulting error code.
+   *
+   * \return a potentially null image view handle, owned by the image.
+   */
+  [[nodiscard]] auto get_view(ImageViewKey key, VkResult* result = nullptr)
+      -> VkImageView;
+
   [[nodiscard]] auto get() noexcept -> VkImage { return mImage; }
 
   [[nodiscard]] auto allocator() noexcept -> VmaAllocator { return mAllocator; }
@@ -172,6 +475,10 @@ class Image final {
   VkImage mImage {VK_NULL_HANDLE};
   VmaAllocation mAllocation {VK_NULL_HANDLE};
   ImageInfo mInfo;
+  ImageViewCache mViews;
+
+  [[nodiscard]] auto _upload_staging_buffer(const CommandContext& ctx,
+                                            VkBuffer staging_buffer) -> VkResult;
 };
 
 }  // namespace grace
@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <unordered_map>  // unordered_map
+
 #include <vulkan/vulkan.h>
 
 #include "common.hpp"
@@ -55,6 +57,40 @@ namespace grace {
     VkImageAspectFlags aspects = VK_IMAGE_ASPECT_COLOR_BIT,
     uint32 mip_levels = 1) -> VkImageViewCreateInfo;
 
+/**
+ * Creates an image subresource range specification.
+ *
+ * \param aspects           the included image aspects.
+ * \param base_mip_level    the first included mipmap level.
+ * \param mip_level_count   the number of included mipmap levels.
+ * \param base_array_layer  the first included array layer.
+ * \param array_layer_count the number of included array layers.
+ *
+ * \return an image subresource range.
+ */
+[[nodiscard]] auto make_image_subresource_range(VkImageAspectFlags aspects,
+                                                uint32 base_mip_level = 0,
+                                                uint32 mip_level_count = 1,
+                                                uint32 base_array_layer = 0,
+                                                uint32 array_layer_count = 1)
+    -> VkImageSubresourceRange;
+
+/**
+ * Creates an image view creation information structure for a subresource range.
+ *
+ * \param image  the associated image.
+ * \param type   the image view type.
+ * \param format the format used when interpreting the image texel data.
+ * \param range  the subresource range accessible by the image view.
+ *
+ * \return information required to create an image view.
+ */
+[[nodiscard]] auto make_image_view_info(VkImage image,
+                                        VkImageViewType type,
+                                        VkFormat format,
+                                        const VkImageSubresourceRange& range)
+    -> VkImageViewCreateInfo;
+
 class ImageView final {
  public:
   ImageView() noexcept = default;
@@ -121,4 +157,67 @@ class ImageView final {
   VkImageView mImageView {VK_NULL_HANDLE};
 };
 
+/// Identifies an image view by its type, format, and subresource range.
+struct ImageViewKey final {
+  VkImageViewType type {VK_IMAGE_VIEW_TYPE_2D};
+  VkFormat format {VK_FORMAT_UNDEFINED};
+  VkImageAspectFlags aspects {VK_IMAGE_ASPECT_COLOR_BIT};
+  uint32 base_mip_level {0};
+  uint32 mip_level_count {1};
+  uint32 base_array_layer {0};
+  uint32 array_layer_count {1};
+
+  [[nodiscard]] auto operator==(const ImageViewKey& other) const -> bool = default;
+};
+
+struct ImageViewKeyHasher final {
+  [[nodiscard]] auto operator()(const ImageViewKey& key) const noexcept -> usize;
+};
+
+/**
+ * Lazily creates and memoizes views into a single image.
+ *
+ * \details Views are created the first time they are requested, subsequent requests
+ *          for an equivalent view only require a hash lookup. All views are owned by
+ *          the cache, and are destroyed along with it.
+ */
+class ImageViewCache final {
+ public:
+  ImageViewCache() noexcept = default;
+
+  ImageViewCache(VkDevice device, VkImage image) noexcept;
+
+  ImageViewCache(ImageViewCache&& other) noexcept = default;
+  ImageViewCache(const ImageViewCache& other) = delete;
+
+  auto operator=(ImageViewCache&& other) noexcept -> ImageViewCache& = default;
+  auto operator=(const ImageViewCache& other) -> ImageViewCache& = delete;
+
+  /// Destroys all cached image views.
+  void clear() noexcept;
+
+  /**
+   * Returns an image view that matches a view specification.
+   *
+   * \param      key    the image view specification.
+   * \param[out] result the resulting error code.
+   *
+   * \return a potentially null image view handle, owned by the cache.
+   */
+  [[nodiscard]] auto get(const ImageViewKey& key, VkResult* result = nullptr)
+      -> VkImageView;
+
+  /// Returns the number of cached image views.
+  [[nodiscard]] auto size() const noexcept -> usize { return mViews.size(); }
+
+  [[nodiscard]] auto device() noexcept -> VkDevice { return mDevice; }
+
+  [[nodiscard]] auto image() noexcept -> VkImage { return mImage; }
+
+ private:
+  VkDevice mDevice {VK_NULL_HANDLE};
+  VkImage mImage {VK_NULL_HANDLE};
+  std::unordered_map<ImageViewKey, ImageView, ImageViewKeyHasher> mViews;
+};
+
 }  // namespace grace
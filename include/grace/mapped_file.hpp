@@ -0,0 +1,110 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>     // byte
+#include <filesystem>  // path
+#include <span>        // span
+#include <vector>      // vector
+
+#include <vulkan/vulkan.h>
+
+#include "common.hpp"
+
+namespace grace {
+
+/**
+ * A read-only view of the contents of a file.
+ *
+ * \details On POSIX systems, the file is memory-mapped, so that it's paged in on demand
+ *          instead of being copied into a growing buffer. On other platforms, the file is
+ *          read with a single allocation of the right size. In both cases, the data is
+ *          aligned to at least 4 bytes, so it can be used directly as SPIR-V code.
+ */
+class MappedFile final {
+ public:
+  /**
+   * Opens a file for reading.
+   *
+   * \param      path   the file path.
+   * \param[out] result the resulting error code.
+   *
+   * \return a potentially invalid file view.
+   */
+  [[nodiscard]] static auto open(const std::filesystem::path& path,
+                                 VkResult* result = nullptr) -> MappedFile;
+
+  MappedFile() noexcept = default;
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile(const MappedFile& other) = delete;
+
+  auto operator=(MappedFile&& other) noexcept -> MappedFile&;
+  auto operator=(const MappedFile& other) -> MappedFile& = delete;
+
+  ~MappedFile() noexcept;
+
+  /// Releases the file contents, invalidating any pointers to the data.
+  void close() noexcept;
+
+  [[nodiscard]] auto data() const noexcept -> const void* { return mData; }
+
+  [[nodiscard]] auto size() const noexcept -> usize { return mSize; }
+
+  [[nodiscard]] auto empty() const noexcept -> bool { return mSize == 0; }
+
+  [[nodiscard]] auto bytes() const noexcept -> std::span<const std::byte>
+  {
+    return {static_cast<const std::byte*>(mData), mSize};
+  }
+
+  /// Indicates whether the file was opened successfully (even if it's empty).
+  [[nodiscard]] explicit operator bool() const noexcept { return mIsOpen; }
+
+ private:
+  const void* mData {nullptr};
+  usize mSize {0};
+  std::vector<uint32> mBuffer;  // Only used when the file isn't memory-mapped
+  bool mIsMapped {false};
+  bool mIsOpen {false};
+};
+
+/**
+ * Writes a file atomically, so that readers never see partially written contents.
+ *
+ * \details The data is written to a uniquely named temporary file next to the target
+ *          file, which is then renamed to the target path. On POSIX systems, the
+ *          temporary file is synchronized to disk before the rename, and the directory
+ *          afterwards, so the file also survives crashes and power loss.
+ *
+ * \param path  the file path.
+ * \param bytes the file contents.
+ *
+ * \return `VK_SUCCESS` if the file was written; `VK_ERROR_UNKNOWN` otherwise.
+ */
+[[nodiscard]] auto write_file_atomically(const std::filesystem::path& path,
+                                         std::span<const std::byte> bytes) -> VkResult;
+
+}  // namespace grace
@@ -45,10 +45,28 @@ struct SwapchainSupport final {
   std::vector<VkPresentModeKHR> present_modes;      ///< Supported present modes.
 };
 
+/// A snapshot of the features and properties of a physical device.
+struct PhysicalDeviceInfo final {
+  VkPhysicalDeviceFeatures features {};
+  VkPhysicalDeviceProperties properties {};
+};
+
 /// Returns all available GPUs, regardless of their suitability.
 [[nodiscard]] auto get_physical_devices(VkInstance instance)
     -> std::vector<VkPhysicalDevice>;
 
+/**
+ * Queries the features and properties of a physical device.
+ *
+ * \details The returned snapshot is intended to be obtained once and reused, instead
+ *          of repeatedly querying the same information from the driver.
+ *
+ * \param gpu the physical device to query.
+ *
+ * \return the physical device information.
+ */
+[[nodiscard]] auto get_physical_device_info(VkPhysicalDevice gpu) -> PhysicalDeviceInfo;
+
 [[nodiscard]] auto get_extensions(VkPhysicalDevice gpu)
     -> std::vector<VkExtensionProperties>;
 
@@ -24,14 +24,22 @@
 
 #pragma once
 
-#include <array>     // array
-#include <optional>  // optional
-#include <string>    // string
-#include <vector>    // vector
+#include <array>       // array
+#include <cstddef>     // byte
+#include <functional>  // function
+#include <future>      // future
+#include <optional>    // optional
+#include <span>        // span
+#include <string>      // string
+#include <vector>      // vector
 
 #include <vulkan/vulkan.h>
 
 #include "common.hpp"
+#include "pipeline_feedback.hpp"
+#include "shader_library.hpp"
+#include "specialization_constants.hpp"
+#include "thread_pool.hpp"
 
 namespace grace {
 
@@ -117,6 +125,23 @@ class GraphicsPipeline final : public Pipeline {
                                  VkResult* result = nullptr) -> GraphicsPipeline;
 };
 
+/// Hashes pipeline state keys, e.g. for use in unordered containers.
+struct PipelineStateKeyHasher final {
+  [[nodiscard]] auto operator()(const std::vector<std::byte>& key) const noexcept -> usize
+  {
+    return static_cast<usize>(fnv1a_hash(key.data(), key.size()));
+  }
+};
+
+/// Returns the SPIR-V code with a given hash, or an empty span if the code is unknown.
+using ShaderCodeResolver = std::function<std::span<const uint32>(uint64 code_hash)>;
+
+/// The outcome of an asynchronous graphics pipeline compilation.
+struct GraphicsPipelineResult final {
+  GraphicsPipeline pipeline;
+  VkResult result {VK_SUCCESS};
+};
+
 class GraphicsPipelineBuilder final {
  public:
   using Self = GraphicsPipelineBuilder;
@@ -163,7 +188,8 @@ class GraphicsPipelineBuilder final {
   /**
    * Specifies the associated render pass.
    *
-   * \note This function must be called in order to be able to build the pipeline.
+   * \note This function, or `with_rendering_formats`, must be called in order to be able
+   *       to build the pipeline.
    *
    * \param render_pass the associated render pass handle.
    * \param subpass     the index of the subpass in which the pipeline will be used.
@@ -172,6 +198,61 @@ class GraphicsPipelineBuilder final {
    */
   auto with_render_pass(VkRenderPass render_pass, uint32 subpass) -> Self&;
 
+#ifdef VK_KHR_dynamic_rendering
+
+  /**
+   * Specifies the attachment formats used with dynamic rendering.
+   *
+   * \details The resulting pipeline is not tied to a render pass, and may be used in any
+   *          dynamic render pass instance with matching attachment formats.
+   *
+   * \note The render pass must be null for the rendering formats to take effect.
+   *
+   * \param color_formats  the formats of the color attachments.
+   * \param depth_format   the format of the depth attachment, if any.
+   * \param stencil_format the format of the stencil attachment, if any.
+   *
+   * \return the pipeline builder itself.
+   */
+  auto with_rendering_formats(std::vector<VkFormat> color_formats,
+                              VkFormat depth_format = VK_FORMAT_UNDEFINED,
+                              VkFormat stencil_format = VK_FORMAT_UNDEFINED) -> Self&;
+
+#endif  // VK_KHR_dynamic_rendering
+
+  /**
+   * Specifies a shader library used to load shaders specified by file paths.
+   *
+   * \details Without a shader library, shader files are read and turned into shader
+   *          modules every time a pipeline is built.
+   *
+   * \param library a shader library that outlives the builder, or null.
+   *
+   * \return the pipeline builder itself.
+   */
+  auto with_shader_library(ShaderLibrary* library) -> Self&;
+
+  /**
+   * Specifies a callback that receives the creation statistics of built pipelines.
+   *
+   * \details The statistics include the creation time of the pipeline and its shader
+   *          stages, and whether they were found in the pipeline cache. The callback is
+   *          invoked on the thread that builds the pipeline, so it must be thread-safe
+   *          when used together with `build_many`.
+   *
+   * \note If feedback is not enabled, or the Vulkan headers lack the extension, the
+   *       callback still receives each built pipeline, but with no statistics and with
+   *       `valid` set to false.
+   *
+   * \param callback         the feedback callback, or null.
+   * \param feedback_enabled whether the device enables VK_EXT_pipeline_creation_feedback
+   *                         (or Vulkan 1.3).
+   *
+   * \return the pipeline builder itself.
+   */
+  auto with_feedback_callback(PipelineFeedbackCallback callback,
+                              bool feedback_enabled) -> Self&;
+
   /**
    * Specifies the vertex shader that will be used.
    *
@@ -184,6 +265,34 @@ class GraphicsPipelineBuilder final {
    */
   auto vertex_shader(const char* shader_path, const char* entry_name = "main") -> Self&;
 
+  /**
+   * Specifies the vertex shader that will be used, as an existing shader module.
+   *
+   * \details This is useful for sharing shader modules between pipelines, e.g., when
+   *          combined with a shader library.
+   *
+   * \param shader_module a shader module that outlives any pipeline builds.
+   * \param entry_name    the name of the entry point function.
+   *
+   * \return the pipeline builder itself.
+   */
+  auto vertex_shader(VkShaderModule shader_module, const char* entry_name = "main")
+      -> Self&;
+
+  /**
+   * Specifies the vertex shader that will be used, as in-memory SPIR-V code.
+   *
+   * \details This is useful for shaders embedded with `grace_embed_shaders`, which
+   *          avoids reading any files when pipelines are built.
+   *
+   * \param code       the compiled shader code, which outlives any pipeline builds.
+   * \param entry_name the name of the entry point function.
+   *
+   * \return the pipeline builder itself.
+   */
+  auto vertex_shader(std::span<const uint32> code, const char* entry_name = "main")
+      -> Self&;
+
   /**
    * Specifies the fragment shader that will be used.
    *
@@ -196,6 +305,49 @@ class GraphicsPipelineBuilder final {
    */
   auto fragment_shader(const char* shader_path, const char* entry_name = "main") -> Self&;
 
+  /**
+   * Specifies the fragment shader that will be used, as an existing shader module.
+   *
+   * \param shader_module a shader module that outlives any pipeline builds.
+   * \param entry_name    the name of the entry point function.
+   *
+   * \return the pipeline builder itself.
+   */
+  auto fragment_shader(VkShaderModule shader_module, const char* entry_name = "main")
+      -> Self&;
+
+  /**
+   * Specifies the fragment shader that will be used, as in-memory SPIR-V code.
+   *
+   * \param code       the compiled shader code, which outlives any pipeline builds.
+   * \param entry_name the name of the entry point function.
+   *
+   * \return the pipeline builder itself.
+   */
+  auto fragment_shader(std::span<const uint32> code, const char* entry_name = "main")
+      -> Self&;
+
+  /**
+   * Specifies the specialization constant values used by the vertex shader.
+   *
+   * \details Specialization constants are part of the pipeline state key, so pipeline
+   *          registries also act as caches of shader variants.
+   *
+   * \param constants the specialization constant values, which are copied.
+   *
+   * \return the pipeline builder itself.
+   */
+  auto vertex_specialization(const SpecializationConstants& constants) -> Self&;
+
+  /**
+   * Specifies the specialization constant values used by the fragment shader.
+   *
+   * \param constants the specialization constant values, which are copied.
+   *
+   * \return the pipeline builder itself.
+   */
+  auto fragment_specialization(const SpecializationConstants& constants) -> Self&;
+
   auto vertex_input_binding(uint32 binding,
                             uint32 stride,
                             VkVertexInputRate rate = VK_VERTEX_INPUT_RATE_VERTEX)
@@ -394,6 +546,7 @@ class GraphicsPipelineBuilder final {
    * Specifies that a particular piece of pipeline state should be fetched dynamically.
    *
    * \note You can call this function several times to specify multiple dynamic states.
+   *       Duplicate dynamic states are ignored.
    *
    * \param state the pipeline state to mark as dynamic.
    *
@@ -401,6 +554,19 @@ class GraphicsPipelineBuilder final {
    */
   auto dynamic_state(VkDynamicState state) -> Self&;
 
+  /**
+   * Specifies that several pieces of pipeline state should be fetched dynamically.
+   *
+   * \details This is useful together with the extended dynamic state extensions, e.g.
+   *          `dynamic_states(kExtendedDynamicStates)`, which lets a single pipeline
+   *          replace many pipelines that only differ in e.g. cull mode or depth state.
+   *
+   * \param states the pipeline states to mark as dynamic.
+   *
+   * \return the pipeline builder itself.
+   */
+  auto dynamic_states(std::span<const VkDynamicState> states) -> Self&;
+
   /**
    * Attempts to create the specified pipeline.
    *
@@ -410,6 +576,144 @@ class GraphicsPipelineBuilder final {
    */
   [[nodiscard]] auto build(VkResult* result = nullptr) const -> GraphicsPipeline;
 
+  /**
+   * Compiles several pipelines concurrently using a thread pool.
+   *
+   * \details Each builder is copied into its compilation task, so the builders may be
+   *          modified or destroyed once this function returns. Pipeline caches are
+   *          internally synchronized, so all pipelines can share a single cache, which is
+   *          recommended since it lets the driver reuse work between similar pipelines.
+   *
+   * \param builders the builders that describe the pipelines.
+   * \param pool     the thread pool used to compile the pipelines.
+   * \param cache    a shared pipeline cache that overrides the builder caches, or null to
+   *                 use the caches specified by the builders.
+   *
+   * \return the pending pipelines, in the same order as the builders.
+   */
+  [[nodiscard]] static auto build_many(std::span<const GraphicsPipelineBuilder> builders,
+                                       ThreadPool& pool,
+                                       VkPipelineCache cache = VK_NULL_HANDLE)
+      -> std::vector<std::future<GraphicsPipelineResult>>;
+
+#ifdef VK_EXT_graphics_pipeline_library
+
+  /**
+   * Attempts to create a graphics pipeline library that covers parts of the pipeline.
+   *
+   * \details Only the state relevant to the specified parts is used. Libraries retain
+   *          link-time optimization information, so that they can be linked with
+   *          `link_libraries` both quickly and with link-time optimizations.
+   *
+   * \param      parts  the parts of the pipeline that the library provides.
+   * \param[out] result the resulting error code.
+   *
+   * \return a potentially null pipeline library.
+   */
+  [[nodiscard]] auto build_library(VkGraphicsPipelineLibraryFlagsEXT parts,
+                                   VkResult* result = nullptr) const -> GraphicsPipeline;
+
+  /**
+   * Attempts to link pipeline libraries into a complete graphics pipeline.
+   *
+   * \details Linking without optimizations is fast enough to be done while recording
+   *          frames, whereas optimized linking is best done in the background.
+   *
+   * \param      libraries the pipeline libraries that together cover all parts.
+   * \param      optimize  whether link-time optimizations are performed.
+   * \param[out] result    the resulting error code.
+   *
+   * \return a potentially null graphics pipeline.
+   */
+  [[nodiscard]] auto link_libraries(std::span<const VkPipeline> libraries,
+                                    bool optimize,
+                                    VkResult* result = nullptr) const -> GraphicsPipeline;
+
+  /**
+   * Returns a key that identifies the state of parts of the pipeline.
+   *
+   * \details Builders with equal library keys produce interchangeable pipeline libraries
+   *          for the specified parts, even if they differ in other parts.
+   *
+   * \param parts the parts of the pipeline to cover.
+   *
+   * \return the pipeline library state key.
+   */
+  [[nodiscard]] auto get_library_state_key(VkGraphicsPipelineLibraryFlagsEXT parts) const
+      -> std::vector<std::byte>;
+
+#endif  // VK_EXT_graphics_pipeline_library
+
+  /**
+   * Returns a serialized representation of the pipeline state.
+   *
+   * \details The key covers all state that affects the resulting pipeline, i.e., the
+   *          shaders and their specialization constants, vertex input, rasterization,
+   *          blending, depth and stencil state, dynamic states, pipeline layout,
+   *          render pass and rendering formats. Builders with equal keys produce
+   *          equivalent pipelines. The associated pipeline cache and shader library are
+   *          not part of the key. Neither are the baked values of dynamic states, so
+   *          builders that only differ in such values share the same key.
+   *
+   * \note Keys of builders that specify shaders by shader module handles are only
+   *       meaningful during the lifetime of the shader modules.
+   *
+   * \return the pipeline state key.
+   */
+  [[nodiscard]] auto get_state_key() const -> std::vector<std::byte>;
+
+  /**
+   * Returns a stable hash of the pipeline state.
+   *
+   * \return the hash of the pipeline state key.
+   */
+  [[nodiscard]] auto get_state_hash() const -> uint64;
+
+  /// Returns the file paths of the shaders that are loaded from files.
+  [[nodiscard]] auto get_shader_paths() const -> std::vector<std::string>;
+
+  /**
+   * Serializes the portable pipeline state, e.g., to record it in a pipeline manifest.
+   *
+   * \details Unlike state keys, the serialized state doesn't contain any handles, i.e.,
+   *          the pipeline layout, render pass, pipeline cache and shader library must
+   *          be specified again after deserializing the state. Shaders given as SPIR-V
+   *          code are identified by hashes of their code.
+   *
+   * \return the serialized state, or an empty vector if the builder specifies shaders
+   *         by shader module handles, which can't be serialized.
+   */
+  [[nodiscard]] auto serialize() const -> std::vector<std::byte>;
+
+  /**
+   * Restores a pipeline builder from serialized pipeline state.
+   *
+   * \param device   the associated logical device.
+   * \param bytes    the serialized state, see `serialize`.
+   * \param resolver provides the code of shaders that were given as SPIR-V code.
+   *
+   * \return a builder without pipeline layout, render pass, pipeline cache and shader
+   *         library; or nothing if the state is invalid or refers to unknown code.
+   */
+  [[nodiscard]] static auto deserialize(VkDevice device,
+                                        std::span<const std::byte> bytes,
+                                        const ShaderCodeResolver& resolver = {})
+      -> std::optional<GraphicsPipelineBuilder>;
+
+  [[nodiscard]] auto get_layout() const noexcept -> VkPipelineLayout { return mLayout; }
+
+  [[nodiscard]] auto get_render_pass() const noexcept -> VkRenderPass
+  {
+    return mRenderPass;
+  }
+
+  [[nodiscard]] auto get_subpass() const noexcept -> uint32 { return mSubpass; }
+
+  [[nodiscard]] auto get_shader_library() const noexcept -> ShaderLibrary*
+  {
+    return mShaderLibrary;
+  }
+
   [[nodiscard]] auto get_vertex_input_state_info() const
       -> VkPipelineVertexInputStateCreateInfo;
 
@@ -435,16 +739,28 @@ class GraphicsPipelineBuilder final {
 
   [[nodiscard]] auto get_dynamic_state_info() const -> VkPipelineDynamicStateCreateInfo;
 
+#ifdef VK_KHR_dynamic_rendering
+
+  [[nodiscard]] auto get_rendering_info() const -> VkPipelineRenderingCreateInfoKHR;
+
+#endif  // VK_KHR_dynamic_rendering
+
  private:
   struct ShaderInfo final {
     std::string path;
     std::string entry_name;
+    VkShaderModule module {VK_NULL_HANDLE};
+    std::span<const uint32> code;
+    SpecializationConstants constants;
   };
 
   VkDevice mDevice {VK_NULL_HANDLE};
   VkPipelineLayout mLayout {VK_NULL_HANDLE};
   VkPipelineCache mCache {VK_NULL_HANDLE};
   VkRenderPass mRenderPass {VK_NULL_HANDLE};
+  ShaderLibrary* mShaderLibrary {nullptr};
+  PipelineFeedbackCallback mFeedbackCallback;
+  bool mFeedbackEnabled {false};
 
   ShaderInfo mVertexShader;
   ShaderInfo mFragmentShader;
@@ -455,6 +771,7 @@ class GraphicsPipelineBuilder final {
   std::vector<VkRect2D> mScissors;
   std::vector<VkDynamicState> mDynamicStates;
   std::vector<VkPipelineColorBlendAttachmentState> mColorBlendAttachments;
+  std::vector<VkFormat> mColorAttachmentFormats;
 
   std::optional<uint32> mTessellationPatchControlPoints;
 
@@ -467,6 +784,8 @@ class GraphicsPipelineBuilder final {
   VkLogicOp mColorLogicOp {kDefaultColorLogicOp};
   VkStencilOpState mFrontStencilOpState {};
   VkStencilOpState mBackStencilOpState {};
+  VkFormat mDepthAttachmentFormat {VK_FORMAT_UNDEFINED};
+  VkFormat mStencilAttachmentFormat {VK_FORMAT_UNDEFINED};
 
   float mLineWidth {kDefaultLineWidth};
   float mDepthBiasConstantFactor {};
@@ -483,8 +802,24 @@ class GraphicsPipelineBuilder final {
   bool mDepthClampEnabled      : 1 {false};
   bool mStencilTestEnabled     : 1 {false};
   bool mColorLogicOpEnabled    : 1 {false};
+  bool mUsesDynamicRendering   : 1 {false};
+
+  [[nodiscard]] auto _is_complete(uint32 parts) const -> bool;
+
+  [[nodiscard]] auto _is_dynamic(VkDynamicState state) const -> bool;
+
+  template <typename Writer>
+  void _write_state(Writer& writer, uint32 parts) const;
+
+  [[nodiscard]] auto _create_pipeline(uint32 parts, VkResult* result) const
+      -> GraphicsPipeline;
+
+  [[nodiscard]] auto _make_pipeline(VkGraphicsPipelineCreateInfo& pipeline_info,
+                                    VkResult* result) const -> GraphicsPipeline;
 
-  [[nodiscard]] auto _is_complete() const -> bool;
+  [[nodiscard]] auto _get_shader_module(const ShaderInfo& shader,
+                                        ShaderModule& owned_module,
+                                        VkResult* result) const -> VkShaderModule;
 };
 
 }  // namespace grace
@@ -24,8 +24,9 @@
 
 #pragma once
 
-#include <cstddef>  // byte
-#include <vector>   // vector
+#include <cstddef>     // byte
+#include <filesystem>  // path
+#include <vector>      // vector
 
 #include <vulkan/vulkan.h>
 
@@ -38,6 +39,24 @@ namespace grace {
                                             VkPipelineCacheCreateFlags flags = 0)
     -> VkPipelineCacheCreateInfo;
 
+/**
+ * Indicates whether serialized pipeline cache data was created by a specific device.
+ *
+ * \details The `VkPipelineCacheHeaderVersionOne` header of the data is validated against
+ *          the vendor ID, device ID and pipeline cache UUID of the device. Cache data from
+ *          other devices or driver versions is useless, and is best discarded.
+ *
+ * \param data           the serialized pipeline cache data.
+ * \param data_size      the size of the data in bytes.
+ * \param gpu_properties the properties of the physical device.
+ *
+ * \return true if the data is compatible with the device; false otherwise.
+ */
+[[nodiscard]] auto is_pipeline_cache_compatible(
+    const void* data,
+    usize data_size,
+    const VkPhysicalDeviceProperties& gpu_properties) -> bool;
+
 class PipelineCache final {
  public:
   [[nodiscard]] static auto make(VkDevice device,
@@ -50,6 +69,24 @@ class PipelineCache final {
                                  VkPipelineCacheCreateFlags flags = 0,
                                  VkResult* result = nullptr) -> PipelineCache;
 
+  /**
+   * Creates a pipeline cache from a file, or an empty cache if that isn't possible.
+   *
+   * \details The file contents are only used if they are compatible with the physical
+   *          device, stale or corrupt cache files are ignored.
+   *
+   * \param      device the associated logical device.
+   * \param      gpu    the associated physical device.
+   * \param      path   the path to the pipeline cache file, which doesn't need to exist.
+   * \param[out] result the resulting error code.
+   *
+   * \return a potentially null pipeline cache.
+   */
+  [[nodiscard]] static auto load_or_create(VkDevice device,
+                                           VkPhysicalDevice gpu,
+                                           const std::filesystem::path& path,
+                                           VkResult* result = nullptr) -> PipelineCache;
+
   PipelineCache() noexcept = default;
 
   PipelineCache(VkDevice device, VkPipelineCache cache) noexcept;
@@ -68,6 +105,18 @@ class PipelineCache final {
 
   [[nodiscard]] auto get_data(VkResult* result = nullptr) const -> std::vector<std::byte>;
 
+  /**
+   * Writes the pipeline cache data to a file.
+   *
+   * \details The data is first written to a temporary file, which then replaces the
+   *          target file, so an interrupted write never leaves a truncated cache file.
+   *
+   * \param path the path to the pipeline cache file.
+   *
+   * \return `VK_SUCCESS` if the file was written, or an error otherwise.
+   */
+  auto save(const std::filesystem::path& path) const -> VkResult;
+
   [[nodiscard]] auto get() noexcept -> VkPipelineCache { return mCache; }
 
   [[nodiscard]] auto device() noexcept -> VkDevice { return mDevice; }
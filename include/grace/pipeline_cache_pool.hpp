@@ -0,0 +1,127 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>        // byte
+#include <filesystem>     // path
+#include <mutex>          // mutex
+#include <thread>         // thread
+#include <unordered_map>  // unordered_map
+#include <vector>         // vector
+
+#include <vulkan/vulkan.h>
+
+#include "common.hpp"
+#include "pipeline_cache.hpp"
+
+namespace grace {
+
+/**
+ * Hands out a pipeline cache per thread, and merges them into a primary cache.
+ *
+ * \details Pipeline caches are internally synchronized, so threads that compile
+ *          pipelines with a shared cache contend on its lock. With a pool, each thread
+ *          uses its own cache, which is seeded with the contents of the primary cache.
+ *          The thread caches are merged into the primary cache with
+ *          `vkMergePipelineCaches` at sync points, e.g., after a loading screen or before
+ *          saving the primary cache.
+ *
+ * \note If the device supports `pipelineCreationCacheControl`, the thread caches can be
+ *       created with `VK_PIPELINE_CACHE_CREATE_EXTERNALLY_SYNCHRONIZED_BIT`, which lets
+ *       the driver skip locking altogether.
+ */
+class PipelineCachePool final {
+ public:
+  /**
+   * Creates a pipeline cache pool.
+   *
+   * \param primary      the primary pipeline cache, which receives the merged caches. If
+   *                     it's null, no thread caches are handed out.
+   * \param thread_flags the creation flags of the thread caches.
+   */
+  explicit PipelineCachePool(PipelineCache primary,
+                             VkPipelineCacheCreateFlags thread_flags = 0);
+
+  PipelineCachePool(const PipelineCachePool& other) = delete;
+  PipelineCachePool(PipelineCachePool&& other) = delete;
+
+  auto operator=(const PipelineCachePool& other) -> PipelineCachePool& = delete;
+  auto operator=(PipelineCachePool&& other) -> PipelineCachePool& = delete;
+
+  /**
+   * Returns the pipeline cache of the calling thread, which is created on first use.
+   *
+   * \note The cache must only be used by the calling thread, and remains valid for the
+   *       lifetime of the pool.
+   *
+   * \param[out] result the resulting error code, which is
+   *                    `VK_ERROR_INITIALIZATION_FAILED` if the primary cache is null.
+   *
+   * \return a potentially null pipeline cache handle, owned by the pool.
+   */
+  [[nodiscard]] auto get(VkResult* result = nullptr) -> VkPipelineCache;
+
+  /**
+   * Merges all thread caches into the primary cache.
+   *
+   * \details The thread caches keep their contents, since threads may still refer to
+   *          them, so each merge processes the full contents of every thread cache
+   *          again. Merging is thus relatively expensive, and should only be done at
+   *          sync points rather than, e.g., every frame.
+   *
+   * \note This function must not be called while pipelines are being created with any of
+   *       the thread caches.
+   *
+   * \return `VK_SUCCESS` if the caches were merged; `VK_ERROR_INITIALIZATION_FAILED` if
+   *         the primary cache is null; or another error otherwise.
+   */
+  auto merge() -> VkResult;
+
+  /**
+   * Merges all thread caches into the primary cache, and writes it to a file.
+   *
+   * \note This function must not be called while pipelines are being created with any of
+   *       the thread caches.
+   *
+   * \param path the path to the pipeline cache file.
+   *
+   * \return `VK_SUCCESS` if the file was written, or an error otherwise.
+   */
+  auto save(const std::filesystem::path& path) -> VkResult;
+
+  [[nodiscard]] auto get_primary() noexcept -> VkPipelineCache { return mPrimary.get(); }
+
+  /// Returns the number of thread caches.
+  [[nodiscard]] auto thread_count() const -> usize;
+
+ private:
+  mutable std::mutex mMutex;
+  PipelineCache mPrimary;
+  VkPipelineCacheCreateFlags mThreadFlags {0};
+  std::vector<std::byte> mInitialData;
+  std::unordered_map<std::thread::id, PipelineCache> mThreadCaches;
+};
+
+}  // namespace grace
@@ -0,0 +1,111 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <functional>  // function
+#include <span>        // span
+#include <vector>      // vector
+
+#include <vulkan/vulkan.h>
+
+#include "common.hpp"
+
+namespace grace {
+
+/// Creation statistics of a single shader stage of a pipeline.
+struct PipelineStageFeedback final {
+  VkShaderStageFlagBits stage {VK_SHADER_STAGE_ALL};
+  uint64 duration_ns {0};                       ///< The time spent creating the stage.
+  bool valid                      : 1 {false};  ///< Whether the statistics are available.
+  bool cache_hit                  : 1 {false};  ///< Whether the stage hit the cache.
+  bool base_pipeline_acceleration : 1 {false};
+};
+
+/// Creation statistics of a pipeline, and each of its shader stages.
+struct PipelineFeedback final {
+  VkPipeline pipeline {VK_NULL_HANDLE};
+  uint64 duration_ns {0};                       ///< The total creation time.
+  std::vector<PipelineStageFeedback> stages;
+  bool valid                      : 1 {false};  ///< Whether the statistics are available.
+  bool cache_hit                  : 1 {false};  ///< Whether the pipeline hit the cache.
+  bool base_pipeline_acceleration : 1 {false};
+};
+
+/// Receives creation statistics, possibly from several threads at once.
+using PipelineFeedbackCallback = std::function<void(const PipelineFeedback&)>;
+
+#ifdef VK_EXT_pipeline_creation_feedback
+
+/**
+ * Collects pipeline creation feedback for a single pipeline creation call.
+ *
+ * \details Chain the structure returned by `get_info` into the pNext chain of the
+ *          pipeline create info, and then call `get_feedback` once the pipeline has been
+ *          created. The statistics are only written by the driver if the
+ *          VK_EXT_pipeline_creation_feedback extension (or Vulkan 1.3) is enabled.
+ */
+class PipelineFeedbackQuery final {
+ public:
+  /**
+   * Creates a feedback query.
+   *
+   * \param stage_count the number of shader stages in the pipeline create info.
+   * \param next        the next structure in the pNext chain, may be null.
+   */
+  explicit PipelineFeedbackQuery(uint32 stage_count, const void* next = nullptr);
+
+  // The create info refers to the internal storage, so the query can't be relocated
+  PipelineFeedbackQuery(const PipelineFeedbackQuery& other) = delete;
+  PipelineFeedbackQuery(PipelineFeedbackQuery&& other) = delete;
+
+  auto operator=(const PipelineFeedbackQuery& other) -> PipelineFeedbackQuery& = delete;
+  auto operator=(PipelineFeedbackQuery&& other) -> PipelineFeedbackQuery& = delete;
+
+  /**
+   * Returns the statistics written by the driver.
+   *
+   * \param pipeline the created pipeline.
+   * \param stages   the shader stages used to create the pipeline, in the same order.
+   *
+   * \return the pipeline creation feedback.
+   */
+  [[nodiscard]] auto get_feedback(VkPipeline pipeline,
+                                  std::span<const VkPipelineShaderStageCreateInfo> stages)
+      const -> PipelineFeedback;
+
+  [[nodiscard]] auto get_info() noexcept -> const VkPipelineCreationFeedbackCreateInfoEXT*
+  {
+    return &mInfo;
+  }
+
+ private:
+  VkPipelineCreationFeedbackEXT mPipelineFeedback {};
+  std::vector<VkPipelineCreationFeedbackEXT> mStageFeedback;
+  VkPipelineCreationFeedbackCreateInfoEXT mInfo {};
+};
+
+#endif  // VK_EXT_pipeline_creation_feedback
+
+}  // namespace grace
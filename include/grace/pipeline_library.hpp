@@ -0,0 +1,147 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>        // byte
+#include <future>         // future
+#include <mutex>          // mutex
+#include <shared_mutex>   // shared_mutex
+#include <unordered_map>  // unordered_map
+#include <vector>         // vector
+
+#include <vulkan/vulkan.h>
+
+#include "common.hpp"
+#include "pipeline.hpp"
+#include "thread_pool.hpp"
+
+namespace grace {
+
+#ifdef VK_EXT_graphics_pipeline_library
+
+/**
+ * Indicates whether a physical device supports graphics pipeline libraries.
+ *
+ * \param gpu the physical device to query.
+ *
+ * \return true if the `graphicsPipelineLibrary` feature is supported; false otherwise.
+ */
+[[nodiscard]] auto is_graphics_pipeline_library_supported(VkPhysicalDevice gpu) -> bool;
+
+/**
+ * A thread-safe cache of graphics pipeline libraries, used to link pipelines quickly.
+ *
+ * \details Graphics pipelines are split into four parts: vertex input, pre-rasterization
+ *          shaders, fragment shader and fragment output. Each part is compiled into a
+ *          separate pipeline library that is shared by all pipelines with the same state
+ *          for that part. New pipelines are then created by linking libraries, which is
+ *          much cheaper than compiling complete pipelines, so it's feasible to do so
+ *          when a new pipeline is first needed during a frame. The linked pipelines can
+ *          later be replaced with optimized pipelines, linked in the background.
+ *
+ * \note The `VK_EXT_graphics_pipeline_library` extension must be enabled.
+ */
+class PipelineLibraryCache final {
+ public:
+  PipelineLibraryCache() = default;
+
+  PipelineLibraryCache(const PipelineLibraryCache& other) = delete;
+  PipelineLibraryCache(PipelineLibraryCache&& other) = delete;
+
+  auto operator=(const PipelineLibraryCache& other) -> PipelineLibraryCache& = delete;
+  auto operator=(PipelineLibraryCache&& other) -> PipelineLibraryCache& = delete;
+
+  /**
+   * Destroys all pipeline libraries in the cache.
+   *
+   * \details This function waits for ongoing calls to `link` to finish, so that no
+   *          libraries are destroyed while they are being linked.
+   *
+   * \note Pipelines linked from the libraries remain valid, but library handles
+   *       previously returned by `get_library` do not.
+   */
+  void clear() noexcept;
+
+  /**
+   * Returns a pipeline library for a single part of a pipeline.
+   *
+   * \details The library is only built if there is no matching library in the cache.
+   *
+   * \param      builder the pipeline builder that describes the pipeline.
+   * \param      part    the part of the pipeline that the library provides.
+   * \param[out] result  the resulting error code.
+   *
+   * \return a potentially null pipeline library, owned by the cache.
+   */
+  [[nodiscard]] auto get_library(const GraphicsPipelineBuilder& builder,
+                                 VkGraphicsPipelineLibraryFlagBitsEXT part,
+                                 VkResult* result = nullptr) -> VkPipeline;
+
+  /**
+   * Creates a complete pipeline by linking cached pipeline libraries.
+   *
+   * \details Missing libraries are built and added to the cache.
+   *
+   * \param      builder  the pipeline builder that describes the pipeline.
+   * \param      optimize whether link-time optimizations are performed.
+   * \param[out] result   the resulting error code.
+   *
+   * \return a potentially null graphics pipeline, owned by the caller.
+   */
+  [[nodiscard]] auto link(const GraphicsPipelineBuilder& builder,
+                          bool optimize = false,
+                          VkResult* result = nullptr) -> GraphicsPipeline;
+
+  /**
+   * Links an optimized pipeline on a thread pool.
+   *
+   * \details This is intended to be used to replace a pipeline obtained with a fast
+   *          link once the optimized pipeline is available.
+   *
+   * \note The cache must outlive the pending pipeline.
+   *
+   * \param builder the pipeline builder that describes the pipeline, which is copied.
+   * \param pool    the thread pool that performs the linking.
+   *
+   * \return the pending optimized pipeline.
+   */
+  [[nodiscard]] auto link_optimized_async(const GraphicsPipelineBuilder& builder,
+                                          ThreadPool& pool)
+      -> std::future<GraphicsPipelineResult>;
+
+  /// Returns the number of pipeline libraries in the cache.
+  [[nodiscard]] auto size() const -> usize;
+
+ private:
+  using StateKey = std::vector<std::byte>;
+
+  mutable std::mutex mMutex;
+  std::shared_mutex mClearMutex;  // Held exclusively by clear, and shared by link
+  std::unordered_map<StateKey, GraphicsPipeline, PipelineStateKeyHasher> mLibraries;
+};
+
+#endif  // VK_EXT_graphics_pipeline_library
+
+}  // namespace grace
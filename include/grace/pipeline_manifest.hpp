@@ -0,0 +1,221 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>        // byte
+#include <filesystem>     // path
+#include <future>         // future
+#include <mutex>          // mutex
+#include <span>           // span
+#include <string>         // string
+#include <unordered_map>  // unordered_map
+#include <unordered_set>  // unordered_set
+#include <vector>         // vector
+
+#include <vulkan/vulkan.h>
+
+#include "common.hpp"
+#include "pipeline.hpp"
+#include "pipeline_cache_pool.hpp"
+#include "pipeline_registry.hpp"
+#include "shader_library.hpp"
+#include "thread_pool.hpp"
+
+namespace grace {
+
+/**
+ * Records the graphics pipeline states used during a session, so that the pipelines can
+ * be built ahead of time in later sessions.
+ *
+ * \details A manifest stores the serialized state of every recorded pipeline builder,
+ *          see `GraphicsPipelineBuilder::serialize`. Since handles can't be stored,
+ *          pipeline layouts and render passes are recorded by names that the application
+ *          registers, and shaders given as SPIR-V code are recorded by code hashes. The
+ *          manifest is typically recorded by a pipeline registry during a play session
+ *          and saved on exit. At startup or during loading screens, the saved manifest is
+ *          loaded and replayed with `warm_up`, which builds all pipelines in parallel, so
+ *          they're resident in the registry before they're first needed.
+ *
+ * \note Manifests are thread-safe.
+ */
+class PipelineManifest final {
+ public:
+  PipelineManifest() = default;
+
+  PipelineManifest(const PipelineManifest& other) = delete;
+  PipelineManifest(PipelineManifest&& other) = delete;
+
+  auto operator=(const PipelineManifest& other) -> PipelineManifest& = delete;
+  auto operator=(PipelineManifest&& other) -> PipelineManifest& = delete;
+
+  /**
+   * Associates a name with a pipeline layout.
+   *
+   * \details Only pipelines with registered layouts are recorded and replayed. The names
+   *          must be stable across sessions, whereas the layouts may change.
+   *
+   * \param name   the stable name of the layout.
+   * \param layout the pipeline layout in the current session.
+   */
+  void register_layout(const std::string& name, VkPipelineLayout layout);
+
+  /**
+   * Associates a name with a render pass.
+   *
+   * \details Only pipelines that use dynamic rendering or registered render passes are
+   *          recorded and replayed.
+   *
+   * \param name        the stable name of the render pass.
+   * \param render_pass the render pass in the current session.
+   */
+  void register_render_pass(const std::string& name, VkRenderPass render_pass);
+
+  /**
+   * Registers SPIR-V code that pipelines may use, e.g., embedded shaders.
+   *
+   * \note The code must outlive all pipeline builders created by `warm_up`.
+   *
+   * \param code the SPIR-V code.
+   */
+  void register_shader_code(std::span<const uint32> code);
+
+  /**
+   * Records the state of a pipeline builder.
+   *
+   * \details Equivalent states are only recorded once.
+   *
+   * \param builder the pipeline builder.
+   *
+   * \return true if the state is recorded; false if it refers to unregistered handles or
+   *         shader module handles.
+   */
+  auto record(const GraphicsPipelineBuilder& builder) -> bool;
+
+  /**
+   * Writes the recorded pipeline states to a file.
+   *
+   * \param path the path to the manifest file.
+   *
+   * \return `VK_SUCCESS` if the file was written, or an error otherwise.
+   */
+  auto save(const std::filesystem::path& path) const -> VkResult;
+
+  /**
+   * Adds the pipeline states in a manifest file to the manifest.
+   *
+   * \details Nothing is added if the file is invalid, e.g., due to a format change.
+   *
+   * \param path the path to the manifest file.
+   *
+   * \return `VK_SUCCESS` if the file was read, or an error otherwise.
+   */
+  auto load(const std::filesystem::path& path) -> VkResult;
+
+  /**
+   * Builds the pipelines of all recorded states in parallel.
+   *
+   * \details The recorded states are restored with the currently registered handles and
+   *          shader code, and the pipelines are built through the registry, so that
+   *          later requests for the same states are served by the warmed-up pipelines.
+   *          States that refer to unregistered names or code are skipped.
+   *
+   * \note The registry must outlive the returned futures.
+   *
+   * \param device   the associated logical device.
+   * \param registry the registry that receives the pipelines.
+   * \param pool     the thread pool that builds the pipelines.
+   * \param cache    the pipeline cache used by the builders, may be null.
+   * \param library  the shader library used by the builders, may be null.
+   *
+   * \return the results of the pending pipeline builds.
+   */
+  [[nodiscard]] auto warm_up(VkDevice device,
+                             PipelineRegistry& registry,
+                             ThreadPool& pool,
+                             VkPipelineCache cache = VK_NULL_HANDLE,
+                             ShaderLibrary* library = nullptr) const
+      -> std::vector<std::future<VkResult>>;
+
+  /**
+   * Builds the pipelines of all recorded states in parallel, using per-thread caches.
+   *
+   * \details This avoids contention on a shared pipeline cache. The thread caches should
+   *          be merged once all pipelines have been built.
+   *
+   * \note The registry and the cache pool must outlive the returned futures.
+   *
+   * \param device   the associated logical device.
+   * \param registry the registry that receives the pipelines.
+   * \param pool     the thread pool that builds the pipelines.
+   * \param caches   the pool of per-thread pipeline caches.
+   * \param library  the shader library used by the builders, may be null.
+   *
+   * \return the results of the pending pipeline builds.
+   */
+  [[nodiscard]] auto warm_up(VkDevice device,
+                             PipelineRegistry& registry,
+                             ThreadPool& pool,
+                             PipelineCachePool& caches,
+                             ShaderLibrary* library = nullptr) const
+      -> std::vector<std::future<VkResult>>;
+
+  /// Removes all recorded pipeline states, but keeps the registered names and code.
+  void clear();
+
+  /// Returns the number of recorded pipeline states.
+  [[nodiscard]] auto size() const -> usize;
+
+ private:
+  // An encoded entry, as written to manifest files
+  using Record = std::vector<std::byte>;
+
+  struct Entry final {
+    std::string layout;
+    std::string render_pass;
+    std::vector<std::byte> state;
+  };
+
+  mutable std::mutex mMutex;
+  std::unordered_map<std::string, VkPipelineLayout> mLayouts;
+  std::unordered_map<std::string, VkRenderPass> mRenderPasses;
+  std::unordered_map<VkPipelineLayout, std::string> mLayoutNames;
+  std::unordered_map<VkRenderPass, std::string> mRenderPassNames;
+  std::unordered_map<uint64, std::span<const uint32>> mShaderCode;
+  std::vector<Entry> mEntries;
+  std::unordered_set<Record, PipelineStateKeyHasher> mRecords;
+
+  // Note, the mutex must be held by the caller
+  void _add(Entry entry);
+
+  [[nodiscard]] auto _warm_up(VkDevice device,
+                              PipelineRegistry& registry,
+                              ThreadPool& pool,
+                              VkPipelineCache cache,
+                              PipelineCachePool* caches,
+                              ShaderLibrary* library) const
+      -> std::vector<std::future<VkResult>>;
+};
+
+}  // namespace grace
@@ -0,0 +1,107 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>        // byte
+#include <mutex>          // mutex
+#include <unordered_map>  // unordered_map
+#include <vector>         // vector
+
+#include <vulkan/vulkan.h>
+
+#include "common.hpp"
+#include "pipeline.hpp"
+
+namespace grace {
+
+class PipelineManifest;
+
+/**
+ * A thread-safe registry of graphics pipelines, deduplicated by pipeline state.
+ *
+ * \details Pipelines are identified by the state keys of the builders used to create
+ *          them, so equivalent builders share a single pipeline, which avoids redundant
+ *          pipeline compilations. Since specialization constants are part of the state
+ *          keys, the registry also serves as a cache of shader variants. The registry
+ *          owns all pipelines it creates.
+ */
+class PipelineRegistry final {
+ public:
+  PipelineRegistry() = default;
+
+  PipelineRegistry(const PipelineRegistry& other) = delete;
+  PipelineRegistry(PipelineRegistry&& other) = delete;
+
+  auto operator=(const PipelineRegistry& other) -> PipelineRegistry& = delete;
+  auto operator=(PipelineRegistry&& other) -> PipelineRegistry& = delete;
+
+  /**
+   * Specifies a manifest that records the states of all pipelines built by the registry.
+   *
+   * \note This function must not be called while other threads use the registry.
+   *
+   * \param manifest the pipeline manifest, may be null.
+   */
+  void set_manifest(PipelineManifest* manifest) noexcept { mManifest = manifest; }
+
+  /// Destroys all pipelines in the registry.
+  void clear() noexcept;
+
+  /**
+   * Returns a pipeline that matches the state of a pipeline builder.
+   *
+   * \details The pipeline is only built if there is no equivalent pipeline in the
+   *          registry. Pipelines are built without holding any locks, so several
+   *          threads may build different pipelines concurrently.
+   *
+   * \param      builder the pipeline builder that describes the pipeline.
+   * \param[out] result  the resulting error code.
+   *
+   * \return a potentially null pipeline handle, owned by the registry.
+   */
+  [[nodiscard]] auto get(const GraphicsPipelineBuilder& builder,
+                         VkResult* result = nullptr) -> VkPipeline;
+
+  /**
+   * Returns an existing pipeline that matches the state of a pipeline builder.
+   *
+   * \param builder the pipeline builder that describes the pipeline.
+   *
+   * \return a pipeline handle, or null if there is no such pipeline in the registry.
+   */
+  [[nodiscard]] auto find(const GraphicsPipelineBuilder& builder) -> VkPipeline;
+
+  /// Returns the number of unique pipelines in the registry.
+  [[nodiscard]] auto size() const -> usize;
+
+ private:
+  using StateKey = std::vector<std::byte>;
+
+  mutable std::mutex mMutex;
+  PipelineManifest* mManifest {nullptr};
+  std::unordered_map<StateKey, GraphicsPipeline, PipelineStateKeyHasher> mPipelines;
+};
+
+}  // namespace grace
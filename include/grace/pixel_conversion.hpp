@@ -0,0 +1,103 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "common.hpp"
+
+namespace grace {
+
+/// Represents CPU-side texel conversions applied when uploading image data.
+enum class PixelConversion {
+  kRgb8ToRgba8,            ///< RGB8 texels are expanded to RGBA8 with opaque alpha.
+  kLinearRgba32fToSrgba8,  ///< Linear RGBA32F texels are sRGB encoded to RGBA8.
+  kRgba32fToRgba16f,       ///< RGBA32F texels are converted to RGBA16F.
+  kPremultiplyRgba8,       ///< RGBA8 color channels are multiplied by alpha.
+};
+
+/**
+ * Returns the size of a single source texel for a pixel conversion.
+ *
+ * \param conversion the pixel conversion.
+ *
+ * \return the source texel size in bytes.
+ */
+[[nodiscard]] auto get_source_texel_size(PixelConversion conversion) noexcept -> uint64;
+
+/**
+ * Returns the size of a single converted texel for a pixel conversion.
+ *
+ * \param conversion the pixel conversion.
+ *
+ * \return the converted texel size in bytes.
+ */
+[[nodiscard]] auto get_target_texel_size(PixelConversion conversion) noexcept -> uint64;
+
+/**
+ * Indicates whether an image format can hold the output of a pixel conversion.
+ *
+ * \param conversion the pixel conversion.
+ * \param format     the image format.
+ *
+ * \return true if the converted texels match the format; false otherwise.
+ */
+[[nodiscard]] auto is_conversion_target(PixelConversion conversion,
+                                        VkFormat format) noexcept -> bool;
+
+/**
+ * Converts a single-precision float to a half-precision float.
+ *
+ * \details Values are rounded to the nearest representable value, values that are too
+ *          large become infinity, and NaN values are preserved. All cases are computed
+ *          and selected with bit masks, so the conversion is branch-free.
+ *
+ * \param value the value to convert.
+ *
+ * \return the bits of the corresponding half-precision float.
+ */
+[[nodiscard]] auto float_to_half(float value) noexcept -> uint16;
+
+/**
+ * Converts texels and writes the result to a destination buffer.
+ *
+ * \details The conversion is fused with the copy, so that each texel is only touched
+ *          once, which makes it suitable for writing directly into mapped staging
+ *          memory. The RGB8, RGBA16F and premultiplication loops are branch-free, so
+ *          that they can be vectorized by the compiler. The sRGB encoding uses a lookup
+ *          table instead, which is cheaper than evaluating the transfer function, but
+ *          results in one scalar load per channel.
+ *
+ * \note The source and destination buffers must not overlap.
+ *
+ * \param conversion  the pixel conversion to apply.
+ * \param source      the source texels.
+ * \param destination the destination buffer, large enough for the converted texels.
+ * \param texel_count the number of texels to convert.
+ */
+void convert_pixels(PixelConversion conversion,
+                    const void* source,
+                    void* destination,
+                    uint64 texel_count) noexcept;
+
+}  // namespace grace
@@ -195,17 +195,23 @@ class RenderPassBuilder final {
    * Adds a depth attachment to the render pass (independent of the current subpass).
    *
    * \details This is a convenience function that assumes a final layout of
-   *          `VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL`.
+   *          `VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL`. Use
+   *          `VK_ATTACHMENT_STORE_OP_DONT_CARE` for depth values that aren't needed
+   *          after the render pass, which enables the use of transient depth buffers
+   *          backed by lazily allocated memory.
    *
    * \param format         the format of the image view used for the attachment.
    * \param initial_layout the layout of the attachment image when the render pass begins.
    * \param samples        the number of samples per texel.
+   * \param store_op       the operation applied to the depth values at the end.
    *
    * \return the render pass builder itself.
    */
   auto depth_attachment(VkFormat format,
                         VkImageLayout initial_layout = VK_IMAGE_LAYOUT_UNDEFINED,
-                        VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT) -> Self&;
+                        VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT,
+                        VkAttachmentStoreOp store_op = VK_ATTACHMENT_STORE_OP_STORE)
+      -> Self&;
 
   /**
    * Registers a subpass dependency.
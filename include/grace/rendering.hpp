@@ -0,0 +1,153 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <span>  // span
+
+#include <vulkan/vulkan.h>
+
+#include "common.hpp"
+
+namespace grace {
+
+/**
+ * Records a layout transition of an image for use as a color attachment.
+ *
+ * \details The previous contents of the image are discarded. This replaces the implicit
+ *          layout transition that a render pass would perform for a color attachment
+ *          with an undefined initial layout.
+ *
+ * \param cmd_buf the command buffer that will record the transition.
+ * \param image   the image to transition, e.g. a swapchain image.
+ */
+void cmd_transition_to_color_attachment(VkCommandBuffer cmd_buf, VkImage image);
+
+/**
+ * Records a layout transition of an image for use as a depth (and stencil) attachment.
+ *
+ * \details The previous contents of the image are discarded.
+ *
+ * \param cmd_buf the command buffer that will record the transition.
+ * \param image   the depth buffer image to transition.
+ * \param aspects the image aspects to transition.
+ */
+void cmd_transition_to_depth_attachment(
+    VkCommandBuffer cmd_buf,
+    VkImage image,
+    VkImageAspectFlags aspects = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
+
+/**
+ * Records a layout transition of a rendered color attachment for presentation.
+ *
+ * \param cmd_buf the command buffer that will record the transition.
+ * \param image   the swapchain image to transition.
+ */
+void cmd_transition_to_present(VkCommandBuffer cmd_buf, VkImage image);
+
+#ifdef VK_KHR_dynamic_rendering
+
+struct DynamicRenderingFunctions final {
+  PFN_vkCmdBeginRenderingKHR vkCmdBeginRenderingKHR {nullptr};
+  PFN_vkCmdEndRenderingKHR vkCmdEndRenderingKHR {nullptr};
+};
+
+/**
+ * Loads the functions provided by the `VK_KHR_dynamic_rendering` extension.
+ *
+ * \param device a logical device with the extension enabled.
+ *
+ * \return the extension functions, which are null if the extension isn't enabled.
+ */
+[[nodiscard]] auto get_dynamic_rendering_functions(VkDevice device)
+    -> DynamicRenderingFunctions;
+
+/**
+ * Indicates whether a physical device supports dynamic rendering.
+ *
+ * \param gpu the physical device to query.
+ *
+ * \return true if the `dynamicRendering` feature is supported; false otherwise.
+ */
+[[nodiscard]] auto is_dynamic_rendering_supported(VkPhysicalDevice gpu) -> bool;
+
+/**
+ * Creates a rendering attachment specification.
+ *
+ * \param image_view  the image view used for the attachment.
+ * \param layout      the layout of the image view during rendering.
+ * \param load_op     the operation used to load the attachment contents.
+ * \param store_op    the operation used to store the attachment contents.
+ * \param clear_value the clear value used if the attachment is cleared.
+ *
+ * \return a rendering attachment specification.
+ */
+[[nodiscard]] auto make_rendering_attachment_info(
+    VkImageView image_view,
+    VkImageLayout layout,
+    VkAttachmentLoadOp load_op = VK_ATTACHMENT_LOAD_OP_CLEAR,
+    VkAttachmentStoreOp store_op = VK_ATTACHMENT_STORE_OP_STORE,
+    const VkClearValue& clear_value = {}) -> VkRenderingAttachmentInfoKHR;
+
+[[nodiscard]] auto make_rendering_info(
+    const VkRect2D& render_area,
+    std::span<const VkRenderingAttachmentInfoKHR> color_attachments,
+    const VkRenderingAttachmentInfoKHR* depth_attachment = nullptr,
+    const VkRenderingAttachmentInfoKHR* stencil_attachment = nullptr)
+    -> VkRenderingInfoKHR;
+
+/**
+ * Begins a dynamic render pass instance that renders to the specified attachments.
+ *
+ * \details No render pass or framebuffer objects are involved, so the attachments may
+ *          change freely between frames, e.g. when the swapchain is recreated. The
+ *          attachment images must already be in the layouts used by the attachments.
+ *
+ * \param functions          the dynamic rendering extension functions.
+ * \param cmd_buf            the command buffer that will record the commands.
+ * \param render_area        the render area affected by the render pass instance.
+ * \param color_attachments  the color attachments, may be empty.
+ * \param depth_attachment   the depth attachment, may be null.
+ * \param stencil_attachment the stencil attachment, may be null.
+ */
+void cmd_begin_rendering(
+    const DynamicRenderingFunctions& functions,
+    VkCommandBuffer cmd_buf,
+    const VkRect2D& render_area,
+    std::span<const VkRenderingAttachmentInfoKHR> color_attachments,
+    const VkRenderingAttachmentInfoKHR* depth_attachment = nullptr,
+    const VkRenderingAttachmentInfoKHR* stencil_attachment = nullptr);
+
+/**
+ * Ends the current dynamic render pass instance.
+ *
+ * \param functions the dynamic rendering extension functions.
+ * \param cmd_buf   the command buffer that records the render pass instance.
+ */
+void cmd_end_rendering(const DynamicRenderingFunctions& functions,
+                       VkCommandBuffer cmd_buf);
+
+#endif  // VK_KHR_dynamic_rendering
+
+}  // namespace grace
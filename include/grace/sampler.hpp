@@ -27,9 +27,32 @@
 #include <vulkan/vulkan.h>
 
 #include "common.hpp"
+#include "physical_device.hpp"
 
 namespace grace {
 
+/**
+ * Creates a sampler specification.
+ *
+ * \details Anisotropic filtering is enabled if the GPU supports it, using the maximum
+ *          supported anisotropy level.
+ *
+ * \param gpu_info     a snapshot of the associated physical device.
+ * \param min_filter   the minification filter.
+ * \param mag_filter   the magnification filter.
+ * \param address_mode the address mode used for all coordinates.
+ * \param min_lod      the minimum level of detail.
+ * \param max_lod      the maximum level of detail.
+ *
+ * \return a sampler specification.
+ */
+[[nodiscard]] auto make_sampler_info(const PhysicalDeviceInfo& gpu_info,
+                                     VkFilter min_filter,
+                                     VkFilter mag_filter,
+                                     VkSamplerAddressMode address_mode,
+                                     float min_lod,
+                                     float max_lod) -> VkSamplerCreateInfo;
+
 [[nodiscard]] auto make_sampler_info(VkPhysicalDevice gpu,
                                      VkFilter min_filter,
                                      VkFilter mag_filter,
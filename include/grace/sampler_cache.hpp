@@ -0,0 +1,124 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <unordered_map>  // unordered_map
+
+#include <vulkan/vulkan.h>
+
+#include "common.hpp"
+#include "physical_device.hpp"
+#include "sampler.hpp"
+
+namespace grace {
+
+/**
+ * A cache of samplers that avoids creating several identical samplers.
+ *
+ * \details Drivers limit the number of samplers that may exist at the same time, so
+ *          samplers should be shared whenever possible. This cache deduplicates samplers
+ *          based on their creation information, and owns all samplers it creates. The
+ *          physical device properties used to describe samplers are queried once, when
+ *          the cache is created.
+ *
+ * \note Sampler creation information with extension structures (i.e., non-null `pNext`
+ *       pointers) is not supported.
+ */
+class SamplerCache final {
+ public:
+  SamplerCache() noexcept = default;
+
+  /**
+   * Creates an empty sampler cache.
+   *
+   * \param device the associated logical device.
+   * \param gpu    the associated physical device.
+   */
+  SamplerCache(VkDevice device, VkPhysicalDevice gpu);
+
+  SamplerCache(SamplerCache&& other) noexcept = default;
+  SamplerCache(const SamplerCache& other) = delete;
+
+  auto operator=(SamplerCache&& other) noexcept -> SamplerCache& = default;
+  auto operator=(const SamplerCache& other) -> SamplerCache& = delete;
+
+  /// Destroys all cached samplers.
+  void clear() noexcept;
+
+  /**
+   * Returns a sampler that matches a sampler specification.
+   *
+   * \details A new sampler is only created if there is no equivalent cached sampler.
+   *
+   * \param      sampler_info the sampler specification.
+   * \param[out] result       the resulting error code.
+   *
+   * \return a potentially null sampler handle, owned by the cache.
+   */
+  [[nodiscard]] auto get(const VkSamplerCreateInfo& sampler_info,
+                         VkResult* result = nullptr) -> VkSampler;
+
+  /**
+   * Returns a sampler with the specified filter and address modes.
+   *
+   * \param      filter       the minification and magnification filter.
+   * \param      address_mode the address mode used for all coordinates.
+   * \param[out] result       the resulting error code.
+   *
+   * \return a potentially null sampler handle, owned by the cache.
+   */
+  [[nodiscard]] auto get(VkFilter filter,
+                         VkSamplerAddressMode address_mode,
+                         VkResult* result = nullptr) -> VkSampler;
+
+  /// Returns the number of cached samplers.
+  [[nodiscard]] auto size() const noexcept -> usize { return mSamplers.size(); }
+
+  [[nodiscard]] auto gpu_info() const noexcept -> const PhysicalDeviceInfo&
+  {
+    return mGpuInfo;
+  }
+
+  [[nodiscard]] auto device() noexcept -> VkDevice { return mDevice; }
+
+ private:
+  struct SamplerInfoHasher final {
+    [[nodiscard]] auto operator()(const VkSamplerCreateInfo& info) const noexcept
+        -> usize;
+  };
+
+  struct SamplerInfoEqual final {
+    [[nodiscard]] auto operator()(const VkSamplerCreateInfo& lhs,
+                                  const VkSamplerCreateInfo& rhs) const noexcept
+        -> bool;
+  };
+
+  VkDevice mDevice {VK_NULL_HANDLE};
+  PhysicalDeviceInfo mGpuInfo;
+  std::unordered_map<VkSamplerCreateInfo, Sampler, SamplerInfoHasher, SamplerInfoEqual>
+      mSamplers;
+};
+
+}  // namespace grace
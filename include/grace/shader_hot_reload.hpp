@@ -0,0 +1,176 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <filesystem>  // path
+#include <future>      // future
+#include <optional>    // optional
+#include <string>      // string
+#include <vector>      // vector
+
+#include <vulkan/vulkan.h>
+
+#include "common.hpp"
+#include "file_watcher.hpp"
+#include "pipeline.hpp"
+#include "shader_library.hpp"
+#include "thread_pool.hpp"
+
+namespace grace {
+
+/**
+ * Rebuilds graphics pipelines in the background when their shader files change.
+ *
+ * \details Pipelines are registered with the builders that describe them. The shader
+ *          files referenced by the builders are watched, and when one of them changes,
+ *          only the pipelines that use it are rebuilt on a thread pool. Rebuilt pipelines
+ *          are swapped in by `update`, which should be called once per frame at a frame
+ *          boundary, e.g. right after waiting for the in-flight fence of the next frame.
+ *          Replaced pipelines are destroyed once all frames that may use them have
+ *          retired. If a rebuild fails, e.g. due to an invalid shader, the previous
+ *          pipeline is kept until the shader is fixed.
+ *
+ * \note Shader hot-reloaders are not thread-safe, and are intended to be used by a single
+ *       thread, e.g. the render thread. The device should be idle when they're destroyed.
+ */
+class ShaderHotReloader final {
+ public:
+  /**
+   * Creates a shader hot-reloader.
+   *
+   * \param pool             the thread pool that rebuilds pipelines.
+   * \param frames_in_flight the maximum number of frames that may use a pipeline at once.
+   * \param library          a shared shader library to invalidate, may be null. The
+   *                         shader libraries of the builders are invalidated as well.
+   * \param cache            the pipeline cache used for rebuilds, may be null.
+   */
+  ShaderHotReloader(ThreadPool& pool,
+                    uint32 frames_in_flight,
+                    ShaderLibrary* library = nullptr,
+                    VkPipelineCache cache = VK_NULL_HANDLE);
+
+  ShaderHotReloader(const ShaderHotReloader& other) = delete;
+  ShaderHotReloader(ShaderHotReloader&& other) = delete;
+
+  auto operator=(const ShaderHotReloader& other) -> ShaderHotReloader& = delete;
+  auto operator=(ShaderHotReloader&& other) -> ShaderHotReloader& = delete;
+
+  /// Waits for pending rebuilds, and destroys all pipelines.
+  ~ShaderHotReloader() noexcept;
+
+  /**
+   * Builds a pipeline and registers it for hot-reloading.
+   *
+   * \details The pipeline is registered even if it can't be built, so that it's built as
+   *          soon as its shaders are fixed.
+   *
+   * \param      builder the pipeline builder, which is copied.
+   * \param[out] result  the resulting error code.
+   *
+   * \return the identifier of the pipeline, to be used with `get`.
+   */
+  auto add(const GraphicsPipelineBuilder& builder, VkResult* result = nullptr) -> usize;
+
+  /**
+   * Schedules the pipelines that use a shader file to be rebuilt.
+   *
+   * \details This is done automatically for modified shader files, but may also be
+   *          useful for shaders that are modified by other means.
+   *
+   * \param path the file path to the compiled shader code, in any spelling.
+   *
+   * \return the number of affected pipelines.
+   */
+  auto reload(const std::filesystem::path& path) -> usize;
+
+  /**
+   * Swaps in rebuilt pipelines, and destroys pipelines that are no longer in use.
+   *
+   * \details This function doesn't block, and must be called once per frame.
+   *
+   * \return the number of pipelines that were swapped in.
+   */
+  auto update() -> usize;
+
+  /**
+   * Returns the current version of a pipeline.
+   *
+   * \param id the pipeline identifier.
+   *
+   * \return a potentially null pipeline handle, valid until the frame has retired.
+   */
+  [[nodiscard]] auto get(usize id) -> VkPipeline;
+
+  /**
+   * Returns the outcome of the most recent build of a pipeline.
+   *
+   * \param id the pipeline identifier.
+   *
+   * \return the result of the most recent (re)build.
+   */
+  [[nodiscard]] auto result(usize id) const -> VkResult;
+
+  /// Returns the number of pipelines that are currently being rebuilt.
+  [[nodiscard]] auto pending_count() const -> usize;
+
+  /// Returns the number of replaced pipelines that are waiting to be destroyed.
+  [[nodiscard]] auto retired_count() const noexcept -> usize { return mRetired.size(); }
+
+  /// Returns the number of registered pipelines.
+  [[nodiscard]] auto size() const noexcept -> usize { return mEntries.size(); }
+
+ private:
+  struct Entry final {
+    explicit Entry(const GraphicsPipelineBuilder& pipeline_builder)
+        : builder {pipeline_builder}
+    {
+    }
+
+    GraphicsPipelineBuilder builder;
+    GraphicsPipeline pipeline;
+    std::vector<std::filesystem::path> shader_files;  // Normalized
+    std::optional<std::future<GraphicsPipelineResult>> pending;
+    VkResult result {VK_SUCCESS};
+    bool stale {false};  // Whether a shader changed during the pending rebuild
+  };
+
+  struct RetiredPipeline final {
+    GraphicsPipeline pipeline;
+    uint64 frame {0};  // The frame at which the pipeline was replaced
+  };
+
+  ThreadPool* mPool {nullptr};
+  ShaderLibrary* mLibrary {nullptr};
+  VkPipelineCache mCache {VK_NULL_HANDLE};
+  FileWatcher mWatcher;
+  std::vector<Entry> mEntries;
+  std::vector<RetiredPipeline> mRetired;
+  uint64 mFrame {0};
+  uint32 mFramesInFlight {1};
+
+  void _rebuild(Entry& entry);
+};
+
+}  // namespace grace
@@ -0,0 +1,140 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <filesystem>     // path
+#include <mutex>          // mutex
+#include <optional>       // optional
+#include <string>         // string
+#include <string_view>    // string_view
+#include <unordered_map>  // unordered_map
+#include <utility>        // pair
+
+#include <vulkan/vulkan.h>
+
+#include "common.hpp"
+#include "shader_module.hpp"
+#include "shader_reflection.hpp"
+
+namespace grace {
+
+/**
+ * A thread-safe cache of SPIR-V code and shader modules.
+ *
+ * \details Shader files are only read once per path, and identical shader code is only
+ *          turned into a single shader module, even if it's loaded from several paths.
+ *          This means that building many pipeline variants that share shaders doesn't
+ *          repeatedly hit the filesystem or create redundant shader modules. The library
+ *          owns all shader modules it creates, so it must outlive any pipeline builders
+ *          that use it.
+ */
+class ShaderLibrary final {
+ public:
+  /**
+   * Creates an empty shader library.
+   *
+   * \param device the associated logical device.
+   */
+  explicit ShaderLibrary(VkDevice device);
+
+  ShaderLibrary(const ShaderLibrary& other) = delete;
+  ShaderLibrary(ShaderLibrary&& other) = delete;
+
+  auto operator=(const ShaderLibrary& other) -> ShaderLibrary& = delete;
+  auto operator=(ShaderLibrary&& other) -> ShaderLibrary& = delete;
+
+  /// Destroys all cached shader modules.
+  void clear() noexcept;
+
+  /**
+   * Forgets the code loaded from a file path, so that the file is read again next time.
+   *
+   * \details Shader modules created from the old code are kept alive until the library
+   *          is cleared, since pipelines may still be built from them on other threads.
+   *
+   * \param path the file path to the compiled shader code, in any spelling.
+   */
+  void invalidate(const std::filesystem::path& path);
+
+  /**
+   * Returns a shader module for a SPIR-V file, loading it if necessary.
+   *
+   * \param      path   the file path to the compiled shader code.
+   * \param[out] result the resulting error code.
+   *
+   * \return a potentially null shader module handle, owned by the library.
+   */
+  [[nodiscard]] auto get_module(const std::filesystem::path& path,
+                                VkResult* result = nullptr) -> VkShaderModule;
+
+  /**
+   * Returns a shader module for in-memory SPIR-V code, creating it if necessary.
+   *
+   * \param      code      the compiled shader code.
+   * \param      code_size the size of the code in bytes.
+   * \param[out] result    the resulting error code.
+   *
+   * \return a potentially null shader module handle, owned by the library.
+   */
+  [[nodiscard]] auto get_module(const void* code,
+                                usize code_size,
+                                VkResult* result = nullptr) -> VkShaderModule;
+
+  /**
+   * Returns the reflected interface of a SPIR-V file, loading it if necessary.
+   *
+   * \details The reflection is computed at most once per unique shader module.
+   *
+   * \param      path   the file path to the compiled shader code.
+   * \param[out] result the resulting error code.
+   *
+   * \return the shader reflection, which is empty on failure.
+   */
+  [[nodiscard]] auto get_reflection(const std::filesystem::path& path,
+                                    VkResult* result = nullptr) -> ShaderReflection;
+
+  /// Returns the number of unique shader modules in the library.
+  [[nodiscard]] auto module_count() const -> usize;
+
+  [[nodiscard]] auto device() noexcept -> VkDevice { return mDevice; }
+
+ private:
+  struct ShaderEntry final {
+    std::string code;
+    ShaderModule module;
+    std::optional<ShaderReflection> reflection;  // Lazily computed
+  };
+
+  VkDevice mDevice {VK_NULL_HANDLE};
+  mutable std::mutex mMutex;
+  std::unordered_map<uint64, ShaderEntry> mShaders;   // Content key -> shader
+  std::unordered_map<std::string, uint64> mPathKeys;  // Path -> content key
+
+  // The code is hashed by the caller, so that it's done without holding the lock.
+  [[nodiscard]] auto _get_or_create(std::string_view code, uint64 hash, VkResult* result)
+      -> std::pair<VkShaderModule, uint64>;
+};
+
+}  // namespace grace
@@ -0,0 +1,226 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <span>    // span
+#include <vector>  // vector
+
+#include <vulkan/vulkan.h>
+
+#include "common.hpp"
+#include "pipeline.hpp"
+
+namespace grace {
+
+#ifdef VK_EXT_shader_object
+
+/// The functions of `VK_EXT_shader_object`, including its dynamic state commands.
+struct ShaderObjectFunctions final {
+  PFN_vkCreateShadersEXT vkCreateShadersEXT {nullptr};
+  PFN_vkDestroyShaderEXT vkDestroyShaderEXT {nullptr};
+  PFN_vkCmdBindShadersEXT vkCmdBindShadersEXT {nullptr};
+
+  PFN_vkCmdSetVertexInputEXT vkCmdSetVertexInputEXT {nullptr};
+  PFN_vkCmdSetPrimitiveTopologyEXT vkCmdSetPrimitiveTopologyEXT {nullptr};
+  PFN_vkCmdSetPrimitiveRestartEnableEXT vkCmdSetPrimitiveRestartEnableEXT {nullptr};
+  PFN_vkCmdSetPatchControlPointsEXT vkCmdSetPatchControlPointsEXT {nullptr};
+  PFN_vkCmdSetViewportWithCountEXT vkCmdSetViewportWithCountEXT {nullptr};
+  PFN_vkCmdSetScissorWithCountEXT vkCmdSetScissorWithCountEXT {nullptr};
+
+  PFN_vkCmdSetRasterizerDiscardEnableEXT vkCmdSetRasterizerDiscardEnableEXT {nullptr};
+  PFN_vkCmdSetPolygonModeEXT vkCmdSetPolygonModeEXT {nullptr};
+  PFN_vkCmdSetCullModeEXT vkCmdSetCullModeEXT {nullptr};
+  PFN_vkCmdSetFrontFaceEXT vkCmdSetFrontFaceEXT {nullptr};
+  PFN_vkCmdSetDepthBiasEnableEXT vkCmdSetDepthBiasEnableEXT {nullptr};
+  PFN_vkCmdSetDepthClampEnableEXT vkCmdSetDepthClampEnableEXT {nullptr};
+
+  PFN_vkCmdSetRasterizationSamplesEXT vkCmdSetRasterizationSamplesEXT {nullptr};
+  PFN_vkCmdSetSampleMaskEXT vkCmdSetSampleMaskEXT {nullptr};
+  PFN_vkCmdSetAlphaToCoverageEnableEXT vkCmdSetAlphaToCoverageEnableEXT {nullptr};
+
+  PFN_vkCmdSetDepthTestEnableEXT vkCmdSetDepthTestEnableEXT {nullptr};
+  PFN_vkCmdSetDepthWriteEnableEXT vkCmdSetDepthWriteEnableEXT {nullptr};
+  PFN_vkCmdSetDepthCompareOpEXT vkCmdSetDepthCompareOpEXT {nullptr};
+  PFN_vkCmdSetDepthBoundsTestEnableEXT vkCmdSetDepthBoundsTestEnableEXT {nullptr};
+  PFN_vkCmdSetStencilTestEnableEXT vkCmdSetStencilTestEnableEXT {nullptr};
+  PFN_vkCmdSetStencilOpEXT vkCmdSetStencilOpEXT {nullptr};
+
+  PFN_vkCmdSetLogicOpEnableEXT vkCmdSetLogicOpEnableEXT {nullptr};
+  PFN_vkCmdSetLogicOpEXT vkCmdSetLogicOpEXT {nullptr};
+  PFN_vkCmdSetColorBlendEnableEXT vkCmdSetColorBlendEnableEXT {nullptr};
+  PFN_vkCmdSetColorBlendEquationEXT vkCmdSetColorBlendEquationEXT {nullptr};
+  PFN_vkCmdSetColorWriteMaskEXT vkCmdSetColorWriteMaskEXT {nullptr};
+};
+
+/**
+ * Loads the functions provided by the shader object extension.
+ *
+ * \param device a logical device with the `VK_EXT_shader_object` extension enabled.
+ *
+ * \return the extension functions, which are null if the extension isn't enabled.
+ */
+[[nodiscard]] auto get_shader_object_functions(VkDevice device) -> ShaderObjectFunctions;
+
+/**
+ * Creates a shader object specification for SPIR-V code.
+ *
+ * \details Unlike shader modules, shader objects are compiled on creation, so they
+ *          need the descriptor set layouts and push constant ranges of the pipeline
+ *          layout they will be used with.
+ *
+ * \param stage                the shader stage.
+ * \param next_stage           the stages that may follow the shader stage, if any.
+ * \param code                 the SPIR-V code.
+ * \param entry_name           the name of the shader entry point.
+ * \param set_layouts          the descriptor set layouts accessible to the shader.
+ * \param push_constant_ranges the push constant ranges accessible to the shader.
+ * \param specialization       the specialization constants, may be null.
+ *
+ * \return a shader object specification.
+ */
+[[nodiscard]] auto make_shader_object_info(
+    VkShaderStageFlagBits stage,
+    VkShaderStageFlags next_stage,
+    std::span<const uint32> code,
+    const char* entry_name = "main",
+    std::span<const VkDescriptorSetLayout> set_layouts = {},
+    std::span<const VkPushConstantRange> push_constant_ranges = {},
+    const VkSpecializationInfo* specialization = nullptr) -> VkShaderCreateInfoEXT;
+
+class ShaderObject final {
+ public:
+  /**
+   * Creates a shader object.
+   *
+   * \param      device      the associated logical device.
+   * \param      functions   the shader object functions.
+   * \param      shader_info the shader object specification.
+   * \param[out] result      the resulting error code.
+   *
+   * \return a potentially null shader object.
+   */
+  [[nodiscard]] static auto make(VkDevice device,
+                                 const ShaderObjectFunctions& functions,
+                                 const VkShaderCreateInfoEXT& shader_info,
+                                 VkResult* result = nullptr) -> ShaderObject;
+
+  /**
+   * Creates several shader objects at once.
+   *
+   * \details Shaders that are created with `VK_SHADER_CREATE_LINK_STAGE_BIT_EXT` are
+   *          linked, which lets the driver optimize across the stages, similar to a
+   *          pipeline. Linked shaders must be bound together.
+   *
+   * \param      device       the associated logical device.
+   * \param      functions    the shader object functions.
+   * \param      shader_infos the shader object specifications.
+   * \param[out] result       the resulting error code.
+   *
+   * \return the shader objects in the order of the specifications, or nothing on error.
+   */
+  [[nodiscard]] static auto make_all(VkDevice device,
+                                     const ShaderObjectFunctions& functions,
+                                     std::span<const VkShaderCreateInfoEXT> shader_infos,
+                                     VkResult* result = nullptr)
+      -> std::vector<ShaderObject>;
+
+  ShaderObject() noexcept = default;
+
+  ShaderObject(VkDevice device,
+               VkShaderEXT shader,
+               PFN_vkDestroyShaderEXT destroy_function) noexcept;
+
+  ShaderObject(ShaderObject&& other) noexcept;
+  ShaderObject(const ShaderObject& other) = delete;
+
+  auto operator=(ShaderObject&& other) noexcept -> ShaderObject&;
+  auto operator=(const ShaderObject& other) -> ShaderObject& = delete;
+
+  ~ShaderObject() noexcept;
+
+  /// Destroys the underlying shader object.
+  void destroy() noexcept;
+
+  [[nodiscard]] auto get() noexcept -> VkShaderEXT { return mShader; }
+
+  [[nodiscard]] auto device() noexcept -> VkDevice { return mDevice; }
+
+  [[nodiscard]] operator VkShaderEXT() noexcept { return mShader; }
+
+  /// Indicates whether the underlying shader object handle is non-null.
+  [[nodiscard]] explicit operator bool() const noexcept
+  {
+    return mShader != VK_NULL_HANDLE;
+  }
+
+ private:
+  VkDevice mDevice {VK_NULL_HANDLE};
+  VkShaderEXT mShader {VK_NULL_HANDLE};
+  PFN_vkDestroyShaderEXT mDestroyFunction {nullptr};
+};
+
+/**
+ * Binds vertex and fragment shader objects.
+ *
+ * \details The tessellation and geometry stages are unbound if their features are
+ *          enabled, which is required before drawing. Stages whose features aren't
+ *          enabled must not be bound at all. Mesh shading stages are left untouched.
+ *
+ * \param functions        the shader object functions.
+ * \param cmd_buf          the command buffer that will record the commands.
+ * \param enabled_features the core features enabled for the device.
+ * \param vertex_shader    the vertex shader object.
+ * \param fragment_shader  the fragment shader object, may be null.
+ */
+void cmd_bind_graphics_shaders(const ShaderObjectFunctions& functions,
+                               VkCommandBuffer cmd_buf,
+                               const VkPhysicalDeviceFeatures& enabled_features,
+                               VkShaderEXT vertex_shader,
+                               VkShaderEXT fragment_shader);
+
+/**
+ * Sets all graphics state that shader objects require, based on a pipeline builder.
+ *
+ * \details Shader objects have no baked state, so this sets the state that the builder
+ *          would otherwise bake into a pipeline, i.e., vertex input, input assembly,
+ *          rasterization, multisampling, depth, stencil and blending state. The same
+ *          builder can thus describe both a pipeline and the equivalent shader object
+ *          state. The shaders and layout of the builder are ignored.
+ *
+ * \note States that are dynamic in the builder are left untouched, so they can be set
+ *       as usual. However, viewports and scissors must then be set with
+ *       `vkCmdSetViewportWithCount` and `vkCmdSetScissorWithCount`.
+ *
+ * \param functions the shader object functions.
+ * \param cmd_buf   the command buffer that will record the commands.
+ * \param builder   the pipeline builder that describes the state.
+ */
+void cmd_set_graphics_state(const ShaderObjectFunctions& functions,
+                            VkCommandBuffer cmd_buf,
+                            const GraphicsPipelineBuilder& builder);
+
+#endif  // VK_EXT_shader_object
+
+}  // namespace grace
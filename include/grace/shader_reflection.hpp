@@ -0,0 +1,140 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>   // array
+#include <string>  // string
+#include <vector>  // vector
+
+#include <vulkan/vulkan.h>
+
+#include "common.hpp"
+
+namespace grace {
+
+class DescriptorSetLayoutBuilder;
+class PipelineLayoutBuilder;
+class GraphicsPipelineBuilder;
+
+struct ShaderDescriptorBinding final {
+  uint32 set {0};
+  uint32 binding {0};
+  VkDescriptorType type {VK_DESCRIPTOR_TYPE_MAX_ENUM};
+  uint32 count {1};  ///< The number of descriptors, zero for runtime-sized arrays.
+  VkShaderStageFlags stages {0};
+};
+
+struct ShaderVertexInput final {
+  uint32 location {0};
+  VkFormat format {VK_FORMAT_UNDEFINED};
+  uint32 size {0};  ///< The size of the attribute in bytes.
+};
+
+/// The resource interface of a shader, or of several shaders that are used together.
+struct ShaderReflection final {
+  VkShaderStageFlags stages {0};
+  std::string entry_point;
+  std::vector<ShaderDescriptorBinding> descriptors;  ///< Sorted by set and binding.
+  std::vector<ShaderVertexInput> vertex_inputs;      ///< Sorted by location.
+  uint32 push_constant_offset {0};
+  uint32 push_constant_size {0};        ///< Zero if there are no push constants.
+  std::array<uint32, 3> local_size {};  ///< The workgroup size of compute shaders.
+};
+
+/**
+ * Extracts the resource interface of a shader from its SPIR-V code.
+ *
+ * \details Descriptor bindings, push constants and vertex inputs (for vertex shaders)
+ *          of the first entry point are reflected. Only a small subset of SPIR-V is
+ *          parsed, so no external dependencies are needed.
+ *
+ * \note Array lengths given by specialization constants use their default values, and
+ *       vertex inputs of types without a matching vertex format are skipped.
+ *
+ * \param      code      the SPIR-V code, e.g. from `read_binary_file`.
+ * \param      code_size the size of the code in bytes.
+ * \param[out] result    the resulting error code.
+ *
+ * \return the shader reflection, which is empty if the code is malformed.
+ */
+[[nodiscard]] auto reflect_shader(const void* code,
+                                  usize code_size,
+                                  VkResult* result = nullptr) -> ShaderReflection;
+
+/**
+ * Combines the reflections of shaders that are used in the same pipeline.
+ *
+ * \details Shared descriptor bindings are merged, and the push constant ranges are
+ *          combined into a single range accessible by all stages.
+ *
+ * \param a the first shader reflection.
+ * \param b the second shader reflection.
+ *
+ * \return the combined shader reflection.
+ */
+[[nodiscard]] auto merge_shader_reflections(const ShaderReflection& a,
+                                            const ShaderReflection& b)
+    -> ShaderReflection;
+
+/**
+ * Adds all reflected descriptor bindings of a descriptor set to a layout builder.
+ *
+ * \details The size of runtime-sized descriptor arrays isn't known from the shader, so
+ *          such bindings use the provided descriptor count instead.
+ *
+ * \param reflection          the shader reflection.
+ * \param set                 the index of the descriptor set.
+ * \param builder             the descriptor set layout builder that will be populated.
+ * \param runtime_array_count the descriptor count used for runtime-sized arrays.
+ */
+void populate_descriptor_set_layout(const ShaderReflection& reflection,
+                                    uint32 set,
+                                    DescriptorSetLayoutBuilder& builder,
+                                    uint32 runtime_array_count = 1);
+
+/**
+ * Adds the reflected push constant range, if any, to a pipeline layout builder.
+ *
+ * \param reflection the shader reflection.
+ * \param builder    the pipeline layout builder that will be populated.
+ */
+void populate_push_constants(const ShaderReflection& reflection,
+                             PipelineLayoutBuilder& builder);
+
+/**
+ * Adds the reflected vertex inputs as tightly packed, interleaved vertex attributes.
+ *
+ * \details Inputs with an undefined format are ignored, and no binding is added if
+ *          there are no remaining inputs.
+ *
+ * \param reflection the shader reflection.
+ * \param builder    the pipeline builder that will be populated.
+ * \param binding    the vertex input binding that provides the attributes.
+ */
+void populate_vertex_input(const ShaderReflection& reflection,
+                           GraphicsPipelineBuilder& builder,
+                           uint32 binding = 0);
+
+}  // namespace grace
@@ -0,0 +1,121 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>        // array
+#include <cstddef>      // byte
+#include <type_traits>  // is_same_v, is_arithmetic_v
+#include <vector>       // vector
+
+#include <vulkan/vulkan.h>
+
+#include "common.hpp"
+
+namespace grace {
+
+/// Indicates whether a type can be used as the value of a specialization constant.
+template <typename T>
+concept SpecializationConstantType =
+    std::is_same_v<T, bool> ||
+    (std::is_arithmetic_v<T> && (sizeof(T) == 4 || sizeof(T) == 8));
+
+/**
+ * A set of typed shader specialization constant values.
+ *
+ * \details Specialization constants let a single SPIR-V module be compiled into several
+ *          variants, where the driver can fold the constant values, e.g., to remove
+ *          disabled features. Boolean values are stored as `VkBool32`, as required by
+ *          the SPIR-V specification.
+ */
+class SpecializationConstants final {
+ public:
+  /**
+   * Sets the value of a specialization constant.
+   *
+   * \details Any previous value of the constant is replaced.
+   *
+   * \param constant_id the specialization constant ID, i.e. the `constant_id` in GLSL.
+   * \param value       the constant value.
+   *
+   * \return the specialization constants themselves.
+   */
+  template <SpecializationConstantType T>
+  auto set(const uint32 constant_id, const T value) -> SpecializationConstants&
+  {
+    if constexpr (std::is_same_v<T, bool>) {
+      const VkBool32 bool_value = value ? VK_TRUE : VK_FALSE;
+      _set(constant_id, &bool_value, sizeof bool_value);
+    }
+    else {
+      _set(constant_id, &value, sizeof value);
+    }
+
+    return *this;
+  }
+
+  /// Removes all specialization constant values.
+  void clear() noexcept;
+
+  /**
+   * Returns the specialization information for use in shader stages.
+   *
+   * \note The returned information is invalidated by any changes to the constants.
+   *
+   * \return specialization information that refers to the constants.
+   */
+  [[nodiscard]] auto info() const noexcept -> VkSpecializationInfo;
+
+  [[nodiscard]] auto get_map_entries() const noexcept
+      -> const std::vector<VkSpecializationMapEntry>&
+  {
+    return mEntries;
+  }
+
+  [[nodiscard]] auto get_data() const noexcept -> const std::vector<std::byte>&
+  {
+    return mData;
+  }
+
+  [[nodiscard]] auto size() const noexcept -> usize { return mEntries.size(); }
+
+  [[nodiscard]] auto empty() const noexcept -> bool { return mEntries.empty(); }
+
+ private:
+  struct Constant final {
+    uint32 id {0};
+    uint32 size {0};
+    std::array<std::byte, 8> value {};
+  };
+
+  std::vector<Constant> mConstants;  // Sorted by constant ID
+  std::vector<VkSpecializationMapEntry> mEntries;
+  std::vector<std::byte> mData;
+
+  void _set(uint32 constant_id, const void* value, usize value_size);
+
+  void _update_map();
+};
+
+}  // namespace grace
@@ -117,6 +117,17 @@ class Swapchain final {
 
   void destroy() noexcept;
 
+  /**
+   * Recreates the swapchain, e.g. after the window has been resized.
+   *
+   * \details Framebuffers are only created if a render pass is provided. Specify a null
+   *          render pass when using dynamic rendering, in which case the image views
+   *          are used directly as attachments.
+   *
+   * \param render_pass the render pass that the framebuffers are used with, or null.
+   *
+   * \return the resulting error code.
+   */
   auto recreate(VkRenderPass render_pass) -> VkResult;
 
   auto acquire_next_image(VkSemaphore semaphore = VK_NULL_HANDLE,
@@ -128,12 +139,20 @@ class Swapchain final {
 
   [[nodiscard]] auto get_current_framebuffer() -> VkFramebuffer;
 
+  [[nodiscard]] auto get_current_image() -> VkImage;
+
+  [[nodiscard]] auto get_current_image_view() -> VkImageView;
+
   [[nodiscard]] auto get_current_image_index() -> uint32;
 
   [[nodiscard]] auto get_image_count() const -> uint32;
 
   [[nodiscard]] auto get_depth_buffer_format() const -> VkFormat;
 
+  [[nodiscard]] auto get_depth_buffer_image() -> VkImage;
+
+  [[nodiscard]] auto get_depth_buffer_image_view() -> VkImageView;
+
   [[nodiscard]] auto is_ready() const -> bool;
 
   [[nodiscard]] auto get() noexcept -> VkSwapchainKHR { return mSwapchain; }
@@ -162,6 +181,7 @@ class Swapchain final {
   std::vector<VkImage> mImages;
   std::vector<ImageView> mImageViews;
   std::vector<Framebuffer> mFramebuffers;
+  bool mUsesFramebuffers {true};
 
   auto _recreate_image_views() -> VkResult;
   auto _recreate_framebuffers(VkRenderPass render_pass) -> VkResult;
@@ -0,0 +1,179 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <filesystem>  // path
+#include <functional>  // function
+#include <future>      // future
+#include <vector>      // vector
+
+#include <vk_mem_alloc.h>
+#include <vulkan/vulkan.h>
+
+#include "buffer.hpp"
+#include "common.hpp"
+#include "context.hpp"
+#include "texture.hpp"
+#include "thread_pool.hpp"
+
+namespace grace {
+
+/// A decoded texture stored in a staging buffer, waiting to be uploaded.
+struct StagedTexture final {
+  Buffer buffer;
+  VkExtent2D extent {0, 0};
+  VkFormat format {VK_FORMAT_UNDEFINED};
+  VkResult result {VK_SUCCESS};
+};
+
+/**
+ * Provides mapped staging memory to texture decoders.
+ *
+ * \details Decoders should write texel data directly into the memory returned by
+ *          `allocate()`, which avoids any intermediate copies of the decoded data.
+ */
+class TextureStagingArea final {
+ public:
+  explicit TextureStagingArea(VmaAllocator allocator) noexcept;
+
+  ~TextureStagingArea() noexcept;
+
+  TextureStagingArea(const TextureStagingArea& other) = delete;
+  TextureStagingArea(TextureStagingArea&& other) = delete;
+
+  auto operator=(const TextureStagingArea& other) -> TextureStagingArea& = delete;
+  auto operator=(TextureStagingArea&& other) -> TextureStagingArea& = delete;
+
+  /**
+   * Allocates mapped staging memory for a decoded texture.
+   *
+   * \details This function should be called at most once per decoded texture. The
+   *          texture fails with `VK_ERROR_VALIDATION_FAILED_EXT` if the data size is
+   *          too small for the extent, which can only be checked for uncompressed
+   *          formats.
+   *
+   * \param extent    the texture dimensions.
+   * \param format    the texel data format.
+   * \param data_size the size of the texel data in bytes.
+   *
+   * \return a pointer to at least `data_size` bytes of writable memory, or null if the
+   *         memory couldn't be allocated or the data size is invalid.
+   */
+  [[nodiscard]] auto allocate(const VkExtent2D& extent, VkFormat format, uint64 data_size)
+      -> void*;
+
+  /**
+   * Unmaps the staging memory and releases the staged texture.
+   *
+   * \param decoded indicates whether the decoder succeeded.
+   *
+   * \return the staged texture.
+   */
+  [[nodiscard]] auto finish(bool decoded) -> StagedTexture;
+
+ private:
+  VmaAllocator mAllocator {VK_NULL_HANDLE};
+  StagedTexture mTexture;
+  void* mData {nullptr};
+};
+
+/**
+ * Loads textures by decoding files on worker threads and uploading them in batches.
+ *
+ * \details Image files are decoded concurrently on a thread pool, directly into mapped
+ *          staging memory. The resulting copies and mipmap generation of all pending
+ *          textures are then recorded by the thread that calls `flush()`, and executed
+ *          in a single submission.
+ *
+ * \note The decoder is invoked concurrently from several threads, so it must be
+ *       thread-safe. Memory allocators are thread-safe unless created with the
+ *       `VMA_ALLOCATOR_CREATE_EXTERNALLY_SYNCHRONIZED_BIT` flag, which is not supported.
+ */
+class TextureLoader final {
+ public:
+  /**
+   * Decodes an image file into staging memory.
+   *
+   * \details The decoder should call `TextureStagingArea::allocate()` once it knows the
+   *          dimensions of the image, and return true if the image was decoded.
+   */
+  using Decoder =
+      std::function<bool(const std::filesystem::path& path, TextureStagingArea& staging)>;
+
+  /**
+   * Creates a texture loader.
+   *
+   * \param device    the associated logical device.
+   * \param allocator the allocator used for staging buffers and textures.
+   * \param pool      the thread pool used to decode files, must outlive the loader.
+   * \param decoder   the function object used to decode image files.
+   */
+  TextureLoader(VkDevice device,
+                VmaAllocator allocator,
+                ThreadPool& pool,
+                Decoder decoder);
+
+  /**
+   * Schedules a texture file to be decoded.
+   *
+   * \param path             the path to the image file.
+   * \param generate_mipmaps whether all mipmap levels should be generated.
+   *
+   * \return the index of the texture in the vector returned by the next `flush()` call.
+   */
+  auto enqueue(const std::filesystem::path& path, bool generate_mipmaps = true) -> usize;
+
+  /**
+   * Waits for all pending textures to be decoded and uploads them.
+   *
+   * \details All uploads and mipmap generation are recorded into a single command buffer.
+   *          The textures are left in the `VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL`
+   *          layout. Textures that couldn't be loaded are null, including textures whose
+   *          decoder threw an exception. The batch is always cleared.
+   *
+   * \param      ctx    the command context used to upload the textures.
+   * \param[out] result the first error that occurred, if any.
+   *
+   * \return the loaded textures, in the order they were enqueued.
+   */
+  [[nodiscard]] auto flush(const CommandContext& ctx, VkResult* result = nullptr)
+      -> std::vector<Texture>;
+
+  [[nodiscard]] auto pending_count() const noexcept -> usize { return mPending.size(); }
+
+ private:
+  struct PendingTexture final {
+    std::future<StagedTexture> staged;
+    bool generate_mipmaps {true};
+  };
+
+  VkDevice mDevice {VK_NULL_HANDLE};
+  VmaAllocator mAllocator {VK_NULL_HANDLE};
+  ThreadPool* mPool {nullptr};
+  Decoder mDecoder;
+  std::vector<PendingTexture> mPending;
+};
+
+}  // namespace grace
@@ -0,0 +1,105 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <condition_variable>  // condition_variable
+#include <functional>          // function
+#include <future>              // future, packaged_task
+#include <memory>              // make_shared
+#include <mutex>               // mutex, scoped_lock
+#include <queue>               // queue
+#include <thread>              // thread
+#include <type_traits>         // invoke_result_t, decay_t
+#include <utility>             // forward, move
+#include <vector>              // vector
+
+#include "common.hpp"
+
+namespace grace {
+
+/// Returns the number of threads used by default by thread pools.
+[[nodiscard]] auto get_default_thread_count() noexcept -> usize;
+
+/**
+ * A simple pool of worker threads that execute submitted tasks in FIFO order.
+ *
+ * \details This is used to spread expensive work, such as file decoding or pipeline
+ *          compilation, across all available cores. Pending tasks are completed before
+ *          the pool is destroyed.
+ */
+class ThreadPool final {
+ public:
+  /**
+   * Creates a thread pool.
+   *
+   * \param thread_count the number of worker threads (at least one thread is used).
+   */
+  explicit ThreadPool(usize thread_count = get_default_thread_count());
+
+  ~ThreadPool() noexcept;
+
+  ThreadPool(const ThreadPool& other) = delete;
+  ThreadPool(ThreadPool&& other) = delete;
+
+  auto operator=(const ThreadPool& other) -> ThreadPool& = delete;
+  auto operator=(ThreadPool&& other) -> ThreadPool& = delete;
+
+  /**
+   * Schedules a task for execution on one of the worker threads.
+   *
+   * \param callable the function object that will be invoked, without any arguments.
+   *
+   * \return a future that provides the result of the task.
+   */
+  template <typename Callable>
+  auto submit(Callable&& callable)
+      -> std::future<std::invoke_result_t<std::decay_t<Callable>>>
+  {
+    using result_type = std::invoke_result_t<std::decay_t<Callable>>;
+
+    auto task = std::make_shared<std::packaged_task<result_type()>>(
+        std::forward<Callable>(callable));
+    auto future = task->get_future();
+
+    _enqueue([task] { (*task)(); });
+
+    return future;
+  }
+
+  [[nodiscard]] auto thread_count() const noexcept -> usize { return mThreads.size(); }
+
+ private:
+  std::vector<std::thread> mThreads;
+  std::queue<std::function<void()>> mTasks;
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  bool mStopping {false};
+
+  void _enqueue(std::function<void()> task);
+
+  void _run_worker();
+};
+
+}  // namespace grace
@@ -0,0 +1,126 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/async_pipeline.hpp"
+
+#include <chrono>   // seconds
+#include <new>      // bad_alloc
+#include <utility>  // move
+
+namespace grace {
+
+AsyncPipeline::AsyncPipeline(std::future<GraphicsPipelineResult> pending,
+                             VkPipeline fallback) noexcept
+    : mPending {std::move(pending)},
+      mFallback {fallback}
+{
+  if (mPending.valid()) {
+    mResult = VK_NOT_READY;
+  }
+}
+
+auto AsyncPipeline::request(const GraphicsPipelineBuilder& builder,
+                            ThreadPool& pool,
+                            VkPipeline fallback) -> AsyncPipeline
+{
+  auto pending = pool.submit([builder] {
+    GraphicsPipelineResult pipeline;
+    pipeline.pipeline = builder.build(&pipeline.result);
+
+    return pipeline;
+  });
+
+  return AsyncPipeline {std::move(pending), fallback};
+}
+
+void AsyncPipeline::wait()
+{
+  if (mPending.valid()) {
+    mPending.wait();
+  }
+
+  _poll();
+}
+
+auto AsyncPipeline::bind(VkCommandBuffer cmd_buf) -> bool
+{
+  const auto pipeline = get();
+
+  if (pipeline != VK_NULL_HANDLE) {
+    vkCmdBindPipeline(cmd_buf, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    return true;
+  }
+
+  return false;
+}
+
+auto AsyncPipeline::ready() -> bool
+{
+  _poll();
+  return mPipeline.get() != VK_NULL_HANDLE;
+}
+
+auto AsyncPipeline::pending() -> bool
+{
+  _poll();
+  return mPending.valid();
+}
+
+auto AsyncPipeline::get() -> VkPipeline
+{
+  return ready() ? mPipeline.get() : mFallback;
+}
+
+auto AsyncPipeline::result() -> VkResult
+{
+  _poll();
+  return mResult;
+}
+
+void AsyncPipeline::_poll()
+{
+  if (!mPending.valid()) {
+    return;
+  }
+
+  if (mPending.wait_for(std::chrono::seconds {0}) != std::future_status::ready) {
+    return;
+  }
+
+  // Exceptions thrown while compiling are rethrown here, and are treated as failures
+  try {
+    auto [pipeline, result] = mPending.get();
+
+    mPipeline = std::move(pipeline);
+    mResult = result;
+  }
+  catch (const std::bad_alloc&) {
+    mResult = VK_ERROR_OUT_OF_HOST_MEMORY;
+  }
+  catch (...) {
+    mResult = VK_ERROR_UNKNOWN;
+  }
+}
+
+}  // namespace grace
@@ -25,6 +25,7 @@
 #include "grace/buffer.hpp"
 
 #include <algorithm>  // min
+#include <cstddef>    // byte
 #include <cstring>    // memcpy
 
 #include "grace/allocator.hpp"
@@ -251,7 +252,8 @@ auto Buffer::on_gpu(const CommandContext& ctx,
   return {};
 }
 
-auto Buffer::set_data(const void* data, const uint64 data_size) -> VkResult
+auto Buffer::set_data(const void* data, const uint64 data_size, const uint64 offset)
+    -> VkResult
 {
   void* mapped_data = nullptr;
 
@@ -265,13 +267,35 @@ auto Buffer::set_data(const void* data, const uint64 data_size) -> VkResult
 
   // Transfer the data, making sure not to write too much data into the buffer
   const auto allocation_size = static_cast<uint64>(allocation_info.size);
-  std::memcpy(mapped_data, data, std::min(data_size, allocation_size));
+  if (offset < allocation_size) {
+    std::memcpy(static_cast<std::byte*>(mapped_data) + offset,
+                data,
+                std::min(data_size, allocation_size - offset));
+  }
 
   vmaUnmapMemory(mAllocator, mAllocation);
 
   return VK_SUCCESS;
 }
 
+auto Buffer::map(VkResult* result) -> void*
+{
+  void* mapped_data = nullptr;
+
+  const auto status = vmaMapMemory(mAllocator, mAllocation, &mapped_data);
+
+  if (result) {
+    *result = status;
+  }
+
+  return (status == VK_SUCCESS) ? mapped_data : nullptr;
+}
+
+void Buffer::unmap() noexcept
+{
+  vmaUnmapMemory(mAllocator, mAllocation);
+}
+
 void Buffer::bind_as_vertex_buffer(VkCommandBuffer cmd_buffer)
 {
   const VkDeviceSize offsets[] = {0};
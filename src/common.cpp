@@ -64,4 +64,17 @@ auto to_string(VkResult result) -> const char*
   }
 }
 
+auto fnv1a_hash(const void* data, const usize size, const uint64 seed) -> uint64
+{
+  const auto* bytes = static_cast<const unsigned char*>(data);
+
+  uint64 hash = seed;
+  for (usize index = 0; index < size; ++index) {
+    hash ^= bytes[index];
+    hash *= kFnv1aPrime;
+  }
+
+  return hash;
+}
+
 }  // namespace grace
\ No newline at end of file
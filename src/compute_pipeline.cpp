@@ -0,0 +1,259 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/compute_pipeline.hpp"
+
+#include <utility>  // move
+
+namespace grace {
+
+void cmd_dispatch_1d(VkCommandBuffer cmd_buf,
+                     const uint32 invocation_count,
+                     const uint32 local_size)
+{
+  vkCmdDispatch(cmd_buf, get_group_count(invocation_count, local_size), 1, 1);
+}
+
+void cmd_dispatch_2d(VkCommandBuffer cmd_buf,
+                     const VkExtent2D& extent,
+                     const VkExtent2D& local_size)
+{
+  vkCmdDispatch(cmd_buf,
+                get_group_count(extent.width, local_size.width),
+                get_group_count(extent.height, local_size.height),
+                1);
+}
+
+void cmd_dispatch_3d(VkCommandBuffer cmd_buf,
+                     const VkExtent3D& extent,
+                     const VkExtent3D& local_size)
+{
+  vkCmdDispatch(cmd_buf,
+                get_group_count(extent.width, local_size.width),
+                get_group_count(extent.height, local_size.height),
+                get_group_count(extent.depth, local_size.depth));
+}
+
+auto ComputePipeline::make(VkDevice device,
+                           const VkComputePipelineCreateInfo& pipeline_info,
+                           VkPipelineCache cache,
+                           VkResult* result) -> ComputePipeline
+{
+  VkPipeline pipeline = VK_NULL_HANDLE;
+  const auto status =
+      vkCreateComputePipelines(device, cache, 1, &pipeline_info, nullptr, &pipeline);
+
+  if (result) {
+    *result = status;
+  }
+
+  if (status == VK_SUCCESS) {
+    return ComputePipeline {device, pipeline};
+  }
+
+  return {};
+}
+
+void ComputePipeline::bind(VkCommandBuffer cmd_buf)
+{
+  vkCmdBindPipeline(cmd_buf, VK_PIPELINE_BIND_POINT_COMPUTE, get());
+}
+
+ComputePipelineBuilder::ComputePipelineBuilder(VkDevice device)
+    : mDevice {device}
+{
+  reset();
+}
+
+auto ComputePipelineBuilder::reset() -> Self&
+{
+  mConstants.clear();
+
+  // The shader setter is overloaded for paths, modules and code, so it is reset here
+  mShaderPath.clear();
+  mEntryName = "main";
+  mShaderModule = VK_NULL_HANDLE;
+  mShaderCode = {};
+
+  return with_layout(VK_NULL_HANDLE)
+      .with_cache(VK_NULL_HANDLE)
+      .with_shader_library(nullptr)
+      .with_feedback_callback(nullptr, false);
+}
+
+auto ComputePipelineBuilder::with_layout(VkPipelineLayout layout) -> Self&
+{
+  mLayout = layout;
+  return *this;
+}
+
+auto ComputePipelineBuilder::with_cache(VkPipelineCache cache) -> Self&
+{
+  mCache = cache;
+  return *this;
+}
+
+auto ComputePipelineBuilder::with_shader_library(ShaderLibrary* library) -> Self&
+{
+  mShaderLibrary = library;
+  return *this;
+}
+
+auto ComputePipelineBuilder::with_feedback_callback(PipelineFeedbackCallback callback,
+                                     bool feedback_enabled) -> Self&
+{
+  mFeedbackCallback = std::move(callback);
+  mFeedbackEnabled = feedback_enabled;
+  return *this;
+}
+
+auto ComputePipelineBuilder::shader(const char* shader_path, const char* entry_name)
+    -> Self&
+{
+  mShaderPath = shader_path ? shader_path : std::string {};
+  mEntryName = entry_name ? entry_name : "main";
+  mShaderModule = VK_NULL_HANDLE;
+  mShaderCode = {};
+  return *this;
+}
+
+auto ComputePipelineBuilder::shader(VkShaderModule shader_module, const char* entry_name)
+    -> Self&
+{
+  mShaderPath.clear();
+  mEntryName = entry_name ? entry_name : "main";
+  mShaderModule = shader_module;
+  mShaderCode = {};
+  return *this;
+}
+
+auto ComputePipelineBuilder::shader(const std::span<const uint32> code,
+                                    const char* entry_name) -> Self&
+{
+  mShaderPath.clear();
+  mEntryName = entry_name ? entry_name : "main";
+  mShaderModule = VK_NULL_HANDLE;
+  mShaderCode = code;
+  return *this;
+}
+
+auto ComputePipelineBuilder::specialization(const SpecializationConstants& constants)
+    -> Self&
+{
+  mConstants = constants;
+  return *this;
+}
+
+auto ComputePipelineBuilder::build(VkResult* result) const -> ComputePipeline
+{
+  if (!_is_complete()) {
+    if (result) {
+      *result = VK_INCOMPLETE;
+    }
+
+    return {};
+  }
+
+  ShaderModule owned_shader;
+  VkShaderModule shader = mShaderModule;
+
+  if (shader == VK_NULL_HANDLE && !mShaderCode.empty()) {
+    if (mShaderLibrary) {
+      shader = mShaderLibrary->get_module(mShaderCode.data(),
+                                          mShaderCode.size_bytes(),
+                                          result);
+    }
+    else {
+      owned_shader = ShaderModule::make(mDevice,
+                                        mShaderCode.data(),
+                                        mShaderCode.size_bytes(),
+                                        result);
+      shader = owned_shader.get();
+    }
+  }
+  else if (shader == VK_NULL_HANDLE) {
+    if (mShaderLibrary) {
+      shader = mShaderLibrary->get_module(mShaderPath, result);
+    }
+    else {
+      owned_shader = ShaderModule::read(mDevice, mShaderPath.c_str(), result);
+      shader = owned_shader.get();
+    }
+  }
+
+  if (shader == VK_NULL_HANDLE) {
+    return {};
+  }
+
+  const auto specialization = mConstants.info();
+
+  VkComputePipelineCreateInfo pipeline_info = {
+      .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+      .pNext = nullptr,
+      .flags = 0,
+      .stage = make_pipeline_shader_stage_info(
+          VK_SHADER_STAGE_COMPUTE_BIT,
+          shader,
+          !mConstants.empty() ? &specialization : nullptr,
+          mEntryName.c_str()),
+      .layout = mLayout,
+      .basePipelineHandle = VK_NULL_HANDLE,
+      .basePipelineIndex = 0,
+  };
+
+#ifdef VK_EXT_pipeline_creation_feedback
+  if (mFeedbackCallback && mFeedbackEnabled) {
+    PipelineFeedbackQuery query {1, pipeline_info.pNext};
+    pipeline_info.pNext = query.get_info();
+
+    auto pipeline = ComputePipeline::make(mDevice, pipeline_info, mCache, result);
+
+    if (pipeline) {
+      mFeedbackCallback(query.get_feedback(pipeline.get(), {&pipeline_info.stage, 1}));
+    }
+
+    return pipeline;
+  }
+#endif  // VK_EXT_pipeline_creation_feedback
+
+  auto pipeline = ComputePipeline::make(mDevice, pipeline_info, mCache, result);
+
+  // Report that no statistics are available for the pipeline
+  if (pipeline && mFeedbackCallback) {
+    mFeedbackCallback(PipelineFeedback {.pipeline = pipeline.get()});
+  }
+
+  return pipeline;
+}
+
+auto ComputePipelineBuilder::_is_complete() const -> bool
+{
+  const auto has_shader = !mShaderPath.empty() ||             //
+                          mShaderModule != VK_NULL_HANDLE ||  //
+                          !mShaderCode.empty();
+
+  return mLayout != VK_NULL_HANDLE && has_shader;
+}
+
+}  // namespace grace
@@ -0,0 +1,267 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/dynamic_state.hpp"
+
+#include "grace/device.hpp"
+
+namespace grace {
+namespace {
+
+[[nodiscard]] constexpr auto to_bool32(const bool value) noexcept -> VkBool32
+{
+  return value ? VK_TRUE : VK_FALSE;
+}
+
+}  // namespace
+
+auto get_extended_dynamic_state_support(VkPhysicalDevice gpu)
+    -> ExtendedDynamicStateSupport
+{
+  VkPhysicalDeviceFeatures2 features = {};
+  features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+
+#ifdef VK_EXT_extended_dynamic_state
+  VkPhysicalDeviceExtendedDynamicStateFeaturesEXT state1_features = {};
+  state1_features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+  state1_features.pNext = features.pNext;
+  features.pNext = &state1_features;
+#endif  // VK_EXT_extended_dynamic_state
+
+#ifdef VK_EXT_extended_dynamic_state2
+  VkPhysicalDeviceExtendedDynamicState2FeaturesEXT state2_features = {};
+  state2_features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT;
+  state2_features.pNext = features.pNext;
+  features.pNext = &state2_features;
+#endif  // VK_EXT_extended_dynamic_state2
+
+#ifdef VK_EXT_extended_dynamic_state3
+  VkPhysicalDeviceExtendedDynamicState3FeaturesEXT state3_features = {};
+  state3_features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+  state3_features.pNext = features.pNext;
+  features.pNext = &state3_features;
+#endif  // VK_EXT_extended_dynamic_state3
+
+  vkGetPhysicalDeviceFeatures2(gpu, &features);
+
+  ExtendedDynamicStateSupport support;
+
+#ifdef VK_EXT_extended_dynamic_state
+  support.state1 = state1_features.extendedDynamicState == VK_TRUE;
+#endif  // VK_EXT_extended_dynamic_state
+
+#ifdef VK_EXT_extended_dynamic_state2
+  support.state2 = state2_features.extendedDynamicState2 == VK_TRUE &&  //
+                   state2_features.extendedDynamicState2LogicOp == VK_TRUE;
+#endif  // VK_EXT_extended_dynamic_state2
+
+#ifdef VK_EXT_extended_dynamic_state3
+  support.state3 =
+      state3_features.extendedDynamicState3PolygonMode == VK_TRUE &&       //
+      state3_features.extendedDynamicState3DepthClampEnable == VK_TRUE &&  //
+      state3_features.extendedDynamicState3LogicOpEnable == VK_TRUE;
+#endif  // VK_EXT_extended_dynamic_state3
+
+  return support;
+}
+
+auto get_extended_dynamic_state_functions([[maybe_unused]] VkDevice device)
+    -> ExtendedDynamicStateFunctions
+{
+  ExtendedDynamicStateFunctions functions;
+
+#ifdef VK_EXT_extended_dynamic_state
+  functions.vkCmdSetCullModeEXT =
+      get_function<PFN_vkCmdSetCullModeEXT>(device, "vkCmdSetCullModeEXT");
+  functions.vkCmdSetFrontFaceEXT =
+      get_function<PFN_vkCmdSetFrontFaceEXT>(device, "vkCmdSetFrontFaceEXT");
+  functions.vkCmdSetPrimitiveTopologyEXT =
+      get_function<PFN_vkCmdSetPrimitiveTopologyEXT>(device,
+                                                     "vkCmdSetPrimitiveTopologyEXT");
+  functions.vkCmdSetDepthTestEnableEXT =
+      get_function<PFN_vkCmdSetDepthTestEnableEXT>(device, "vkCmdSetDepthTestEnableEXT");
+  functions.vkCmdSetDepthWriteEnableEXT =
+      get_function<PFN_vkCmdSetDepthWriteEnableEXT>(device,
+                                                    "vkCmdSetDepthWriteEnableEXT");
+  functions.vkCmdSetDepthCompareOpEXT =
+      get_function<PFN_vkCmdSetDepthCompareOpEXT>(device, "vkCmdSetDepthCompareOpEXT");
+  functions.vkCmdSetDepthBoundsTestEnableEXT =
+      get_function<PFN_vkCmdSetDepthBoundsTestEnableEXT>(
+          device,
+          "vkCmdSetDepthBoundsTestEnableEXT");
+  functions.vkCmdSetStencilTestEnableEXT =
+      get_function<PFN_vkCmdSetStencilTestEnableEXT>(device,
+                                                     "vkCmdSetStencilTestEnableEXT");
+  functions.vkCmdSetStencilOpEXT =
+      get_function<PFN_vkCmdSetStencilOpEXT>(device, "vkCmdSetStencilOpEXT");
+#endif  // VK_EXT_extended_dynamic_state
+
+#ifdef VK_EXT_extended_dynamic_state2
+  functions.vkCmdSetDepthBiasEnableEXT =
+      get_function<PFN_vkCmdSetDepthBiasEnableEXT>(device, "vkCmdSetDepthBiasEnableEXT");
+  functions.vkCmdSetPrimitiveRestartEnableEXT =
+      get_function<PFN_vkCmdSetPrimitiveRestartEnableEXT>(
+          device,
+          "vkCmdSetPrimitiveRestartEnableEXT");
+  functions.vkCmdSetRasterizerDiscardEnableEXT =
+      get_function<PFN_vkCmdSetRasterizerDiscardEnableEXT>(
+          device,
+          "vkCmdSetRasterizerDiscardEnableEXT");
+  functions.vkCmdSetLogicOpEXT =
+      get_function<PFN_vkCmdSetLogicOpEXT>(device, "vkCmdSetLogicOpEXT");
+#endif  // VK_EXT_extended_dynamic_state2
+
+#ifdef VK_EXT_extended_dynamic_state3
+  functions.vkCmdSetPolygonModeEXT =
+      get_function<PFN_vkCmdSetPolygonModeEXT>(device, "vkCmdSetPolygonModeEXT");
+  functions.vkCmdSetDepthClampEnableEXT =
+      get_function<PFN_vkCmdSetDepthClampEnableEXT>(device,
+                                                    "vkCmdSetDepthClampEnableEXT");
+  functions.vkCmdSetLogicOpEnableEXT =
+      get_function<PFN_vkCmdSetLogicOpEnableEXT>(device, "vkCmdSetLogicOpEnableEXT");
+#endif  // VK_EXT_extended_dynamic_state3
+
+  return functions;
+}
+
+#ifdef VK_EXT_extended_dynamic_state
+
+void cmd_set_primitive_topology(const ExtendedDynamicStateFunctions& functions,
+                                VkCommandBuffer cmd_buf,
+                                const VkPrimitiveTopology topology)
+{
+  functions.vkCmdSetPrimitiveTopologyEXT(cmd_buf, topology);
+}
+
+void cmd_set_cull_mode(const ExtendedDynamicStateFunctions& functions,
+                       VkCommandBuffer cmd_buf,
+                       const VkCullModeFlags cull_mode,
+                       const VkFrontFace front_face)
+{
+  functions.vkCmdSetCullModeEXT(cmd_buf, cull_mode);
+  functions.vkCmdSetFrontFaceEXT(cmd_buf, front_face);
+}
+
+void cmd_set_depth_test(const ExtendedDynamicStateFunctions& functions,
+                        VkCommandBuffer cmd_buf,
+                        const bool test_enabled,
+                        const bool write_enabled,
+                        const VkCompareOp compare_op)
+{
+  functions.vkCmdSetDepthTestEnableEXT(cmd_buf, to_bool32(test_enabled));
+  functions.vkCmdSetDepthWriteEnableEXT(cmd_buf, to_bool32(write_enabled));
+  functions.vkCmdSetDepthCompareOpEXT(cmd_buf, compare_op);
+}
+
+void cmd_set_depth_bounds_test(const ExtendedDynamicStateFunctions& functions,
+                               VkCommandBuffer cmd_buf,
+                               const bool enabled)
+{
+  functions.vkCmdSetDepthBoundsTestEnableEXT(cmd_buf, to_bool32(enabled));
+}
+
+void cmd_set_stencil_test(const ExtendedDynamicStateFunctions& functions,
+                          VkCommandBuffer cmd_buf,
+                          const bool enabled,
+                          const VkStencilOpState& front,
+                          const VkStencilOpState& back)
+{
+  functions.vkCmdSetStencilTestEnableEXT(cmd_buf, to_bool32(enabled));
+  functions.vkCmdSetStencilOpEXT(cmd_buf,
+                                 VK_STENCIL_FACE_FRONT_BIT,
+                                 front.failOp,
+                                 front.passOp,
+                                 front.depthFailOp,
+                                 front.compareOp);
+  functions.vkCmdSetStencilOpEXT(cmd_buf,
+                                 VK_STENCIL_FACE_BACK_BIT,
+                                 back.failOp,
+                                 back.passOp,
+                                 back.depthFailOp,
+                                 back.compareOp);
+}
+
+#endif  // VK_EXT_extended_dynamic_state
+
+#ifdef VK_EXT_extended_dynamic_state2
+
+void cmd_set_depth_bias_enable(const ExtendedDynamicStateFunctions& functions,
+                               VkCommandBuffer cmd_buf,
+                               const bool enabled)
+{
+  functions.vkCmdSetDepthBiasEnableEXT(cmd_buf, to_bool32(enabled));
+}
+
+void cmd_set_primitive_restart_enable(const ExtendedDynamicStateFunctions& functions,
+                                      VkCommandBuffer cmd_buf,
+                                      const bool enabled)
+{
+  functions.vkCmdSetPrimitiveRestartEnableEXT(cmd_buf, to_bool32(enabled));
+}
+
+void cmd_set_rasterizer_discard_enable(const ExtendedDynamicStateFunctions& functions,
+                                       VkCommandBuffer cmd_buf,
+                                       const bool enabled)
+{
+  functions.vkCmdSetRasterizerDiscardEnableEXT(cmd_buf, to_bool32(enabled));
+}
+
+void cmd_set_logic_op(const ExtendedDynamicStateFunctions& functions,
+                      VkCommandBuffer cmd_buf,
+                      const VkLogicOp logic_op)
+{
+  functions.vkCmdSetLogicOpEXT(cmd_buf, logic_op);
+}
+
+#endif  // VK_EXT_extended_dynamic_state2
+
+#ifdef VK_EXT_extended_dynamic_state3
+
+void cmd_set_polygon_mode(const ExtendedDynamicStateFunctions& functions,
+                          VkCommandBuffer cmd_buf,
+                          const VkPolygonMode polygon_mode)
+{
+  functions.vkCmdSetPolygonModeEXT(cmd_buf, polygon_mode);
+}
+
+void cmd_set_depth_clamp_enable(const ExtendedDynamicStateFunctions& functions,
+                                VkCommandBuffer cmd_buf,
+                                const bool enabled)
+{
+  functions.vkCmdSetDepthClampEnableEXT(cmd_buf, to_bool32(enabled));
+}
+
+void cmd_set_logic_op_enable(const ExtendedDynamicStateFunctions& functions,
+                             VkCommandBuffer cmd_buf,
+                             const bool enabled)
+{
+  functions.vkCmdSetLogicOpEnableEXT(cmd_buf, to_bool32(enabled));
+}
+
+#endif  // VK_EXT_extended_dynamic_state3
+
+}  // namespace grace
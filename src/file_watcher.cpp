@@ -0,0 +1,165 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/file_watcher.hpp"
+
+#include <algorithm>     // find
+#include <array>         // array
+#include <cstring>       // memcpy
+#include <system_error>  // error_code
+#include <utility>       // move
+
+#ifdef __linux__
+#include <sys/inotify.h>  // inotify_init1, inotify_add_watch, inotify_event, IN_*
+#include <unistd.h>       // read, close
+#endif  // __linux__
+
+namespace grace {
+namespace {
+
+[[nodiscard]] auto get_modification_time(const std::filesystem::path& path)
+    -> std::filesystem::file_time_type
+{
+  std::error_code error;
+  const auto time = std::filesystem::last_write_time(path, error);
+  return !error ? time : std::filesystem::file_time_type::min();
+}
+
+}  // namespace
+
+auto normalize_file_path(const std::filesystem::path& path) -> std::filesystem::path
+{
+  std::error_code error;
+  const auto absolute_path = std::filesystem::absolute(path, error);
+  return (!error ? absolute_path : path).lexically_normal();
+}
+
+FileWatcher::FileWatcher()
+{
+#ifdef __linux__
+  mInotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif  // __linux__
+}
+
+FileWatcher::~FileWatcher() noexcept
+{
+#ifdef __linux__
+  if (mInotify != -1) {
+    close(mInotify);
+  }
+#endif  // __linux__
+}
+
+auto FileWatcher::watch(const std::filesystem::path& path) -> bool
+{
+  const auto file_path = normalize_file_path(path);
+  const auto key = file_path.string();
+
+  if (mFiles.contains(key)) {
+    return true;
+  }
+
+#ifdef __linux__
+  if (mInotify != -1) {
+    const auto directory = file_path.parent_path();
+
+    // Directories may be shared by many watched files, but are only watched once
+    const auto watch = inotify_add_watch(mInotify,
+                                         directory.c_str(),
+                                         IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (watch == -1) {
+      return false;
+    }
+
+    mDirectories.try_emplace(watch, directory);
+  }
+#endif  // __linux__
+
+  mFiles.try_emplace(key, get_modification_time(file_path));
+  return true;
+}
+
+auto FileWatcher::poll() -> std::vector<std::filesystem::path>
+{
+  return is_polling() ? _poll_modification_times() : _poll_inotify();
+}
+
+auto FileWatcher::_poll_inotify() -> std::vector<std::filesystem::path>
+{
+  std::vector<std::filesystem::path> modified_files;
+
+#ifdef __linux__
+  alignas(inotify_event) std::array<char, 4096> buffer;
+
+  while (true) {
+    const auto byte_count = read(mInotify, buffer.data(), buffer.size());
+    if (byte_count <= 0) {
+      break;  // No more pending events
+    }
+
+    usize offset = 0;
+    while (offset + sizeof(inotify_event) <= static_cast<usize>(byte_count)) {
+      inotify_event event;
+      std::memcpy(&event, buffer.data() + offset, sizeof event);
+
+      const char* name = buffer.data() + offset + sizeof(inotify_event);
+      offset += sizeof(inotify_event) + event.len;
+
+      const auto directory = mDirectories.find(event.wd);
+      if (event.len == 0 || directory == mDirectories.end()) {
+        continue;
+      }
+
+      auto file_path = directory->second / name;
+
+      // Events for unrelated files in the watched directories are ignored
+      if (mFiles.contains(file_path.string()) &&
+          std::find(modified_files.begin(), modified_files.end(), file_path) ==
+              modified_files.end()) {
+        modified_files.push_back(std::move(file_path));
+      }
+    }
+  }
+#endif  // __linux__
+
+  return modified_files;
+}
+
+auto FileWatcher::_poll_modification_times() -> std::vector<std::filesystem::path>
+{
+  std::vector<std::filesystem::path> modified_files;
+
+  for (auto& [path, time] : mFiles) {
+    const auto current_time = get_modification_time(path);
+
+    if (current_time != time) {
+      time = current_time;
+      modified_files.emplace_back(path);
+    }
+  }
+
+  return modified_files;
+}
+
+}  // namespace grace
@@ -27,15 +27,30 @@
 #include <algorithm>      // max
 #include <cassert>        // assert
 #include <cmath>          // floor, log2
+#include <cstddef>        // byte
+#include <cstring>        // memcpy
+#include <numeric>        // lcm
 #include <unordered_map>  // unordered_map
+#include <utility>        // move
+#include <vector>         // vector
 
 #include "grace/allocator.hpp"
 #include "grace/buffer.hpp"
 #include "grace/command_pool.hpp"
+#include "grace/device.hpp"
 
 namespace grace {
 namespace {
 
+// The alignment of region data in staging buffers when the texel size is unknown, which
+// is a multiple of the block sizes of all compressed formats.
+inline constexpr uint64 kFallbackRegionDataAlignment = 16;
+
+// The image usage flags that are considered to be attachment usage flags.
+inline constexpr VkImageUsageFlags kAttachmentUsageFlags =
+    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+    VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+
 // Used to determine access flags for layout transitions.
 const std::unordered_map<VkImageLayout, VkAccessFlags> kTransitionAccessMap {
     {VK_IMAGE_LAYOUT_UNDEFINED, 0},
@@ -56,6 +71,67 @@ const std::unordered_map<VkImageLayout, VkPipelineStageFlags> kTransitionStageMa
      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT},
 };
 
+// Buffer offsets of copies must be multiples of the texel size, and of 4 bytes for
+// depth/stencil formats, so offsets of e.g. 12-byte texels aren't 16-byte aligned.
+[[nodiscard]] constexpr auto get_region_data_alignment(const uint32 texel_size) -> uint64
+{
+  return (texel_size != 0) ? std::lcm(uint64 {texel_size}, uint64 {4})
+                           : kFallbackRegionDataAlignment;
+}
+
+[[nodiscard]] constexpr auto align_region_data_offset(const uint64 offset,
+                                                      const uint64 alignment) -> uint64
+{
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+[[nodiscard]] auto is_region_in_bounds(const ImageRegion& region, const ImageInfo& info)
+    -> bool
+{
+  if (region.mip_level >= info.mip_levels || region.array_layer >= info.array_layers) {
+    return false;
+  }
+
+  const auto& offset = region.offset;
+  if (offset.x < 0 || offset.y < 0 || offset.z < 0) {
+    return false;
+  }
+
+  // The extent of each mipmap level is halved, but never less than one texel
+  const auto is_within = [&](const int32 begin, const uint32 size, const uint32 limit) {
+    const auto level_limit = std::max(limit >> region.mip_level, uint32 {1});
+    return uint64 {static_cast<uint32>(begin)} + uint64 {size} <= uint64 {level_limit};
+  };
+
+  return is_within(offset.x, region.extent.width, info.extent.width) &&
+         is_within(offset.y, region.extent.height, info.extent.height) &&
+         is_within(offset.z, region.extent.depth, info.extent.depth);
+}
+
+[[nodiscard]] auto is_region_data_valid(const ImageRegion& region,
+                                        const uint32 texel_size) -> bool
+{
+  const auto& extent = region.extent;
+  if (!region.data || extent.width == 0 || extent.height == 0 || extent.depth == 0) {
+    return false;
+  }
+
+  if (region.row_pitch != 0 && region.row_pitch < extent.width) {
+    return false;
+  }
+
+  if (texel_size == 0) {
+    return true;
+  }
+
+  // The last row doesn't need any padding up to the row pitch
+  const uint64 row_length = (region.row_pitch != 0) ? region.row_pitch : extent.width;
+  const uint64 row_count = uint64 {extent.height} * uint64 {extent.depth};
+  const uint64 texel_count = (row_count - 1) * row_length + extent.width;
+
+  return region.data_size >= texel_count * texel_size;
+}
+
 }  // namespace
 
 auto make_image_info(const VkImageType type,
@@ -84,18 +160,132 @@ auto make_image_info(const VkImageType type,
   };
 }
 
+auto is_attachment_only_usage(const VkImageUsageFlags usage) -> bool
+{
+  return usage != 0 && (usage & ~kAttachmentUsageFlags) == 0;
+}
+
 auto get_max_image_mip_levels(const VkExtent3D extent) -> uint32
 {
   const auto max_extent = std::max(extent.width, extent.height);
   return 1 + static_cast<uint32>(std::floor(std::log2(max_extent)));
 }
 
+auto get_format_texel_size(const VkFormat format) noexcept -> uint32
+{
+  switch (format) {
+    case VK_FORMAT_R8_UNORM:
+    case VK_FORMAT_R8_SNORM:
+    case VK_FORMAT_R8_UINT:
+    case VK_FORMAT_R8_SINT:
+    case VK_FORMAT_R8_SRGB:
+    case VK_FORMAT_S8_UINT:
+      return 1;
+
+    case VK_FORMAT_R8G8_UNORM:
+    case VK_FORMAT_R8G8_SNORM:
+    case VK_FORMAT_R8G8_UINT:
+    case VK_FORMAT_R8G8_SINT:
+    case VK_FORMAT_R8G8_SRGB:
+    case VK_FORMAT_R16_UNORM:
+    case VK_FORMAT_R16_SNORM:
+    case VK_FORMAT_R16_UINT:
+    case VK_FORMAT_R16_SINT:
+    case VK_FORMAT_R16_SFLOAT:
+    case VK_FORMAT_D16_UNORM:
+    case VK_FORMAT_R5G6B5_UNORM_PACK16:
+    case VK_FORMAT_B5G6R5_UNORM_PACK16:
+      return 2;
+
+    case VK_FORMAT_R8G8B8_UNORM:
+    case VK_FORMAT_R8G8B8_SRGB:
+    case VK_FORMAT_B8G8R8_UNORM:
+    case VK_FORMAT_B8G8R8_SRGB:
+      return 3;
+
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SNORM:
+    case VK_FORMAT_R8G8B8A8_UINT:
+    case VK_FORMAT_R8G8B8A8_SINT:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+    case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+    case VK_FORMAT_A2R10G10B10_UNORM_PACK32:
+    case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
+    case VK_FORMAT_E5B9G9R9_UFLOAT_PACK32:
+    case VK_FORMAT_R16G16_UNORM:
+    case VK_FORMAT_R16G16_SNORM:
+    case VK_FORMAT_R16G16_UINT:
+    case VK_FORMAT_R16G16_SINT:
+    case VK_FORMAT_R16G16_SFLOAT:
+    case VK_FORMAT_R32_UINT:
+    case VK_FORMAT_R32_SINT:
+    case VK_FORMAT_R32_SFLOAT:
+    case VK_FORMAT_D32_SFLOAT:
+    case VK_FORMAT_X8_D24_UNORM_PACK32:
+      return 4;
+
+    case VK_FORMAT_R16G16B16_SFLOAT:
+      return 6;
+
+    case VK_FORMAT_R16G16B16A16_UNORM:
+    case VK_FORMAT_R16G16B16A16_SNORM:
+    case VK_FORMAT_R16G16B16A16_UINT:
+    case VK_FORMAT_R16G16B16A16_SINT:
+    case VK_FORMAT_R16G16B16A16_SFLOAT:
+    case VK_FORMAT_R32G32_UINT:
+    case VK_FORMAT_R32G32_SINT:
+    case VK_FORMAT_R32G32_SFLOAT:
+      return 8;
+
+    case VK_FORMAT_R32G32B32_UINT:
+    case VK_FORMAT_R32G32B32_SINT:
+    case VK_FORMAT_R32G32B32_SFLOAT:
+      return 12;
+
+    case VK_FORMAT_R32G32B32A32_UINT:
+    case VK_FORMAT_R32G32B32A32_SINT:
+    case VK_FORMAT_R32G32B32A32_SFLOAT:
+      return 16;
+
+    default:
+      return 0;
+  }
+}
+
+auto make_buffer_image_copy(const uint64 buffer_offset,
+                            const VkOffset3D& image_offset,
+                            const VkExtent3D& image_extent,
+                            const uint32 row_pitch,
+                            const uint32 mip_level,
+                            const uint32 array_layer,
+                            const VkImageAspectFlags aspects) -> VkBufferImageCopy
+{
+  return {
+      .bufferOffset = buffer_offset,
+      .bufferRowLength = row_pitch,
+      .bufferImageHeight = 0,
+      .imageSubresource =
+          {
+              .aspectMask = aspects,
+              .mipLevel = mip_level,
+              .baseArrayLayer = array_layer,
+              .layerCount = 1,
+          },
+      .imageOffset = image_offset,
+      .imageExtent = image_extent,
+  };
+}
+
 void cmd_change_image_layout(VkCommandBuffer cmd_buf,
                              VkImage image,
                              const VkImageLayout old_layout,
                              const VkImageLayout new_layout,
                              const uint32 base_mip_level,
-                             const uint32 mip_level_count)
+                             const uint32 mip_level_count,
+                             const uint32 base_array_layer,
+                             const uint32 array_layer_count)
 {
   assert(kTransitionAccessMap.contains(old_layout));
   assert(kTransitionAccessMap.contains(new_layout));
@@ -122,8 +312,8 @@ void cmd_change_image_layout(VkCommandBuffer cmd_buf,
               .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
               .baseMipLevel = base_mip_level,
               .levelCount = mip_level_count,
-              .baseArrayLayer = 0,
-              .layerCount = 1,
+              .baseArrayLayer = base_array_layer,
+              .layerCount = array_layer_count,
           },
   };
 
@@ -145,21 +335,51 @@ void cmd_copy_buffer_to_image(VkCommandBuffer cmd_buf,
                               const VkExtent3D& image_extent,
                               const VkImageLayout image_layout)
 {
-  VkBufferImageCopy region = {};
+  const auto region = make_buffer_image_copy(0, {0, 0, 0}, image_extent);
+  cmd_copy_buffer_to_image(cmd_buf, buffer, image, image_layout, &region, 1);
+}
 
-  region.bufferOffset = 0;
-  region.bufferRowLength = 0;
-  region.bufferImageHeight = 0;
-  region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-  region.imageSubresource.mipLevel = 0;
-  region.imageSubresource.baseArrayLayer = 0;
-  region.imageSubresource.layerCount = 1;
-  region.imageOffset = {0, 0, 0};
-  region.imageExtent = image_extent;
+void cmd_copy_buffer_to_image(VkCommandBuffer cmd_buf,
+                              VkBuffer buffer,
+                              VkImage image,
+                              const VkImageLayout image_layout,
+                              const VkBufferImageCopy* regions,
+                              const uint32 region_count)
+{
+  vkCmdCopyBufferToImage(cmd_buf, buffer, image, image_layout, region_count, regions);
+}
 
-  vkCmdCopyBufferToImage(cmd_buf, buffer, image, image_layout, 1, &region);
+#ifdef VK_EXT_host_image_copy
+
+auto get_host_image_copy_functions(VkDevice device) -> HostImageCopyFunctions
+{
+  HostImageCopyFunctions functions;
+
+  functions.vkCopyMemoryToImageEXT =
+      get_function<PFN_vkCopyMemoryToImageEXT>(device, "vkCopyMemoryToImageEXT");
+  functions.vkTransitionImageLayoutEXT =
+      get_function<PFN_vkTransitionImageLayoutEXT>(device, "vkTransitionImageLayoutEXT");
+
+  return functions;
+}
+
+auto is_host_image_copy_supported(VkPhysicalDevice gpu) -> bool
+{
+  VkPhysicalDeviceHostImageCopyFeaturesEXT host_image_copy_features = {};
+  host_image_copy_features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT;
+
+  VkPhysicalDeviceFeatures2 features = {};
+  features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+  features.pNext = &host_image_copy_features;
+
+  vkGetPhysicalDeviceFeatures2(gpu, &features);
+
+  return host_image_copy_features.hostImageCopy == VK_TRUE;
 }
 
+#endif  // VK_EXT_host_image_copy
+
 void ImageInfo::copy_from(const VkImageCreateInfo& image_info)
 {
   extent = image_info.extent;
@@ -167,13 +387,15 @@ void ImageInfo::copy_from(const VkImageCreateInfo& image_info)
   format = image_info.format;
   samples = image_info.samples;
   mip_levels = image_info.mipLevels;
+  array_layers = image_info.arrayLayers;
 }
 
 Image::Image(Image&& other) noexcept
     : mAllocator {other.mAllocator},
       mImage {other.mImage},
       mAllocation {other.mAllocation},
-      mInfo {other.mInfo}
+      mInfo {other.mInfo},
+      mViews {std::move(other.mViews)}
 {
   other.mAllocator = VK_NULL_HANDLE;
   other.mImage = VK_NULL_HANDLE;
@@ -189,6 +411,7 @@ auto Image::operator=(Image&& other) noexcept -> Image&
     mImage = other.mImage;
     mAllocation = other.mAllocation;
     mInfo = other.mInfo;
+    mViews = std::move(other.mViews);
 
     other.mAllocator = VK_NULL_HANDLE;
     other.mImage = VK_NULL_HANDLE;
@@ -206,6 +429,7 @@ Image::~Image() noexcept
 void Image::destroy() noexcept
 {
   if (mImage != VK_NULL_HANDLE) {
+    mViews.clear();
     vmaDestroyImage(mAllocator, mImage, mAllocation);
     mImage = VK_NULL_HANDLE;
   }
@@ -256,6 +480,37 @@ auto Image::make(VmaAllocator allocator,
   return make(allocator, image_info, allocation_info, result);
 }
 
+auto Image::make_transient(VmaAllocator allocator,
+                           const VkExtent3D& extent,
+                           const VkFormat format,
+                           const VkImageUsageFlags usage,
+                           const VkSampleCountFlagBits samples,
+                           VkResult* result) -> Image
+{
+  assert(is_attachment_only_usage(usage));
+
+  auto image_info = make_image_info(VK_IMAGE_TYPE_2D, extent, format, usage, 1, samples);
+
+  // Transient attachments can't have any usage besides attachment usage
+  image_info.usage = usage | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+
+  const auto lazy_allocation_info =
+      make_allocation_info(VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT,
+                           0,
+                           0,
+                           VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED);
+  if (auto image = make(allocator, image_info, lazy_allocation_info, result)) {
+    return image;
+  }
+
+  // Not all devices provide lazily allocated memory, e.g. most desktop GPUs
+  const auto allocation_info = make_allocation_info(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                                    0,
+                                                    0,
+                                                    VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+  return make(allocator, image_info, allocation_info, result);
+}
+
 auto Image::set_data(const CommandContext& ctx,
                      VmaAllocator allocator,
                      const void* data,
@@ -273,110 +528,383 @@ auto Image::set_data(const CommandContext& ctx,
     return result;
   }
 
-  // Optimize layout for the buffer transfer, and copy data from staging buffer.
-  change_layout(ctx, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-  copy_buffer(ctx, staging_buffer.get());
+  return _upload_staging_buffer(ctx, staging_buffer.get());
+}
+
+auto Image::set_data(const CommandContext& ctx,
+                     VmaAllocator allocator,
+                     const void* data,
+                     const uint64 texel_count,
+                     const PixelConversion conversion) -> VkResult
+{
+  if (!is_conversion_target(conversion, mInfo.format)) {
+    return VK_ERROR_FORMAT_NOT_SUPPORTED;
+  }
+
+  const auto expected_texel_count = static_cast<uint64>(mInfo.extent.width) *
+                                    static_cast<uint64>(mInfo.extent.height) *
+                                    static_cast<uint64>(mInfo.extent.depth);
+  if (texel_count != expected_texel_count) {
+    return VK_ERROR_VALIDATION_FAILED_EXT;
+  }
+
+  VkResult result = VK_SUCCESS;
+
+  const auto staging_size = texel_count * get_target_texel_size(conversion);
+
+  auto staging_buffer = Buffer::for_staging(allocator, staging_size, 0, &result);
+  if (!staging_buffer) {
+    return result;
+  }
+
+  void* mapped_data = staging_buffer.map(&result);
+  if (!mapped_data) {
+    return result;
+  }
+
+  convert_pixels(conversion, data, mapped_data, texel_count);
+  staging_buffer.unmap();
 
-  // Generate mipmaps, which will automatically change layout of all image levels
-  generate_mipmaps(ctx);
+  return _upload_staging_buffer(ctx, staging_buffer.get());
+}
 
-  assert(mInfo.layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+auto Image::_upload_staging_buffer(const CommandContext& ctx, VkBuffer staging_buffer)
+    -> VkResult
+{
+  // Records the copy and mipmap generation into a single submission
+  const auto result = execute_now(ctx, [this, staging_buffer](VkCommandBuffer cmd_buf) {
+    // Optimize layout for the buffer transfer, and copy data from staging buffer.
+    cmd_change_layout(cmd_buf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    cmd_copy_buffer(cmd_buf, staging_buffer);
+
+    // Generate mipmaps, which will automatically change layout of all image levels
+    cmd_generate_mipmaps(cmd_buf);
+  });
+
+  assert(result != VK_SUCCESS ||
+         mInfo.layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
   return result;
 }
 
-void Image::change_layout(const CommandContext& ctx, const VkImageLayout new_layout)
+auto Image::update_region(const CommandContext& ctx,
+                          VmaAllocator allocator,
+                          const void* data,
+                          const uint64 data_size,
+                          const VkOffset3D& offset,
+                          const VkExtent3D& extent,
+                          const uint32 row_pitch,
+                          const uint32 mip_level,
+                          const uint32 array_layer) -> VkResult
 {
-  execute_now(ctx, [this, new_layout](VkCommandBuffer cmd_buf) {
+  const std::vector regions = {ImageRegion {
+      .data = data,
+      .data_size = data_size,
+      .offset = offset,
+      .extent = extent,
+      .row_pitch = row_pitch,
+      .mip_level = mip_level,
+      .array_layer = array_layer,
+  }};
+
+  return update_regions(ctx, allocator, regions);
+}
+
+auto Image::update_regions(const CommandContext& ctx,
+                           VmaAllocator allocator,
+                           const std::vector<ImageRegion>& regions) -> VkResult
+{
+  if (regions.empty()) {
+    return VK_SUCCESS;
+  }
+
+  const auto texel_size = get_format_texel_size(mInfo.format);
+  const auto alignment = get_region_data_alignment(texel_size);
+
+  std::vector<VkBufferImageCopy> copy_regions;
+  copy_regions.reserve(regions.size());
+
+  // Determine where the data of each region will be stored in the staging buffer.
+  uint64 staging_buffer_size = 0;
+  for (const auto& region : regions) {
+    if (!is_region_in_bounds(region, mInfo) ||
+        !is_region_data_valid(region, texel_size)) {
+      return VK_ERROR_VALIDATION_FAILED_EXT;
+    }
+
+    copy_regions.push_back(make_buffer_image_copy(staging_buffer_size,
+                                                  region.offset,
+                                                  region.extent,
+                                                  region.row_pitch,
+                                                  region.mip_level,
+                                                  region.array_layer));
+    staging_buffer_size =
+        align_region_data_offset(staging_buffer_size + region.data_size, alignment);
+  }
+
+  VkResult result = VK_SUCCESS;
+
+  auto staging_buffer = Buffer::for_staging(allocator, staging_buffer_size, 0, &result);
+  if (!staging_buffer) {
+    return result;
+  }
+
+  auto* mapped_data = static_cast<std::byte*>(staging_buffer.map(&result));
+  if (!mapped_data) {
+    return result;
+  }
+
+  for (usize index = 0; index < regions.size(); ++index) {
+    const auto& region = regions[index];
+    std::memcpy(mapped_data + copy_regions[index].bufferOffset,
+                region.data,
+                region.data_size);
+  }
+
+  staging_buffer.unmap();
+
+  // Restore the previous layout afterwards, unless it was undefined.
+  const auto final_layout = (mInfo.layout != VK_IMAGE_LAYOUT_UNDEFINED)
+                                ? mInfo.layout
+                                : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+  return execute_now(ctx, [&, this](VkCommandBuffer cmd_buf) {
     cmd_change_image_layout(cmd_buf,
                             mImage,
                             mInfo.layout,
-                            new_layout,
+                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                            0,
+                            mInfo.mip_levels,
+                            0,
+                            mInfo.array_layers);
+
+    cmd_copy_buffer_to_image(cmd_buf,
+                             staging_buffer.get(),
+                             mImage,
+                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                             copy_regions.data(),
+                             u32_size(copy_regions));
+
+    cmd_change_image_layout(cmd_buf,
+                            mImage,
+                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                            final_layout,
+                            0,
+                            mInfo.mip_levels,
                             0,
-                            mInfo.mip_levels);
-    mInfo.layout = new_layout;
+                            mInfo.array_layers);
+
+    mInfo.layout = final_layout;
+  });
+}
+
+#ifdef VK_EXT_host_image_copy
+
+auto Image::host_copy(const HostImageCopyFunctions& functions,
+                      const void* data,
+                      const VkImageLayout layout) -> VkResult
+{
+  const std::vector regions = {ImageRegion {
+      .data = data,
+      .data_size = 0,  // Unused by host copies
+      .offset = {0, 0, 0},
+      .extent = mInfo.extent,
+      .row_pitch = 0,
+      .mip_level = 0,
+      .array_layer = 0,
+  }};
+
+  return host_copy(functions, regions, layout);
+}
+
+auto Image::host_copy(const HostImageCopyFunctions& functions,
+                      const std::vector<ImageRegion>& regions,
+                      const VkImageLayout layout) -> VkResult
+{
+  if (!functions.vkCopyMemoryToImageEXT || !functions.vkTransitionImageLayoutEXT) {
+    return VK_ERROR_EXTENSION_NOT_PRESENT;
+  }
+
+  VmaAllocatorInfo allocator_info = {};
+  vmaGetAllocatorInfo(mAllocator, &allocator_info);
+
+  VkDevice device = allocator_info.device;
+
+  if (mInfo.layout != layout) {
+    const VkHostImageLayoutTransitionInfoEXT transition_info = {
+        .sType = VK_STRUCTURE_TYPE_HOST_IMAGE_LAYOUT_TRANSITION_INFO_EXT,
+        .pNext = nullptr,
+        .image = mImage,
+        .oldLayout = mInfo.layout,
+        .newLayout = layout,
+        .subresourceRange = make_image_subresource_range(VK_IMAGE_ASPECT_COLOR_BIT,
+                                                         0,
+                                                         mInfo.mip_levels,
+                                                         0,
+                                                         mInfo.array_layers),
+    };
+
+    const auto result = functions.vkTransitionImageLayoutEXT(device, 1, &transition_info);
+    if (result != VK_SUCCESS) {
+      return result;
+    }
+
+    mInfo.layout = layout;
+  }
+
+  std::vector<VkMemoryToImageCopyEXT> copy_regions;
+  copy_regions.reserve(regions.size());
+
+  for (const auto& region : regions) {
+    copy_regions.push_back(VkMemoryToImageCopyEXT {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_TO_IMAGE_COPY_EXT,
+        .pNext = nullptr,
+        .pHostPointer = region.data,
+        .memoryRowLength = region.row_pitch,
+        .memoryImageHeight = 0,
+        .imageSubresource =
+            {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = region.mip_level,
+                .baseArrayLayer = region.array_layer,
+                .layerCount = 1,
+            },
+        .imageOffset = region.offset,
+        .imageExtent = region.extent,
+    });
+  }
+
+  const VkCopyMemoryToImageInfoEXT copy_info = {
+      .sType = VK_STRUCTURE_TYPE_COPY_MEMORY_TO_IMAGE_INFO_EXT,
+      .pNext = nullptr,
+      .flags = 0,
+      .dstImage = mImage,
+      .dstImageLayout = layout,
+      .regionCount = u32_size(copy_regions),
+      .pRegions = data_or_null(copy_regions),
+  };
+
+  return functions.vkCopyMemoryToImageEXT(device, &copy_info);
+}
+
+#endif  // VK_EXT_host_image_copy
+
+void Image::change_layout(const CommandContext& ctx, const VkImageLayout new_layout)
+{
+  execute_now(ctx, [this, new_layout](VkCommandBuffer cmd_buf) {
+    cmd_change_layout(cmd_buf, new_layout);
   });
 }
 
 void Image::copy_buffer(const CommandContext& ctx, VkBuffer buffer)
 {
   execute_now(ctx, [this, buffer](VkCommandBuffer cmd_buf) {
-    cmd_copy_buffer_to_image(cmd_buf, buffer, mImage, mInfo.extent, mInfo.layout);
+    cmd_copy_buffer(cmd_buf, buffer);
   });
 }
 
 void Image::generate_mipmaps(const CommandContext& ctx)
+{
+  execute_now(ctx, [this](VkCommandBuffer cmd_buf) { cmd_generate_mipmaps(cmd_buf); });
+}
+
+void Image::cmd_change_layout(VkCommandBuffer cmd_buf, const VkImageLayout new_layout)
+{
+  cmd_change_image_layout(cmd_buf, mImage, mInfo.layout, new_layout, 0, mInfo.mip_levels);
+  mInfo.layout = new_layout;
+}
+
+void Image::cmd_copy_buffer(VkCommandBuffer cmd_buf, VkBuffer buffer)
+{
+  cmd_copy_buffer_to_image(cmd_buf, buffer, mImage, mInfo.extent, mInfo.layout);
+}
+
+void Image::cmd_generate_mipmaps(VkCommandBuffer cmd_buf)
 {
   assert(mInfo.samples | VK_SAMPLE_COUNT_1_BIT);
   assert(mInfo.layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
-  execute_now(ctx, [this](VkCommandBuffer cmd_buf) {
-    auto mip_width = static_cast<int32>(mInfo.extent.width);
-    auto mip_height = static_cast<int32>(mInfo.extent.height);
-
-    for (uint32 mip_level = 1; mip_level < mInfo.mip_levels; ++mip_level) {
-      const uint32 base_mip_level = mip_level - 1;
-
-      cmd_change_image_layout(cmd_buf,
-                              mImage,
-                              VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                              VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                              base_mip_level,
-                              1);
-
-      VkImageBlit blit {};
-      blit.srcOffsets[0] = {0, 0, 0};
-      blit.srcOffsets[1] = {mip_width, mip_height, 1};
-
-      blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-      blit.srcSubresource.mipLevel = base_mip_level;
-      blit.srcSubresource.baseArrayLayer = 0;
-      blit.srcSubresource.layerCount = 1;
-
-      blit.dstOffsets[0] = {0, 0, 0};
-      blit.dstOffsets[1] = {(mip_width > 1) ? (mip_width / 2) : 1,
-                            (mip_height > 1) ? (mip_height / 2) : 1,
-                            1};
-
-      blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-      blit.dstSubresource.mipLevel = mip_level;
-      blit.dstSubresource.baseArrayLayer = 0;
-      blit.dstSubresource.layerCount = 1;
-
-      vkCmdBlitImage(cmd_buf,
-                     mImage,
-                     VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                     mImage,
-                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                     1,
-                     &blit,
-                     VK_FILTER_LINEAR);
-
-      cmd_change_image_layout(cmd_buf,
-                              mImage,
-                              VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                              VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                              base_mip_level,
-                              1);
-
-      if (mip_width > 1) {
-        mip_width /= 2;
-      }
-
-      if (mip_height > 1) {
-        mip_height /= 2;
-      }
-    }
+  auto mip_width = static_cast<int32>(mInfo.extent.width);
+  auto mip_height = static_cast<int32>(mInfo.extent.height);
+
+  for (uint32 mip_level = 1; mip_level < mInfo.mip_levels; ++mip_level) {
+    const uint32 base_mip_level = mip_level - 1;
 
-    // Transitions the last mipmap image to the optimal shader read layout
     cmd_change_image_layout(cmd_buf,
                             mImage,
                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                            base_mip_level,
+                            1);
+
+    VkImageBlit blit {};
+    blit.srcOffsets[0] = {0, 0, 0};
+    blit.srcOffsets[1] = {mip_width, mip_height, 1};
+
+    blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    blit.srcSubresource.mipLevel = base_mip_level;
+    blit.srcSubresource.baseArrayLayer = 0;
+    blit.srcSubresource.layerCount = 1;
+
+    blit.dstOffsets[0] = {0, 0, 0};
+    blit.dstOffsets[1] = {(mip_width > 1) ? (mip_width / 2) : 1,
+                          (mip_height > 1) ? (mip_height / 2) : 1,
+                          1};
+
+    blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    blit.dstSubresource.mipLevel = mip_level;
+    blit.dstSubresource.baseArrayLayer = 0;
+    blit.dstSubresource.layerCount = 1;
+
+    vkCmdBlitImage(cmd_buf,
+                   mImage,
+                   VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                   mImage,
+                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                   1,
+                   &blit,
+                   VK_FILTER_LINEAR);
+
+    cmd_change_image_layout(cmd_buf,
+                            mImage,
+                            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                            mInfo.mip_levels - 1,
+                            base_mip_level,
                             1);
 
-    mInfo.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-  });
+    if (mip_width > 1) {
+      mip_width /= 2;
+    }
+
+    if (mip_height > 1) {
+      mip_height /= 2;
+    }
+  }
+
+  // Transitions the last mipmap image to the optimal shader read layout
+  cmd_change_image_layout(cmd_buf,
+                          mImage,
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                          mInfo.mip_levels - 1,
+                          1);
+
+  mInfo.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+}
+
+auto Image::get_view(ImageViewKey key, VkResult* result) -> VkImageView
+{
+  if (mViews.image() != mImage) {
+    VmaAllocatorInfo allocator_info = {};
+    vmaGetAllocatorInfo(mAllocator, &allocator_info);
+
+    mViews = ImageViewCache {allocator_info.device, mImage};
+  }
+
+  if (key.format == VK_FORMAT_UNDEFINED) {
+    key.format = mInfo.format;
+  }
+
+  return mViews.get(key, result);
 }
 
 }  // namespace grace
@@ -24,13 +24,30 @@
 
 #include "grace/image_view.hpp"
 
+#include <utility>  // move
+
 namespace grace {
 
+auto make_image_subresource_range(const VkImageAspectFlags aspects,
+                                  const uint32 base_mip_level,
+                                  const uint32 mip_level_count,
+                                  const uint32 base_array_layer,
+                                  const uint32 array_layer_count)
+    -> VkImageSubresourceRange
+{
+  return {
+      .aspectMask = aspects,
+      .baseMipLevel = base_mip_level,
+      .levelCount = mip_level_count,
+      .baseArrayLayer = base_array_layer,
+      .layerCount = array_layer_count,
+  };
+}
+
 auto make_image_view_info(VkImage image,
                           const VkImageViewType type,
                           const VkFormat format,
-                          const VkImageAspectFlags aspects,
-                          const uint32 mip_levels) -> VkImageViewCreateInfo
+                          const VkImageSubresourceRange& range) -> VkImageViewCreateInfo
 {
   return {
       .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
@@ -46,17 +63,20 @@ auto make_image_view_info(VkImage image,
               .b = VK_COMPONENT_SWIZZLE_IDENTITY,
               .a = VK_COMPONENT_SWIZZLE_IDENTITY,
           },
-      .subresourceRange =
-          {
-              .aspectMask = aspects,
-              .baseMipLevel = 0,
-              .levelCount = mip_levels,
-              .baseArrayLayer = 0,
-              .layerCount = 1,
-          },
+      .subresourceRange = range,
   };
 }
 
+auto make_image_view_info(VkImage image,
+                          const VkImageViewType type,
+                          const VkFormat format,
+                          const VkImageAspectFlags aspects,
+                          const uint32 mip_levels) -> VkImageViewCreateInfo
+{
+  const auto range = make_image_subresource_range(aspects, 0, mip_levels);
+  return make_image_view_info(image, type, format, range);
+}
+
 ImageView::ImageView(ImageView&& other) noexcept
     : mDevice {other.mDevice},
       mImageView {other.mImageView}
@@ -124,4 +144,56 @@ auto ImageView::make(VkDevice device,
   return ImageView::make(device, info, result);
 }
 
+auto ImageViewKeyHasher::operator()(const ImageViewKey& key) const noexcept -> usize
+{
+  usize seed = 0;
+
+  hash_combine(seed, key.type);
+  hash_combine(seed, key.format);
+  hash_combine(seed, key.aspects);
+  hash_combine(seed, key.base_mip_level);
+  hash_combine(seed, key.mip_level_count);
+  hash_combine(seed, key.base_array_layer);
+  hash_combine(seed, key.array_layer_count);
+
+  return seed;
+}
+
+ImageViewCache::ImageViewCache(VkDevice device, VkImage image) noexcept
+    : mDevice {device},
+      mImage {image}
+{
+}
+
+void ImageViewCache::clear() noexcept
+{
+  mViews.clear();
+}
+
+auto ImageViewCache::get(const ImageViewKey& key, VkResult* result) -> VkImageView
+{
+  if (const auto iter = mViews.find(key); iter != mViews.end()) {
+    if (result) {
+      *result = VK_SUCCESS;
+    }
+
+    return iter->second.get();
+  }
+
+  const auto range = make_image_subresource_range(key.aspects,
+                                                  key.base_mip_level,
+                                                  key.mip_level_count,
+                                                  key.base_array_layer,
+                                                  key.array_layer_count);
+  const auto view_info = make_image_view_info(mImage, key.type, key.format, range);
+
+  auto image_view = ImageView::make(mDevice, view_info, result);
+  if (!image_view) {
+    return VK_NULL_HANDLE;
+  }
+
+  const auto iter = mViews.try_emplace(key, std::move(image_view)).first;
+  return iter->second.get();
+}
+
 }  // namespace grace
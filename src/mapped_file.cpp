@@ -0,0 +1,269 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/mapped_file.hpp"
+
+#include <cerrno>        // errno, EINTR
+#include <cstdio>        // rename
+#include <cstdlib>       // mkstemp
+#include <fstream>       // ofstream
+#include <ios>           // ios, streamsize
+#include <random>        // random_device
+#include <string>        // string, to_string
+#include <system_error>  // error_code
+#include <utility>       // move
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GRACE_HAS_MMAP 1
+#include <fcntl.h>     // open, O_RDONLY, O_DIRECTORY, O_CLOEXEC
+#include <sys/mman.h>  // mmap, munmap
+#include <sys/stat.h>  // fstat, fchmod, S_ISREG
+#include <unistd.h>    // close, write, fsync, unlink
+#endif
+
+namespace grace {
+namespace {
+
+#ifdef GRACE_HAS_MMAP
+
+[[nodiscard]] auto write_all(const int fd, std::span<const std::byte> bytes) -> bool
+{
+  while (!bytes.empty()) {
+    const auto count = ::write(fd, bytes.data(), bytes.size());
+
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      return false;
+    }
+
+    bytes = bytes.subspan(static_cast<usize>(count));
+  }
+
+  return true;
+}
+
+// Makes a rename durable by flushing the directory that contains the file.
+[[nodiscard]] auto sync_parent_directory(const std::filesystem::path& path) -> bool
+{
+  auto directory = path.parent_path();
+  if (directory.empty()) {
+    directory = ".";
+  }
+
+  const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd == -1) {
+    return false;
+  }
+
+  const auto synced = ::fsync(fd) == 0;
+  ::close(fd);
+
+  return synced;
+}
+
+#endif  // GRACE_HAS_MMAP
+
+}  // namespace
+
+auto MappedFile::open(const std::filesystem::path& path, VkResult* result) -> MappedFile
+{
+  if (result) {
+    *result = VK_ERROR_UNKNOWN;
+  }
+
+  MappedFile file;
+
+#ifdef GRACE_HAS_MMAP
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return {};
+  }
+
+  struct stat info {};
+  if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+    ::close(fd);
+    return {};
+  }
+
+  file.mSize = static_cast<usize>(info.st_size);
+
+  // Empty files can't be mapped, but are still valid
+  if (file.mSize != 0) {
+    void* data = ::mmap(nullptr, file.mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (data == MAP_FAILED) {
+      ::close(fd);
+      return {};
+    }
+
+    file.mData = data;
+    file.mIsMapped = true;
+  }
+
+  // The mapping remains valid after the file descriptor is closed
+  ::close(fd);
+#else
+  std::ifstream stream {path, std::ios::in | std::ios::binary | std::ios::ate};
+  if (!stream.is_open() || !stream.good()) {
+    return {};
+  }
+
+  const auto file_size = static_cast<usize>(stream.tellg());
+  stream.seekg(0);
+
+  file.mBuffer.resize((file_size + sizeof(uint32) - 1) / sizeof(uint32));
+
+  if (!stream.read(reinterpret_cast<char*>(file.mBuffer.data()),
+                   static_cast<std::streamsize>(file_size))) {
+    return {};
+  }
+
+  file.mData = data_or_null(file.mBuffer);
+  file.mSize = file_size;
+#endif  // GRACE_HAS_MMAP
+
+  file.mIsOpen = true;
+
+  if (result) {
+    *result = VK_SUCCESS;
+  }
+
+  return file;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mData {other.mData},
+      mSize {other.mSize},
+      mBuffer {std::move(other.mBuffer)},
+      mIsMapped {other.mIsMapped},
+      mIsOpen {other.mIsOpen}
+{
+  other.mData = nullptr;
+  other.mSize = 0;
+  other.mIsMapped = false;
+  other.mIsOpen = false;
+}
+
+auto MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile&
+{
+  if (this != &other) {
+    close();
+
+    mData = other.mData;
+    mSize = other.mSize;
+    mBuffer = std::move(other.mBuffer);
+    mIsMapped = other.mIsMapped;
+    mIsOpen = other.mIsOpen;
+
+    other.mData = nullptr;
+    other.mSize = 0;
+    other.mIsMapped = false;
+    other.mIsOpen = false;
+  }
+
+  return *this;
+}
+
+MappedFile::~MappedFile() noexcept
+{
+  close();
+}
+
+void MappedFile::close() noexcept
+{
+#ifdef GRACE_HAS_MMAP
+  if (mIsMapped) {
+    ::munmap(const_cast<void*>(mData), mSize);
+  }
+#endif  // GRACE_HAS_MMAP
+
+  mData = nullptr;
+  mSize = 0;
+  mBuffer.clear();
+  mBuffer.shrink_to_fit();
+  mIsMapped = false;
+  mIsOpen = false;
+}
+
+auto write_file_atomically(const std::filesystem::path& path,
+                           const std::span<const std::byte> bytes) -> VkResult
+{
+#ifdef GRACE_HAS_MMAP
+  // The temporary file is unique, so concurrent writers never share a temporary file
+  auto temporary_path = path.string() + ".XXXXXX";
+
+  const int fd = ::mkstemp(temporary_path.data());
+  if (fd == -1) {
+    return VK_ERROR_UNKNOWN;
+  }
+
+  // mkstemp creates files that only the owner can read, unlike ordinary new files
+  constexpr mode_t mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+
+  // The data must be on disk before the rename, or a crash could leave an empty file
+  const auto written =
+      ::fchmod(fd, mode) == 0 && write_all(fd, bytes) && ::fsync(fd) == 0;
+  const auto closed = ::close(fd) == 0;
+
+  if (!written || !closed || std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+    ::unlink(temporary_path.c_str());
+    return VK_ERROR_UNKNOWN;
+  }
+
+  return sync_parent_directory(path) ? VK_SUCCESS : VK_ERROR_UNKNOWN;
+#else
+  auto temporary_path = path;
+  temporary_path += ".tmp" + std::to_string(std::random_device {}());
+
+  std::ofstream stream {temporary_path,
+                       std::ios::out | std::ios::binary | std::ios::trunc};
+  stream.write(reinterpret_cast<const char*>(bytes.data()),
+               static_cast<std::streamsize>(bytes.size()));
+
+  // Buffered data is written when the stream is closed, which may fail as well
+  stream.close();
+
+  std::error_code error;
+
+  if (stream.fail()) {
+    std::filesystem::remove(temporary_path, error);
+    return VK_ERROR_UNKNOWN;
+  }
+
+  // Renaming is atomic on most file systems, so readers never see partial files
+  std::filesystem::rename(temporary_path, path, error);
+
+  if (error) {
+    std::filesystem::remove(temporary_path, error);
+    return VK_ERROR_UNKNOWN;
+  }
+
+  return VK_SUCCESS;
+#endif  // GRACE_HAS_MMAP
+}
+
+}  // namespace grace
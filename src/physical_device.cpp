@@ -42,6 +42,16 @@ auto get_physical_devices(VkInstance instance) -> std::vector<VkPhysicalDevice>
   return gpus;
 }
 
+auto get_physical_device_info(VkPhysicalDevice gpu) -> PhysicalDeviceInfo
+{
+  PhysicalDeviceInfo info;
+
+  vkGetPhysicalDeviceFeatures(gpu, &info.features);
+  vkGetPhysicalDeviceProperties(gpu, &info.properties);
+
+  return info;
+}
+
 auto get_extensions(VkPhysicalDevice gpu) -> std::vector<VkExtensionProperties>
 {
   uint32 extension_count = 0;
@@ -24,12 +24,196 @@
 
 #include "grace/pipeline.hpp"
 
-#include <algorithm>  // find
-#include <cstring>    // memcpy
+#include <algorithm>    // find, sort
+#include <array>        // array
+#include <cstring>      // memcpy
+#include <type_traits>  // is_trivially_copyable_v
+#include <utility>      // move
 
 #include "grace/shader_module.hpp"
 
 namespace grace {
+namespace {
+
+// Serializes pipeline state into a byte sequence that can be compared and hashed.
+class PipelineStateWriter final {
+ public:
+  // Note, the Vulkan structures written as values only have 32-bit members (no padding)
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  void write(const T& value)
+  {
+    const auto offset = mBytes.size();
+    mBytes.resize(offset + sizeof value);
+    std::memcpy(mBytes.data() + offset, &value, sizeof value);
+  }
+
+  void write(const std::string& str)
+  {
+    write(str.size());
+
+    const auto offset = mBytes.size();
+    mBytes.resize(offset + str.size());
+    std::memcpy(mBytes.data() + offset, str.data(), str.size());
+  }
+
+  template <typename T>
+  void write(const std::vector<T>& values)
+  {
+    write(values.size());
+
+    for (const auto& value : values) {
+      write(value);
+    }
+  }
+
+  [[nodiscard]] auto take() noexcept -> std::vector<std::byte>
+  {
+    return std::move(mBytes);
+  }
+
+ private:
+  std::vector<std::byte> mBytes;
+};
+
+// Reads pipeline state written by a PipelineStateWriter, failures are sticky.
+class PipelineStateReader final {
+ public:
+  explicit PipelineStateReader(const std::span<const std::byte> bytes) noexcept
+      : mBytes {bytes}
+  {}
+
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  void read(T& value) noexcept
+  {
+    if (mFailed || mBytes.size() - mOffset < sizeof value) {
+      mFailed = true;
+      return;
+    }
+
+    std::memcpy(&value, mBytes.data() + mOffset, sizeof value);
+    mOffset += sizeof value;
+  }
+
+  void read(std::string& str)
+  {
+    usize size {0};
+    read(size);
+
+    if (mFailed || mBytes.size() - mOffset < size) {
+      mFailed = true;
+      return;
+    }
+
+    str.assign(reinterpret_cast<const char*>(mBytes.data() + mOffset), size);
+    mOffset += size;
+  }
+
+  template <typename T>
+  void read(std::vector<T>& values)
+  {
+    usize count {0};
+    read(count);
+
+    // Rejects corrupt counts before allocating any memory
+    if (mFailed || (mBytes.size() - mOffset) / sizeof(T) < count) {
+      mFailed = true;
+      return;
+    }
+
+    values.resize(count);
+    for (auto& value : values) {
+      read(value);
+    }
+  }
+
+  [[nodiscard]] auto good() const noexcept -> bool { return !mFailed; }
+
+  [[nodiscard]] auto at_end() const noexcept -> bool { return mOffset == mBytes.size(); }
+
+ private:
+  std::span<const std::byte> mBytes;
+  usize mOffset {0};
+  bool mFailed {false};
+};
+
+// The version of the serialized pipeline state format.
+inline constexpr uint32 kSerializedStateVersion = 1;
+
+// The flags of the serialized pipeline state.
+inline constexpr uint32 kDepthBiasFlag = 0x1;
+inline constexpr uint32 kDepthTestFlag = 0x2;
+inline constexpr uint32 kDepthWriteFlag = 0x4;
+inline constexpr uint32 kDepthBoundsTestFlag = 0x8;
+inline constexpr uint32 kDepthClampFlag = 0x10;
+inline constexpr uint32 kStencilTestFlag = 0x20;
+inline constexpr uint32 kColorLogicOpFlag = 0x40;
+inline constexpr uint32 kDynamicRenderingFlag = 0x80;
+inline constexpr uint32 kTessellationFlag = 0x100;
+
+// The parts of the pipeline state, matching the pipeline library flags.
+inline constexpr uint32 kVertexInputState = 0x1;
+inline constexpr uint32 kPreRasterizationState = 0x2;
+inline constexpr uint32 kFragmentShaderState = 0x4;
+inline constexpr uint32 kFragmentOutputState = 0x8;
+inline constexpr uint32 kCompleteState = 0xF;
+
+#ifdef VK_EXT_graphics_pipeline_library
+static_assert(kVertexInputState ==
+              VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT);
+static_assert(kPreRasterizationState ==
+              VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT);
+static_assert(kFragmentShaderState ==
+              VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT);
+static_assert(kFragmentOutputState ==
+              VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT);
+#endif  // VK_EXT_graphics_pipeline_library
+
+// Extended dynamic states, or a sentinel value if the Vulkan headers don't provide them.
+#ifdef VK_EXT_extended_dynamic_state
+inline constexpr auto kDynamicPrimitiveTopology = VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT;
+inline constexpr auto kDynamicCullMode = VK_DYNAMIC_STATE_CULL_MODE_EXT;
+inline constexpr auto kDynamicFrontFace = VK_DYNAMIC_STATE_FRONT_FACE_EXT;
+inline constexpr auto kDynamicDepthTestEnable = VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT;
+inline constexpr auto kDynamicDepthWriteEnable = VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT;
+inline constexpr auto kDynamicDepthCompareOp = VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT;
+inline constexpr auto kDynamicDepthBoundsTestEnable =
+    VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE_EXT;
+inline constexpr auto kDynamicStencilTestEnable =
+    VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT;
+inline constexpr auto kDynamicStencilOp = VK_DYNAMIC_STATE_STENCIL_OP_EXT;
+#else
+inline constexpr auto kDynamicPrimitiveTopology = VK_DYNAMIC_STATE_MAX_ENUM;
+inline constexpr auto kDynamicCullMode = VK_DYNAMIC_STATE_MAX_ENUM;
+inline constexpr auto kDynamicFrontFace = VK_DYNAMIC_STATE_MAX_ENUM;
+inline constexpr auto kDynamicDepthTestEnable = VK_DYNAMIC_STATE_MAX_ENUM;
+inline constexpr auto kDynamicDepthWriteEnable = VK_DYNAMIC_STATE_MAX_ENUM;
+inline constexpr auto kDynamicDepthCompareOp = VK_DYNAMIC_STATE_MAX_ENUM;
+inline constexpr auto kDynamicDepthBoundsTestEnable = VK_DYNAMIC_STATE_MAX_ENUM;
+inline constexpr auto kDynamicStencilTestEnable = VK_DYNAMIC_STATE_MAX_ENUM;
+inline constexpr auto kDynamicStencilOp = VK_DYNAMIC_STATE_MAX_ENUM;
+#endif  // VK_EXT_extended_dynamic_state
+
+#ifdef VK_EXT_extended_dynamic_state2
+inline constexpr auto kDynamicDepthBiasEnable = VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT;
+inline constexpr auto kDynamicLogicOp = VK_DYNAMIC_STATE_LOGIC_OP_EXT;
+#else
+inline constexpr auto kDynamicDepthBiasEnable = VK_DYNAMIC_STATE_MAX_ENUM;
+inline constexpr auto kDynamicLogicOp = VK_DYNAMIC_STATE_MAX_ENUM;
+#endif  // VK_EXT_extended_dynamic_state2
+
+#ifdef VK_EXT_extended_dynamic_state3
+inline constexpr auto kDynamicPolygonMode = VK_DYNAMIC_STATE_POLYGON_MODE_EXT;
+inline constexpr auto kDynamicDepthClampEnable = VK_DYNAMIC_STATE_DEPTH_CLAMP_ENABLE_EXT;
+inline constexpr auto kDynamicLogicOpEnable = VK_DYNAMIC_STATE_LOGIC_OP_ENABLE_EXT;
+#else
+inline constexpr auto kDynamicPolygonMode = VK_DYNAMIC_STATE_MAX_ENUM;
+inline constexpr auto kDynamicDepthClampEnable = VK_DYNAMIC_STATE_MAX_ENUM;
+inline constexpr auto kDynamicLogicOpEnable = VK_DYNAMIC_STATE_MAX_ENUM;
+#endif  // VK_EXT_extended_dynamic_state3
+
+}  // namespace
 
 auto make_viewport(const float x,
                    const float y,
@@ -237,14 +421,23 @@ auto GraphicsPipelineBuilder::reset() -> Self&
   mScissors.clear();
   mDynamicStates.clear();
   mColorBlendAttachments.clear();
+  mColorAttachmentFormats.clear();
 
   mTessellationPatchControlPoints.reset();
 
+  mDepthAttachmentFormat = VK_FORMAT_UNDEFINED;
+  mStencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+  mUsesDynamicRendering = false;
+
+  // Shader setters are overloaded for paths, modules and code, so they are reset here
+  mVertexShader = ShaderInfo {.entry_name = "main"};
+  mFragmentShader = ShaderInfo {.entry_name = "main"};
+
   return with_layout(VK_NULL_HANDLE)
       .with_cache(VK_NULL_HANDLE)
       .with_render_pass(VK_NULL_HANDLE, 0)
-      .vertex_shader(nullptr)
-      .fragment_shader(nullptr)
+      .with_shader_library(nullptr)
+      .with_feedback_callback(nullptr, false)
       .primitive_topology(kDefaultTopology)
       .rasterization(kDefaultPolygonMode)
       .line_width(kDefaultLineWidth)
@@ -278,11 +471,63 @@ auto GraphicsPipelineBuilder::with_render_pass(VkRenderPass render_pass,
   return *this;
 }
 
+#ifdef VK_KHR_dynamic_rendering
+
+auto GraphicsPipelineBuilder::with_rendering_formats(std::vector<VkFormat> color_formats,
+                                                     const VkFormat depth_format,
+                                                     const VkFormat stencil_format)
+    -> Self&
+{
+  mColorAttachmentFormats = std::move(color_formats);
+  mDepthAttachmentFormat = depth_format;
+  mStencilAttachmentFormat = stencil_format;
+  mUsesDynamicRendering = true;
+  return *this;
+}
+
+#endif  // VK_KHR_dynamic_rendering
+
+auto GraphicsPipelineBuilder::with_shader_library(ShaderLibrary* library) -> Self&
+{
+  mShaderLibrary = library;
+  return *this;
+}
+
+auto GraphicsPipelineBuilder::with_feedback_callback(PipelineFeedbackCallback callback,
+                                     bool feedback_enabled) -> Self&
+{
+  mFeedbackCallback = std::move(callback);
+  mFeedbackEnabled = feedback_enabled;
+  return *this;
+}
+
 auto GraphicsPipelineBuilder::vertex_shader(const char* shader_path,
                                             const char* entry_name) -> Self&
 {
   mVertexShader.path = shader_path ? shader_path : std::string {};
   mVertexShader.entry_name = entry_name ? entry_name : "main";
+  mVertexShader.module = VK_NULL_HANDLE;
+  mVertexShader.code = {};
+  return *this;
+}
+
+auto GraphicsPipelineBuilder::vertex_shader(VkShaderModule shader_module,
+                                            const char* entry_name) -> Self&
+{
+  mVertexShader.path.clear();
+  mVertexShader.entry_name = entry_name ? entry_name : "main";
+  mVertexShader.module = shader_module;
+  mVertexShader.code = {};
+  return *this;
+}
+
+auto GraphicsPipelineBuilder::vertex_shader(const std::span<const uint32> code,
+                                            const char* entry_name) -> Self&
+{
+  mVertexShader.path.clear();
+  mVertexShader.entry_name = entry_name ? entry_name : "main";
+  mVertexShader.module = VK_NULL_HANDLE;
+  mVertexShader.code = code;
   return *this;
 }
 
@@ -291,6 +536,42 @@ auto GraphicsPipelineBuilder::fragment_shader(const char* shader_path,
 {
   mFragmentShader.path = shader_path ? shader_path : std::string {};
   mFragmentShader.entry_name = entry_name ? entry_name : "main";
+  mFragmentShader.module = VK_NULL_HANDLE;
+  mFragmentShader.code = {};
+  return *this;
+}
+
+auto GraphicsPipelineBuilder::fragment_shader(VkShaderModule shader_module,
+                                              const char* entry_name) -> Self&
+{
+  mFragmentShader.path.clear();
+  mFragmentShader.entry_name = entry_name ? entry_name : "main";
+  mFragmentShader.module = shader_module;
+  mFragmentShader.code = {};
+  return *this;
+}
+
+auto GraphicsPipelineBuilder::fragment_shader(const std::span<const uint32> code,
+                                              const char* entry_name) -> Self&
+{
+  mFragmentShader.path.clear();
+  mFragmentShader.entry_name = entry_name ? entry_name : "main";
+  mFragmentShader.module = VK_NULL_HANDLE;
+  mFragmentShader.code = code;
+  return *this;
+}
+
+auto GraphicsPipelineBuilder::vertex_specialization(
+    const SpecializationConstants& constants) -> Self&
+{
+  mVertexShader.constants = constants;
+  return *this;
+}
+
+auto GraphicsPipelineBuilder::fragment_specialization(
+    const SpecializationConstants& constants) -> Self&
+{
+  mFragmentShader.constants = constants;
   return *this;
 }
 
@@ -482,13 +763,27 @@ auto GraphicsPipelineBuilder::stencil_test(const bool enabled,
 
 auto GraphicsPipelineBuilder::dynamic_state(const VkDynamicState state) -> Self&
 {
-  mDynamicStates.push_back(state);
+  // Dynamic states must be unique
+  if (!_is_dynamic(state)) {
+    mDynamicStates.push_back(state);
+  }
+
+  return *this;
+}
+
+auto GraphicsPipelineBuilder::dynamic_states(const std::span<const VkDynamicState> states)
+    -> Self&
+{
+  for (const auto state : states) {
+    dynamic_state(state);
+  }
+
   return *this;
 }
 
 auto GraphicsPipelineBuilder::build(VkResult* result) const -> GraphicsPipeline
 {
-  if (!_is_complete()) {
+  if (!_is_complete(kCompleteState)) {
     if (result) {
       *result = VK_INCOMPLETE;
     }
@@ -496,33 +791,474 @@ auto GraphicsPipelineBuilder::build(VkResult* result) const -> GraphicsPipeline
     return {};
   }
 
-  auto vertex_shader = ShaderModule::read(mDevice, mVertexShader.path.c_str(), result);
-  if (!vertex_shader) {
+  return _create_pipeline(kCompleteState, result);
+}
+
+#ifdef VK_EXT_graphics_pipeline_library
+
+auto GraphicsPipelineBuilder::build_library(const VkGraphicsPipelineLibraryFlagsEXT parts,
+                                            VkResult* result) const -> GraphicsPipeline
+{
+  if (parts == 0 || !_is_complete(parts)) {
+    if (result) {
+      *result = VK_INCOMPLETE;
+    }
+
     return {};
   }
 
-  auto fragment_shader =
-      ShaderModule::read(mDevice, mFragmentShader.path.c_str(), result);
-  if (!fragment_shader) {
+  return _create_pipeline(parts, result);
+}
+
+auto GraphicsPipelineBuilder::link_libraries(const std::span<const VkPipeline> libraries,
+                                             const bool optimize,
+                                             VkResult* result) const -> GraphicsPipeline
+{
+  const VkPipelineLibraryCreateInfoKHR library_info = {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR,
+      .pNext = nullptr,
+      .libraryCount = static_cast<uint32>(libraries.size()),
+      .pLibraries = libraries.data(),
+  };
+
+  VkGraphicsPipelineCreateInfo pipeline_info = {};
+  pipeline_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+  pipeline_info.pNext = &library_info;
+  pipeline_info.flags = 0;
+  pipeline_info.layout = mLayout;
+  pipeline_info.basePipelineHandle = VK_NULL_HANDLE;
+  pipeline_info.basePipelineIndex = 0;
+
+  if (optimize) {
+    pipeline_info.flags |= VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT;
+  }
+
+  return _make_pipeline(pipeline_info, result);
+}
+
+auto GraphicsPipelineBuilder::get_library_state_key(
+    const VkGraphicsPipelineLibraryFlagsEXT parts) const -> std::vector<std::byte>
+{
+  PipelineStateWriter writer;
+
+  // Different parts with equal state must produce different keys
+  writer.write(parts);
+  _write_state(writer, parts);
+
+  return writer.take();
+}
+
+#endif  // VK_EXT_graphics_pipeline_library
+
+auto GraphicsPipelineBuilder::build_many(
+    const std::span<const GraphicsPipelineBuilder> builders,
+    ThreadPool& pool,
+    VkPipelineCache cache) -> std::vector<std::future<GraphicsPipelineResult>>
+{
+  std::vector<std::future<GraphicsPipelineResult>> pipelines;
+  pipelines.reserve(builders.size());
+
+  for (const auto& builder : builders) {
+    auto task = [builder, cache]() mutable {
+      if (cache != VK_NULL_HANDLE) {
+        builder.with_cache(cache);
+      }
+
+      GraphicsPipelineResult pipeline;
+      pipeline.pipeline = builder.build(&pipeline.result);
+
+      return pipeline;
+    };
+
+    pipelines.push_back(pool.submit(std::move(task)));
+  }
+
+  return pipelines;
+}
+
+auto GraphicsPipelineBuilder::get_state_key() const -> std::vector<std::byte>
+{
+  PipelineStateWriter writer;
+  _write_state(writer, kCompleteState);
+  return writer.take();
+}
+
+auto GraphicsPipelineBuilder::get_state_hash() const -> uint64
+{
+  const auto key = get_state_key();
+  return fnv1a_hash(key.data(), key.size());
+}
+
+auto GraphicsPipelineBuilder::get_shader_paths() const -> std::vector<std::string>
+{
+  std::vector<std::string> paths;
+
+  for (const auto* shader : {&mVertexShader, &mFragmentShader}) {
+    if (!shader->path.empty()) {
+      paths.push_back(shader->path);
+    }
+  }
+
+  return paths;
+}
+
+auto GraphicsPipelineBuilder::serialize() const -> std::vector<std::byte>
+{
+  if (mVertexShader.module || mFragmentShader.module) {
     return {};
   }
 
+  PipelineStateWriter writer;
+
+  const auto write_shader = [&](const ShaderInfo& shader) {
+    const auto code_hash = shader.code.empty()
+                               ? uint64 {0}
+                               : fnv1a_hash(shader.code.data(), shader.code.size_bytes());
+
+    writer.write(shader.path);
+    writer.write(shader.entry_name);
+    writer.write(code_hash);
+    writer.write(shader.constants.get_map_entries());
+    writer.write(shader.constants.get_data());
+  };
+
+  uint32 flags {0};
+  flags |= mDepthBiasEnabled ? kDepthBiasFlag : 0;
+  flags |= mDepthTestEnabled ? kDepthTestFlag : 0;
+  flags |= mDepthWriteEnabled ? kDepthWriteFlag : 0;
+  flags |= mDepthBoundsTestEnabled ? kDepthBoundsTestFlag : 0;
+  flags |= mDepthClampEnabled ? kDepthClampFlag : 0;
+  flags |= mStencilTestEnabled ? kStencilTestFlag : 0;
+  flags |= mColorLogicOpEnabled ? kColorLogicOpFlag : 0;
+  flags |= mUsesDynamicRendering ? kDynamicRenderingFlag : 0;
+  flags |= mTessellationPatchControlPoints.has_value() ? kTessellationFlag : 0;
+
+  writer.write(kSerializedStateVersion);
+  writer.write(flags);
+  writer.write(mSubpass);
+
+  write_shader(mVertexShader);
+  write_shader(mFragmentShader);
+
+  writer.write(mVertexInputBindings);
+  writer.write(mVertexAttributes);
+  writer.write(mViewports);
+  writer.write(mScissors);
+  writer.write(mDynamicStates);
+  writer.write(mColorBlendAttachments);
+  writer.write(mColorAttachmentFormats);
+  writer.write(mDepthAttachmentFormat);
+  writer.write(mStencilAttachmentFormat);
+
+  writer.write(mTessellationPatchControlPoints.value_or(0));
+  writer.write(mPrimitiveTopology);
+  writer.write(mPolygonMode);
+  writer.write(mCullMode);
+  writer.write(mFrontFace);
+  writer.write(mDepthCompareOp);
+  writer.write(mColorLogicOp);
+  writer.write(mFrontStencilOpState);
+  writer.write(mBackStencilOpState);
+
+  writer.write(mLineWidth);
+  writer.write(mDepthBiasConstantFactor);
+  writer.write(mDepthBiasSlopeFactor);
+  writer.write(mDepthBiasClampValue);
+  writer.write(mMinDepth);
+  writer.write(mMaxDepth);
+  writer.write(mBlendConstants);
+
+  return writer.take();
+}
+
+auto GraphicsPipelineBuilder::deserialize(VkDevice device,
+                                          const std::span<const std::byte> bytes,
+                                          const ShaderCodeResolver& resolver)
+    -> std::optional<GraphicsPipelineBuilder>
+{
+  PipelineStateReader reader {bytes};
+
+  uint32 version {0};
+  reader.read(version);
+
+  if (!reader.good() || version != kSerializedStateVersion) {
+    return std::nullopt;
+  }
+
+  const auto read_shader = [&](ShaderInfo& shader) {
+    uint64 code_hash {0};
+    std::vector<VkSpecializationMapEntry> entries;
+    std::vector<std::byte> data;
+
+    reader.read(shader.path);
+    reader.read(shader.entry_name);
+    reader.read(code_hash);
+    reader.read(entries);
+    reader.read(data);
+
+    if (!reader.good()) {
+      return false;
+    }
+
+    if (code_hash != 0) {
+      shader.code = resolver ? resolver(code_hash) : std::span<const uint32> {};
+
+      if (shader.code.empty() ||
+          fnv1a_hash(shader.code.data(), shader.code.size_bytes()) != code_hash) {
+        return false;
+      }
+    }
+
+    for (const auto& entry : entries) {
+      if (static_cast<usize>(entry.offset) + entry.size > data.size()) {
+        return false;
+      }
+
+      const auto* value = data.data() + entry.offset;
+
+      if (entry.size == sizeof(uint32)) {
+        uint32 value32 {0};
+        std::memcpy(&value32, value, sizeof value32);
+        shader.constants.set(entry.constantID, value32);
+      }
+      else if (entry.size == sizeof(uint64)) {
+        uint64 value64 {0};
+        std::memcpy(&value64, value, sizeof value64);
+        shader.constants.set(entry.constantID, value64);
+      }
+      else {
+        return false;
+      }
+    }
+
+    return true;
+  };
+
+  GraphicsPipelineBuilder builder {device};
+
+  uint32 flags {0};
+  reader.read(flags);
+  reader.read(builder.mSubpass);
+
+  if (!read_shader(builder.mVertexShader) || !read_shader(builder.mFragmentShader)) {
+    return std::nullopt;
+  }
+
+  reader.read(builder.mVertexInputBindings);
+  reader.read(builder.mVertexAttributes);
+  reader.read(builder.mViewports);
+  reader.read(builder.mScissors);
+  reader.read(builder.mDynamicStates);
+  reader.read(builder.mColorBlendAttachments);
+  reader.read(builder.mColorAttachmentFormats);
+  reader.read(builder.mDepthAttachmentFormat);
+  reader.read(builder.mStencilAttachmentFormat);
+
+  uint32 patch_control_points {0};
+  reader.read(patch_control_points);
+  reader.read(builder.mPrimitiveTopology);
+  reader.read(builder.mPolygonMode);
+  reader.read(builder.mCullMode);
+  reader.read(builder.mFrontFace);
+  reader.read(builder.mDepthCompareOp);
+  reader.read(builder.mColorLogicOp);
+  reader.read(builder.mFrontStencilOpState);
+  reader.read(builder.mBackStencilOpState);
+
+  reader.read(builder.mLineWidth);
+  reader.read(builder.mDepthBiasConstantFactor);
+  reader.read(builder.mDepthBiasSlopeFactor);
+  reader.read(builder.mDepthBiasClampValue);
+  reader.read(builder.mMinDepth);
+  reader.read(builder.mMaxDepth);
+  reader.read(builder.mBlendConstants);
+
+  if (!reader.good() || !reader.at_end()) {
+    return std::nullopt;
+  }
+
+  if (flags & kTessellationFlag) {
+    builder.mTessellationPatchControlPoints = patch_control_points;
+  }
+
+  builder.mDepthBiasEnabled = (flags & kDepthBiasFlag) != 0;
+  builder.mDepthTestEnabled = (flags & kDepthTestFlag) != 0;
+  builder.mDepthWriteEnabled = (flags & kDepthWriteFlag) != 0;
+  builder.mDepthBoundsTestEnabled = (flags & kDepthBoundsTestFlag) != 0;
+  builder.mDepthClampEnabled = (flags & kDepthClampFlag) != 0;
+  builder.mStencilTestEnabled = (flags & kStencilTestFlag) != 0;
+  builder.mColorLogicOpEnabled = (flags & kColorLogicOpFlag) != 0;
+  builder.mUsesDynamicRendering = (flags & kDynamicRenderingFlag) != 0;
+
+  return builder;
+}
+
+template <typename Writer>
+void GraphicsPipelineBuilder::_write_state(Writer& writer, const uint32 parts) const
+{
+  // Baked values of dynamic states are ignored, so they must not affect the key
+  const auto write_baked = [&](const VkDynamicState state, const auto& value) {
+    if (!_is_dynamic(state)) {
+      writer.write(value);
+    }
+  };
+
+  const auto write_shader = [&](const ShaderInfo& shader) {
+    writer.write(shader.path);
+    writer.write(shader.entry_name);
+    writer.write(shader.module);
+    writer.write(fnv1a_hash(shader.code.data(), shader.code.size_bytes()));
+    writer.write(shader.constants.get_map_entries());
+    writer.write(shader.constants.get_data());
+  };
+
+  // The order of the dynamic states doesn't matter
+  auto dynamic_states = mDynamicStates;
+  std::sort(dynamic_states.begin(), dynamic_states.end());
+  writer.write(dynamic_states);
+
+  if (parts & (kPreRasterizationState | kFragmentShaderState | kFragmentOutputState)) {
+    writer.write(mRenderPass);
+    writer.write(mSubpass);
+    writer.write(static_cast<bool>(mUsesDynamicRendering));
+  }
+
+  if (parts & (kPreRasterizationState | kFragmentShaderState)) {
+    writer.write(mLayout);
+  }
+
+  if (parts & kVertexInputState) {
+    writer.write(mVertexInputBindings);
+    writer.write(mVertexAttributes);
+    write_baked(kDynamicPrimitiveTopology, mPrimitiveTopology);
+  }
+
+  if (parts & kPreRasterizationState) {
+    write_shader(mVertexShader);
+
+    write_baked(VK_DYNAMIC_STATE_VIEWPORT, mViewports);
+    write_baked(VK_DYNAMIC_STATE_SCISSOR, mScissors);
+
+    writer.write(mTessellationPatchControlPoints.has_value());
+    writer.write(mTessellationPatchControlPoints.value_or(0));
+
+    write_baked(kDynamicPolygonMode, mPolygonMode);
+    write_baked(kDynamicCullMode, mCullMode);
+    write_baked(kDynamicFrontFace, mFrontFace);
+    write_baked(VK_DYNAMIC_STATE_LINE_WIDTH, mLineWidth);
+    write_baked(VK_DYNAMIC_STATE_DEPTH_BIAS, mDepthBiasConstantFactor);
+    write_baked(VK_DYNAMIC_STATE_DEPTH_BIAS, mDepthBiasSlopeFactor);
+    write_baked(VK_DYNAMIC_STATE_DEPTH_BIAS, mDepthBiasClampValue);
+    write_baked(kDynamicDepthBiasEnable, static_cast<bool>(mDepthBiasEnabled));
+    write_baked(kDynamicDepthClampEnable, static_cast<bool>(mDepthClampEnabled));
+  }
+
+  if (parts & kFragmentShaderState) {
+    write_shader(mFragmentShader);
+
+    write_baked(kDynamicDepthCompareOp, mDepthCompareOp);
+
+    for (const auto& stencil : {mFrontStencilOpState, mBackStencilOpState}) {
+      write_baked(kDynamicStencilOp, stencil.failOp);
+      write_baked(kDynamicStencilOp, stencil.passOp);
+      write_baked(kDynamicStencilOp, stencil.depthFailOp);
+      write_baked(kDynamicStencilOp, stencil.compareOp);
+      write_baked(VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK, stencil.compareMask);
+      write_baked(VK_DYNAMIC_STATE_STENCIL_WRITE_MASK, stencil.writeMask);
+      write_baked(VK_DYNAMIC_STATE_STENCIL_REFERENCE, stencil.reference);
+    }
+
+    write_baked(VK_DYNAMIC_STATE_DEPTH_BOUNDS, mMinDepth);
+    write_baked(VK_DYNAMIC_STATE_DEPTH_BOUNDS, mMaxDepth);
+    write_baked(kDynamicDepthTestEnable, static_cast<bool>(mDepthTestEnabled));
+    write_baked(kDynamicDepthWriteEnable, static_cast<bool>(mDepthWriteEnabled));
+    write_baked(kDynamicDepthBoundsTestEnable,
+                static_cast<bool>(mDepthBoundsTestEnabled));
+    write_baked(kDynamicStencilTestEnable, static_cast<bool>(mStencilTestEnabled));
+  }
+
+  if (parts & kFragmentOutputState) {
+    writer.write(mColorBlendAttachments);
+    writer.write(mColorAttachmentFormats);
+    writer.write(mDepthAttachmentFormat);
+    writer.write(mStencilAttachmentFormat);
+
+    write_baked(kDynamicLogicOp, mColorLogicOp);
+    write_baked(kDynamicLogicOpEnable, static_cast<bool>(mColorLogicOpEnabled));
+    write_baked(VK_DYNAMIC_STATE_BLEND_CONSTANTS, mBlendConstants);
+  }
+}
+
+auto GraphicsPipelineBuilder::_is_complete(const uint32 parts) const -> bool
+{
+  const auto has_shader = [](const ShaderInfo& shader) {
+    return !shader.path.empty() || shader.module != VK_NULL_HANDLE ||
+           !shader.code.empty();
+  };
+
+  const auto has_layout = mLayout != VK_NULL_HANDLE;
+  const auto has_render_target = mRenderPass != VK_NULL_HANDLE || mUsesDynamicRendering;
+
+  if ((parts & kPreRasterizationState) && !(has_layout && has_shader(mVertexShader))) {
+    return false;
+  }
+
+  if ((parts & kFragmentShaderState) && !(has_layout && has_shader(mFragmentShader))) {
+    return false;
+  }
+
+  if ((parts & ~kVertexInputState) && !has_render_target) {
+    return false;
+  }
+
+  return true;
+}
+
+auto GraphicsPipelineBuilder::_create_pipeline(const uint32 parts, VkResult* result) const
+    -> GraphicsPipeline
+{
+  ShaderModule owned_vertex_shader;
+  ShaderModule owned_fragment_shader;
+
+  std::array<VkPipelineShaderStageCreateInfo, 2> shader_stages {};
+  uint32 shader_stage_count = 0;
+
+  const auto vertex_specialization = mVertexShader.constants.info();
+  const auto fragment_specialization = mFragmentShader.constants.info();
+
+  if (parts & kPreRasterizationState) {
+    const auto vertex_shader =
+        _get_shader_module(mVertexShader, owned_vertex_shader, result);
+    if (vertex_shader == VK_NULL_HANDLE) {
+      return {};
+    }
+
+    shader_stages[shader_stage_count++] = make_pipeline_shader_stage_info(
+        VK_SHADER_STAGE_VERTEX_BIT,
+        vertex_shader,
+        !mVertexShader.constants.empty() ? &vertex_specialization : nullptr,
+        mVertexShader.entry_name.c_str());
+  }
+
+  if (parts & kFragmentShaderState) {
+    const auto fragment_shader =
+        _get_shader_module(mFragmentShader, owned_fragment_shader, result);
+    if (fragment_shader == VK_NULL_HANDLE) {
+      return {};
+    }
+
+    shader_stages[shader_stage_count++] = make_pipeline_shader_stage_info(
+        VK_SHADER_STAGE_FRAGMENT_BIT,
+        fragment_shader,
+        !mFragmentShader.constants.empty() ? &fragment_specialization : nullptr,
+        mFragmentShader.entry_name.c_str());
+  }
+
   VkGraphicsPipelineCreateInfo pipeline_info = {};
   pipeline_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
   pipeline_info.flags = 0;
   pipeline_info.pNext = nullptr;
 
-  // TODO shader customization (specialization constants)
-  VkPipelineShaderStageCreateInfo shader_stages[2] = {};
-  shader_stages[0] = make_pipeline_shader_stage_info(VK_SHADER_STAGE_VERTEX_BIT,
-                                                     vertex_shader,
-                                                     nullptr,
-                                                     mVertexShader.entry_name.c_str());
-  shader_stages[1] = make_pipeline_shader_stage_info(VK_SHADER_STAGE_FRAGMENT_BIT,
-                                                     fragment_shader,
-                                                     nullptr,
-                                                     mFragmentShader.entry_name.c_str());
-
   const auto vertex_input_state = get_vertex_input_state_info();
   const auto input_assembly_state = get_input_assembly_state_info();
   const auto tessellation_state = get_tessellation_state_info();
@@ -533,41 +1269,139 @@ auto GraphicsPipelineBuilder::build(VkResult* result) const -> GraphicsPipeline
   const auto color_blend_state = get_color_blend_state_info();
   const auto dynamic_state = get_dynamic_state_info();
 
-  pipeline_info.stageCount = u32_size(shader_stages);
-  pipeline_info.pStages = shader_stages;
-  pipeline_info.pVertexInputState = &vertex_input_state;
-  pipeline_info.pInputAssemblyState = &input_assembly_state;
-  pipeline_info.pTessellationState = nullptr;
-  pipeline_info.pViewportState = &viewport_state;
-  pipeline_info.pRasterizationState = &rasterization_state;
-  pipeline_info.pMultisampleState = &multisample_state;
-  pipeline_info.pDepthStencilState = &depth_stencil_state;
-  pipeline_info.pColorBlendState = &color_blend_state;
-  pipeline_info.pDynamicState = nullptr;
+  pipeline_info.stageCount = shader_stage_count;
+  pipeline_info.pStages = shader_stages.data();
 
-  if (mTessellationPatchControlPoints.has_value()) {
-    pipeline_info.pTessellationState = &tessellation_state;
+  if (parts & kVertexInputState) {
+    pipeline_info.pVertexInputState = &vertex_input_state;
+    pipeline_info.pInputAssemblyState = &input_assembly_state;
+  }
+
+  if (parts & kPreRasterizationState) {
+    pipeline_info.pViewportState = &viewport_state;
+    pipeline_info.pRasterizationState = &rasterization_state;
+
+    if (mTessellationPatchControlPoints.has_value()) {
+      pipeline_info.pTessellationState = &tessellation_state;
+    }
+  }
+
+  if (parts & kFragmentShaderState) {
+    pipeline_info.pDepthStencilState = &depth_stencil_state;
+  }
+
+  if (parts & (kFragmentShaderState | kFragmentOutputState)) {
+    pipeline_info.pMultisampleState = &multisample_state;
+  }
+
+  if (parts & kFragmentOutputState) {
+    pipeline_info.pColorBlendState = &color_blend_state;
   }
 
   if (!mDynamicStates.empty()) {
     pipeline_info.pDynamicState = &dynamic_state;
   }
 
-  pipeline_info.layout = mLayout;
-  pipeline_info.renderPass = mRenderPass;
-  pipeline_info.subpass = mSubpass;
+#ifdef VK_KHR_dynamic_rendering
+  const auto rendering_info = get_rendering_info();
+
+  if (mUsesDynamicRendering && mRenderPass == VK_NULL_HANDLE) {
+    pipeline_info.pNext = &rendering_info;
+  }
+#endif  // VK_KHR_dynamic_rendering
+
+#ifdef VK_EXT_graphics_pipeline_library
+  const VkGraphicsPipelineLibraryCreateInfoEXT library_info = {
+      .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT,
+      .pNext = pipeline_info.pNext,
+      .flags = parts,
+  };
+
+  if (parts != kCompleteState) {
+    pipeline_info.pNext = &library_info;
+    pipeline_info.flags = VK_PIPELINE_CREATE_LIBRARY_BIT_KHR |
+                          VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+  }
+#endif  // VK_EXT_graphics_pipeline_library
+
+  if (parts & (kPreRasterizationState | kFragmentShaderState)) {
+    pipeline_info.layout = mLayout;
+  }
+
+  if (parts & (kPreRasterizationState | kFragmentShaderState | kFragmentOutputState)) {
+    pipeline_info.renderPass = mRenderPass;
+    pipeline_info.subpass = mSubpass;
+  }
+
   pipeline_info.basePipelineHandle = VK_NULL_HANDLE;
   pipeline_info.basePipelineIndex = 0;
 
-  return GraphicsPipeline::make(mDevice, pipeline_info, mCache, result);
+  return _make_pipeline(pipeline_info, result);
+}
+
+auto GraphicsPipelineBuilder::_make_pipeline(VkGraphicsPipelineCreateInfo& pipeline_info,
+                                             VkResult* result) const -> GraphicsPipeline
+{
+#ifdef VK_EXT_pipeline_creation_feedback
+  if (mFeedbackCallback && mFeedbackEnabled) {
+    PipelineFeedbackQuery query {pipeline_info.stageCount, pipeline_info.pNext};
+    pipeline_info.pNext = query.get_info();
+
+    auto pipeline = GraphicsPipeline::make(mDevice, pipeline_info, mCache, result);
+
+    if (pipeline) {
+      const std::span stages {pipeline_info.pStages, pipeline_info.stageCount};
+      mFeedbackCallback(query.get_feedback(pipeline.get(), stages));
+    }
+
+    return pipeline;
+  }
+#endif  // VK_EXT_pipeline_creation_feedback
+
+  auto pipeline = GraphicsPipeline::make(mDevice, pipeline_info, mCache, result);
+
+  // Report that no statistics are available for the pipeline
+  if (pipeline && mFeedbackCallback) {
+    mFeedbackCallback(PipelineFeedback {.pipeline = pipeline.get()});
+  }
+
+  return pipeline;
+}
+
+auto GraphicsPipelineBuilder::_is_dynamic(const VkDynamicState state) const -> bool
+{
+  return std::find(mDynamicStates.begin(), mDynamicStates.end(), state) !=
+         mDynamicStates.end();
 }
 
-auto GraphicsPipelineBuilder::_is_complete() const -> bool
+auto GraphicsPipelineBuilder::_get_shader_module(const ShaderInfo& shader,
+                                                 ShaderModule& owned_module,
+                                                 VkResult* result) const
+    -> VkShaderModule
 {
-  return mLayout != VK_NULL_HANDLE &&      //
-         mRenderPass != VK_NULL_HANDLE &&  //
-         !mVertexShader.path.empty() &&    //
-         !mFragmentShader.path.empty();
+  if (shader.module != VK_NULL_HANDLE) {
+    return shader.module;
+  }
+
+  if (!shader.code.empty()) {
+    if (mShaderLibrary) {
+      return mShaderLibrary->get_module(shader.code.data(),
+                                        shader.code.size_bytes(),
+                                        result);
+    }
+
+    owned_module =
+        ShaderModule::make(mDevice, shader.code.data(), shader.code.size_bytes(), result);
+    return owned_module.get();
+  }
+
+  if (mShaderLibrary) {
+    return mShaderLibrary->get_module(shader.path, result);
+  }
+
+  // Without a library, the shader module only lives until the pipeline has been built
+  owned_module = ShaderModule::read(mDevice, shader.path.c_str(), result);
+  return owned_module.get();
 }
 
 auto GraphicsPipelineBuilder::get_vertex_input_state_info() const
@@ -597,15 +1431,12 @@ auto GraphicsPipelineBuilder::get_viewport_state_info() const
 {
   auto info = make_pipeline_viewport_state_info(mViewports, mScissors);
 
-  if (std::find(mDynamicStates.begin(),
-                mDynamicStates.end(),
-                VK_DYNAMIC_STATE_VIEWPORT) != mDynamicStates.end()) {
+  if (_is_dynamic(VK_DYNAMIC_STATE_VIEWPORT)) {
     info.pViewports = nullptr;
     info.viewportCount = 1;
   }
 
-  if (std::find(mDynamicStates.begin(), mDynamicStates.end(), VK_DYNAMIC_STATE_SCISSOR) !=
-      mDynamicStates.end()) {
+  if (_is_dynamic(VK_DYNAMIC_STATE_SCISSOR)) {
     info.pScissors = nullptr;
     info.scissorCount = 1;
   }
@@ -685,4 +1516,22 @@ auto GraphicsPipelineBuilder::get_dynamic_state_info() const
   return make_pipeline_dynamic_state_info(mDynamicStates);
 }
 
+#ifdef VK_KHR_dynamic_rendering
+
+auto GraphicsPipelineBuilder::get_rendering_info() const
+    -> VkPipelineRenderingCreateInfoKHR
+{
+  return {
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR,
+      .pNext = nullptr,
+      .viewMask = 0,
+      .colorAttachmentCount = u32_size(mColorAttachmentFormats),
+      .pColorAttachmentFormats = data_or_null(mColorAttachmentFormats),
+      .depthAttachmentFormat = mDepthAttachmentFormat,
+      .stencilAttachmentFormat = mStencilAttachmentFormat,
+  };
+}
+
+#endif  // VK_KHR_dynamic_rendering
+
 }  // namespace grace
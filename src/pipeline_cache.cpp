@@ -24,8 +24,35 @@
 
 #include "grace/pipeline_cache.hpp"
 
+#include <cstring>  // memcpy, memcmp
+
+#include "grace/mapped_file.hpp"
+
 namespace grace {
 
+auto is_pipeline_cache_compatible(const void* data,
+                                  const usize data_size,
+                                  const VkPhysicalDeviceProperties& gpu_properties)
+    -> bool
+{
+  VkPipelineCacheHeaderVersionOne header = {};
+
+  if (!data || data_size < sizeof header) {
+    return false;
+  }
+
+  std::memcpy(&header, data, sizeof header);
+
+  return header.headerSize >= sizeof header &&                            //
+         header.headerSize <= data_size &&                                //
+         header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&  //
+         header.vendorID == gpu_properties.vendorID &&                    //
+         header.deviceID == gpu_properties.deviceID &&                    //
+         std::memcmp(header.pipelineCacheUUID,
+                     gpu_properties.pipelineCacheUUID,
+                     VK_UUID_SIZE) == 0;
+}
+
 auto make_pipeline_cache_info(const void* initial_data,
                               const usize initial_data_size,
                               const VkPipelineCacheCreateFlags flags)
@@ -69,6 +96,26 @@ auto PipelineCache::make(VkDevice device,
   return PipelineCache::make(device, cache_info, result);
 }
 
+auto PipelineCache::load_or_create(VkDevice device,
+                                   VkPhysicalDevice gpu,
+                                   const std::filesystem::path& path,
+                                   VkResult* result) -> PipelineCache
+{
+  VkPhysicalDeviceProperties gpu_properties;
+  vkGetPhysicalDeviceProperties(gpu, &gpu_properties);
+
+  // A missing file results in an empty view, which is rejected below
+  const auto data = MappedFile::open(path);
+
+  if (is_pipeline_cache_compatible(data.data(), data.size(), gpu_properties)) {
+    if (auto cache = PipelineCache::make(device, data.data(), data.size(), 0, result)) {
+      return cache;
+    }
+  }
+
+  return PipelineCache::make(device, nullptr, 0, 0, result);
+}
+
 PipelineCache::PipelineCache(VkDevice device, VkPipelineCache cache) noexcept
     : mDevice {device},
       mCache {cache}
@@ -142,4 +189,16 @@ auto PipelineCache::get_data(VkResult* result) const -> std::vector<std::byte>
   return bytes;
 }
 
+auto PipelineCache::save(const std::filesystem::path& path) const -> VkResult
+{
+  VkResult result = VK_SUCCESS;
+
+  const auto data = get_data(&result);
+  if (result != VK_SUCCESS) {
+    return result;
+  }
+
+  return write_file_atomically(path, data);
+}
+
 }  // namespace grace
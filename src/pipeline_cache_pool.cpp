@@ -0,0 +1,117 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/pipeline_cache_pool.hpp"
+
+#include <utility>  // move
+
+namespace grace {
+
+PipelineCachePool::PipelineCachePool(PipelineCache primary,
+                                     const VkPipelineCacheCreateFlags thread_flags)
+    : mPrimary {std::move(primary)},
+      mThreadFlags {thread_flags}
+{
+  // Thread caches start out with the contents of the primary cache, to avoid misses
+  if (mPrimary) {
+    mInitialData = mPrimary.get_data();
+  }
+}
+
+auto PipelineCachePool::get(VkResult* result) -> VkPipelineCache
+{
+  // The device is taken from the primary cache
+  if (!mPrimary) {
+    if (result) {
+      *result = VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    return VK_NULL_HANDLE;
+  }
+
+  const auto thread_id = std::this_thread::get_id();
+
+  const std::scoped_lock lock {mMutex};
+
+  if (const auto iter = mThreadCaches.find(thread_id); iter != mThreadCaches.end()) {
+    if (result) {
+      *result = VK_SUCCESS;
+    }
+
+    return iter->second.get();
+  }
+
+  auto cache = PipelineCache::make(mPrimary.device(),
+                                   data_or_null(mInitialData),
+                                   mInitialData.size(),
+                                   mThreadFlags,
+                                   result);
+  if (!cache) {
+    return VK_NULL_HANDLE;
+  }
+
+  return mThreadCaches.try_emplace(thread_id, std::move(cache)).first->second.get();
+}
+
+auto PipelineCachePool::merge() -> VkResult
+{
+  if (!mPrimary) {
+    return VK_ERROR_INITIALIZATION_FAILED;
+  }
+
+  const std::scoped_lock lock {mMutex};
+
+  std::vector<VkPipelineCache> caches;
+  caches.reserve(mThreadCaches.size());
+
+  for (auto& entry : mThreadCaches) {
+    caches.push_back(entry.second.get());
+  }
+
+  if (caches.empty()) {
+    return VK_SUCCESS;
+  }
+
+  return vkMergePipelineCaches(mPrimary.device(),
+                               mPrimary.get(),
+                               static_cast<uint32>(caches.size()),
+                               caches.data());
+}
+
+auto PipelineCachePool::save(const std::filesystem::path& path) -> VkResult
+{
+  if (const auto result = merge(); result != VK_SUCCESS) {
+    return result;
+  }
+
+  return mPrimary.save(path);
+}
+
+auto PipelineCachePool::thread_count() const -> usize
+{
+  const std::scoped_lock lock {mMutex};
+  return mThreadCaches.size();
+}
+
+}  // namespace grace
@@ -0,0 +1,88 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/pipeline_feedback.hpp"
+
+namespace grace {
+
+#ifdef VK_EXT_pipeline_creation_feedback
+
+PipelineFeedbackQuery::PipelineFeedbackQuery(const uint32 stage_count, const void* next)
+    : mStageFeedback(stage_count)
+{
+  mInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+  mInfo.pNext = next;
+  mInfo.pPipelineCreationFeedback = &mPipelineFeedback;
+  mInfo.pipelineStageCreationFeedbackCount = stage_count;
+  mInfo.pPipelineStageCreationFeedbacks =
+      !mStageFeedback.empty() ? mStageFeedback.data() : nullptr;
+}
+
+auto PipelineFeedbackQuery::get_feedback(
+    VkPipeline pipeline,
+    const std::span<const VkPipelineShaderStageCreateInfo> stages) const
+    -> PipelineFeedback
+{
+  const auto has_flag = [](const VkPipelineCreationFeedbackEXT& feedback,
+                           const VkPipelineCreationFeedbackFlagsEXT flag) {
+    return (feedback.flags & flag) == flag;
+  };
+
+  PipelineFeedback feedback;
+  feedback.pipeline = pipeline;
+  feedback.duration_ns = mPipelineFeedback.duration;
+  feedback.valid =
+      has_flag(mPipelineFeedback, VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT);
+  feedback.cache_hit = has_flag(
+      mPipelineFeedback,
+      VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT);
+  feedback.base_pipeline_acceleration = has_flag(
+      mPipelineFeedback,
+      VK_PIPELINE_CREATION_FEEDBACK_BASE_PIPELINE_ACCELERATION_BIT_EXT);
+
+  feedback.stages.reserve(mStageFeedback.size());
+
+  for (usize index = 0; index < mStageFeedback.size(); ++index) {
+    const auto& stage_feedback = mStageFeedback[index];
+
+    PipelineStageFeedback stage;
+    stage.stage = (index < stages.size()) ? stages[index].stage : VK_SHADER_STAGE_ALL;
+    stage.duration_ns = stage_feedback.duration;
+    stage.valid = has_flag(stage_feedback, VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT);
+    stage.cache_hit = has_flag(
+        stage_feedback,
+        VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT);
+    stage.base_pipeline_acceleration = has_flag(
+        stage_feedback,
+        VK_PIPELINE_CREATION_FEEDBACK_BASE_PIPELINE_ACCELERATION_BIT_EXT);
+
+    feedback.stages.push_back(stage);
+  }
+
+  return feedback;
+}
+
+#endif  // VK_EXT_pipeline_creation_feedback
+
+}  // namespace grace
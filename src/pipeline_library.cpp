@@ -0,0 +1,138 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/pipeline_library.hpp"
+
+#include <array>         // array
+#include <mutex>         // scoped_lock
+#include <shared_mutex>  // shared_lock
+#include <utility>       // move
+
+namespace grace {
+
+#ifdef VK_EXT_graphics_pipeline_library
+
+namespace {
+
+inline constexpr std::array kLibraryParts = {
+    VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT,
+};
+
+}  // namespace
+
+auto is_graphics_pipeline_library_supported(VkPhysicalDevice gpu) -> bool
+{
+  VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT library_features = {};
+  library_features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+
+  VkPhysicalDeviceFeatures2 features = {};
+  features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+  features.pNext = &library_features;
+
+  vkGetPhysicalDeviceFeatures2(gpu, &features);
+
+  return library_features.graphicsPipelineLibrary == VK_TRUE;
+}
+
+void PipelineLibraryCache::clear() noexcept
+{
+  const std::scoped_lock lock {mClearMutex, mMutex};
+  mLibraries.clear();
+}
+
+auto PipelineLibraryCache::get_library(const GraphicsPipelineBuilder& builder,
+                                       const VkGraphicsPipelineLibraryFlagBitsEXT part,
+                                       VkResult* result) -> VkPipeline
+{
+  auto key = builder.get_library_state_key(part);
+
+  {
+    const std::scoped_lock lock {mMutex};
+
+    if (const auto iter = mLibraries.find(key); iter != mLibraries.end()) {
+      if (result) {
+        *result = VK_SUCCESS;
+      }
+
+      return iter->second.get();
+    }
+  }
+
+  auto library = builder.build_library(part, result);
+  if (!library) {
+    return VK_NULL_HANDLE;
+  }
+
+  const std::scoped_lock lock {mMutex};
+
+  // Another thread may have built an equivalent library in the meantime
+  const auto iter = mLibraries.try_emplace(std::move(key), std::move(library)).first;
+  return iter->second.get();
+}
+
+auto PipelineLibraryCache::link(const GraphicsPipelineBuilder& builder,
+                                const bool optimize,
+                                VkResult* result) -> GraphicsPipeline
+{
+  // The libraries must not be destroyed until they have been linked
+  const std::shared_lock clear_lock {mClearMutex};
+
+  std::array<VkPipeline, kLibraryParts.size()> libraries {};
+
+  for (usize index = 0; index < kLibraryParts.size(); ++index) {
+    libraries[index] = get_library(builder, kLibraryParts[index], result);
+
+    if (libraries[index] == VK_NULL_HANDLE) {
+      return {};
+    }
+  }
+
+  return builder.link_libraries(libraries, optimize, result);
+}
+
+auto PipelineLibraryCache::link_optimized_async(const GraphicsPipelineBuilder& builder,
+                                                ThreadPool& pool)
+    -> std::future<GraphicsPipelineResult>
+{
+  return pool.submit([this, builder] {
+    GraphicsPipelineResult pipeline;
+    pipeline.pipeline = link(builder, true, &pipeline.result);
+
+    return pipeline;
+  });
+}
+
+auto PipelineLibraryCache::size() const -> usize
+{
+  const std::scoped_lock lock {mMutex};
+  return mLibraries.size();
+}
+
+#endif  // VK_EXT_graphics_pipeline_library
+
+}  // namespace grace
@@ -0,0 +1,359 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/pipeline_manifest.hpp"
+
+#include <cstring>      // memcpy
+#include <optional>     // optional
+#include <type_traits>  // is_trivially_copyable_v
+#include <utility>      // move
+
+#include "grace/mapped_file.hpp"
+
+namespace grace {
+namespace {
+
+// The manifest file header, i.e. "GRPM" followed by the format version.
+inline constexpr uint32 kManifestMagic = 0x4D505247;
+inline constexpr uint32 kManifestVersion = 1;
+
+template <typename T>
+  requires std::is_trivially_copyable_v<T>
+void append_value(std::vector<std::byte>& bytes, const T& value)
+{
+  const auto offset = bytes.size();
+  bytes.resize(offset + sizeof value);
+  std::memcpy(bytes.data() + offset, &value, sizeof value);
+}
+
+void append_bytes(std::vector<std::byte>& bytes, const void* data, const usize size)
+{
+  append_value(bytes, static_cast<uint64>(size));
+
+  const auto offset = bytes.size();
+  bytes.resize(offset + size);
+
+  if (size != 0) {
+    std::memcpy(bytes.data() + offset, data, size);
+  }
+}
+
+void append_entry(std::vector<std::byte>& bytes,
+                  const std::string& layout,
+                  const std::string& render_pass,
+                  const std::vector<std::byte>& state)
+{
+  append_bytes(bytes, layout.data(), layout.size());
+  append_bytes(bytes, render_pass.data(), render_pass.size());
+  append_bytes(bytes, state.data(), state.size());
+}
+
+// Reads the values written by the append functions.
+class ManifestReader final {
+ public:
+  explicit ManifestReader(const std::span<const std::byte> bytes) noexcept
+      : mBytes {bytes}
+  {}
+
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  [[nodiscard]] auto read_value(T& value) noexcept -> bool
+  {
+    if (mBytes.size() - mOffset < sizeof value) {
+      return false;
+    }
+
+    std::memcpy(&value, mBytes.data() + mOffset, sizeof value);
+    mOffset += sizeof value;
+
+    return true;
+  }
+
+  [[nodiscard]] auto read_bytes(std::span<const std::byte>& bytes) noexcept -> bool
+  {
+    uint64 size {0};
+    if (!read_value(size) || mBytes.size() - mOffset < size) {
+      return false;
+    }
+
+    bytes = mBytes.subspan(mOffset, static_cast<usize>(size));
+    mOffset += static_cast<usize>(size);
+
+    return true;
+  }
+
+  [[nodiscard]] auto at_end() const noexcept -> bool { return mOffset == mBytes.size(); }
+
+ private:
+  std::span<const std::byte> mBytes;
+  usize mOffset {0};
+};
+
+[[nodiscard]] auto to_string(const std::span<const std::byte> bytes) -> std::string
+{
+  return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+}
+
+}  // namespace
+
+void PipelineManifest::register_layout(const std::string& name,
+                                       VkPipelineLayout layout)
+{
+  const std::scoped_lock lock {mMutex};
+
+  if (const auto iter = mLayouts.find(name); iter != mLayouts.end()) {
+    mLayoutNames.erase(iter->second);
+  }
+
+  mLayouts[name] = layout;
+  mLayoutNames[layout] = name;
+}
+
+void PipelineManifest::register_render_pass(const std::string& name,
+                                            VkRenderPass render_pass)
+{
+  const std::scoped_lock lock {mMutex};
+
+  if (const auto iter = mRenderPasses.find(name); iter != mRenderPasses.end()) {
+    mRenderPassNames.erase(iter->second);
+  }
+
+  mRenderPasses[name] = render_pass;
+  mRenderPassNames[render_pass] = name;
+}
+
+void PipelineManifest::register_shader_code(const std::span<const uint32> code)
+{
+  const std::scoped_lock lock {mMutex};
+  mShaderCode[fnv1a_hash(code.data(), code.size_bytes())] = code;
+}
+
+auto PipelineManifest::record(const GraphicsPipelineBuilder& builder) -> bool
+{
+  auto state = builder.serialize();
+  if (state.empty()) {
+    return false;
+  }
+
+  const std::scoped_lock lock {mMutex};
+
+  const auto layout_iter = mLayoutNames.find(builder.get_layout());
+  if (layout_iter == mLayoutNames.end()) {
+    return false;
+  }
+
+  std::string render_pass_name;
+
+  if (const auto render_pass = builder.get_render_pass()) {
+    const auto render_pass_iter = mRenderPassNames.find(render_pass);
+    if (render_pass_iter == mRenderPassNames.end()) {
+      return false;
+    }
+
+    render_pass_name = render_pass_iter->second;
+  }
+
+  _add(Entry {layout_iter->second, std::move(render_pass_name), std::move(state)});
+  return true;
+}
+
+auto PipelineManifest::save(const std::filesystem::path& path) const -> VkResult
+{
+  std::vector<std::byte> bytes;
+
+  {
+    const std::scoped_lock lock {mMutex};
+
+    append_value(bytes, kManifestMagic);
+    append_value(bytes, kManifestVersion);
+    append_value(bytes, static_cast<uint64>(mEntries.size()));
+
+    for (const auto& entry : mEntries) {
+      append_entry(bytes, entry.layout, entry.render_pass, entry.state);
+    }
+  }
+
+  return write_file_atomically(path, bytes);
+}
+
+auto PipelineManifest::load(const std::filesystem::path& path) -> VkResult
+{
+  VkResult result = VK_SUCCESS;
+
+  const auto file = MappedFile::open(path, &result);
+  if (result != VK_SUCCESS) {
+    return result;
+  }
+
+  ManifestReader reader {file.bytes()};
+
+  uint32 magic {0};
+  uint32 version {0};
+  uint64 entry_count {0};
+
+  if (!reader.read_value(magic) || !reader.read_value(version) ||  //
+      !reader.read_value(entry_count) ||                           //
+      magic != kManifestMagic || version != kManifestVersion) {
+    return VK_ERROR_UNKNOWN;
+  }
+
+  // Entries are only added once the entire file has been validated
+  std::vector<Entry> entries;
+
+  for (uint64 index = 0; index < entry_count; ++index) {
+    std::span<const std::byte> layout;
+    std::span<const std::byte> render_pass;
+    std::span<const std::byte> state;
+
+    if (!reader.read_bytes(layout) || !reader.read_bytes(render_pass) ||  //
+        !reader.read_bytes(state) || state.empty()) {
+      return VK_ERROR_UNKNOWN;
+    }
+
+    entries.push_back(Entry {to_string(layout),
+                             to_string(render_pass),
+                             std::vector<std::byte>(state.begin(), state.end())});
+  }
+
+  if (!reader.at_end()) {
+    return VK_ERROR_UNKNOWN;
+  }
+
+  const std::scoped_lock lock {mMutex};
+
+  for (auto& entry : entries) {
+    _add(std::move(entry));
+  }
+
+  return VK_SUCCESS;
+}
+
+auto PipelineManifest::warm_up(VkDevice device,
+                               PipelineRegistry& registry,
+                               ThreadPool& pool,
+                               VkPipelineCache cache,
+                               ShaderLibrary* library) const
+    -> std::vector<std::future<VkResult>>
+{
+  return _warm_up(device, registry, pool, cache, nullptr, library);
+}
+
+auto PipelineManifest::warm_up(VkDevice device,
+                               PipelineRegistry& registry,
+                               ThreadPool& pool,
+                               PipelineCachePool& caches,
+                               ShaderLibrary* library) const
+    -> std::vector<std::future<VkResult>>
+{
+  return _warm_up(device, registry, pool, VK_NULL_HANDLE, &caches, library);
+}
+
+void PipelineManifest::clear()
+{
+  const std::scoped_lock lock {mMutex};
+
+  mEntries.clear();
+  mRecords.clear();
+}
+
+auto PipelineManifest::size() const -> usize
+{
+  const std::scoped_lock lock {mMutex};
+  return mEntries.size();
+}
+
+void PipelineManifest::_add(Entry entry)
+{
+  Record record;
+  append_entry(record, entry.layout, entry.render_pass, entry.state);
+
+  if (mRecords.insert(std::move(record)).second) {
+    mEntries.push_back(std::move(entry));
+  }
+}
+
+auto PipelineManifest::_warm_up(VkDevice device,
+                                PipelineRegistry& registry,
+                                ThreadPool& pool,
+                                VkPipelineCache cache,
+                                PipelineCachePool* caches,
+                                ShaderLibrary* library) const
+    -> std::vector<std::future<VkResult>>
+{
+  std::vector<std::future<VkResult>> results;
+
+  const std::scoped_lock lock {mMutex};
+
+  const auto resolve_code = [this](const uint64 code_hash) -> std::span<const uint32> {
+    const auto iter = mShaderCode.find(code_hash);
+    return iter != mShaderCode.end() ? iter->second : std::span<const uint32> {};
+  };
+
+  results.reserve(mEntries.size());
+
+  for (const auto& entry : mEntries) {
+    const auto layout_iter = mLayouts.find(entry.layout);
+    if (layout_iter == mLayouts.end()) {
+      continue;
+    }
+
+    VkRenderPass render_pass = VK_NULL_HANDLE;
+
+    if (!entry.render_pass.empty()) {
+      const auto render_pass_iter = mRenderPasses.find(entry.render_pass);
+      if (render_pass_iter == mRenderPasses.end()) {
+        continue;
+      }
+
+      render_pass = render_pass_iter->second;
+    }
+
+    auto builder =
+        GraphicsPipelineBuilder::deserialize(device, entry.state, resolve_code);
+    if (!builder) {
+      continue;
+    }
+
+    builder->with_layout(layout_iter->second)
+        .with_render_pass(render_pass, builder->get_subpass())
+        .with_cache(cache)
+        .with_shader_library(library);
+
+    // Thread caches must be requested by the worker threads that use them
+    auto task = [&registry, caches, builder = std::move(*builder)]() mutable {
+      if (caches) {
+        builder.with_cache(caches->get());
+      }
+
+      VkResult result = VK_SUCCESS;
+      return registry.get(builder, &result) ? VK_SUCCESS : result;
+    };
+
+    results.push_back(pool.submit(std::move(task)));
+  }
+
+  return results;
+}
+
+}  // namespace grace
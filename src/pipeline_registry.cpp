@@ -0,0 +1,91 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/pipeline_registry.hpp"
+
+#include <utility>  // move
+
+#include "grace/pipeline_manifest.hpp"
+
+namespace grace {
+
+void PipelineRegistry::clear() noexcept
+{
+  const std::scoped_lock lock {mMutex};
+  mPipelines.clear();
+}
+
+auto PipelineRegistry::get(const GraphicsPipelineBuilder& builder, VkResult* result)
+    -> VkPipeline
+{
+  auto key = builder.get_state_key();
+
+  {
+    const std::scoped_lock lock {mMutex};
+
+    if (const auto iter = mPipelines.find(key); iter != mPipelines.end()) {
+      if (result) {
+        *result = VK_SUCCESS;
+      }
+
+      return iter->second.get();
+    }
+  }
+
+  auto pipeline = builder.build(result);
+  if (!pipeline) {
+    return VK_NULL_HANDLE;
+  }
+
+  if (mManifest) {
+    mManifest->record(builder);
+  }
+
+  const std::scoped_lock lock {mMutex};
+
+  // Another thread may have built an equivalent pipeline in the meantime
+  const auto iter = mPipelines.try_emplace(std::move(key), std::move(pipeline)).first;
+  return iter->second.get();
+}
+
+auto PipelineRegistry::find(const GraphicsPipelineBuilder& builder) -> VkPipeline
+{
+  const auto key = builder.get_state_key();
+
+  const std::scoped_lock lock {mMutex};
+
+  if (const auto iter = mPipelines.find(key); iter != mPipelines.end()) {
+    return iter->second.get();
+  }
+
+  return VK_NULL_HANDLE;
+}
+
+auto PipelineRegistry::size() const -> usize
+{
+  const std::scoped_lock lock {mMutex};
+  return mPipelines.size();
+}
+
+}  // namespace grace
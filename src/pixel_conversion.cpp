@@ -0,0 +1,252 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/pixel_conversion.hpp"
+
+#include <algorithm>  // min, max
+#include <array>      // array
+#include <bit>        // bit_cast
+#include <cmath>      // pow
+
+namespace grace {
+namespace {
+
+// The number of entries in the linear-to-sRGB lookup table.
+inline constexpr usize kSrgbTableSize = 4096;
+
+[[nodiscard]] auto make_srgb_table() -> std::array<uint8, kSrgbTableSize>
+{
+  std::array<uint8, kSrgbTableSize> table {};
+
+  for (usize index = 0; index < kSrgbTableSize; ++index) {
+    const auto linear =
+        static_cast<double>(index) / static_cast<double>(kSrgbTableSize - 1);
+    const auto encoded = (linear <= 0.0031308)
+                             ? linear * 12.92
+                             : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+    table[index] = static_cast<uint8>(encoded * 255.0 + 0.5);
+  }
+
+  return table;
+}
+
+// Clamps a value to [0, 1], NaN values are mapped to zero.
+[[nodiscard]] inline auto saturate(const float value) noexcept -> float
+{
+  return std::min(std::max(0.0f, value), 1.0f);
+}
+
+[[nodiscard]] inline auto to_unorm8(const float value) noexcept -> uint8
+{
+  return static_cast<uint8>(saturate(value) * 255.0f + 0.5f);
+}
+
+[[nodiscard]] inline auto to_srgb8(const std::array<uint8, kSrgbTableSize>& table,
+                                   const float value) noexcept -> uint8
+{
+  constexpr auto max_index = static_cast<float>(kSrgbTableSize - 1);
+  return table[static_cast<usize>(saturate(value) * max_index + 0.5f)];
+}
+
+// Computes round(a * b / 255) without any divisions.
+[[nodiscard]] inline auto multiply_unorm8(const uint32 a, const uint32 b) noexcept
+    -> uint8
+{
+  const uint32 product = a * b + 128;
+  return static_cast<uint8>((product + (product >> 8)) >> 8);
+}
+
+void convert_rgb8_to_rgba8(const uint8* source,
+                           uint8* destination,
+                           const uint64 texel_count) noexcept
+{
+  for (uint64 index = 0; index < texel_count; ++index) {
+    destination[index * 4 + 0] = source[index * 3 + 0];
+    destination[index * 4 + 1] = source[index * 3 + 1];
+    destination[index * 4 + 2] = source[index * 3 + 2];
+    destination[index * 4 + 3] = 0xFF;
+  }
+}
+
+void convert_linear_rgba32f_to_srgba8(const float* source,
+                                      uint8* destination,
+                                      const uint64 texel_count) noexcept
+{
+  static const auto table = make_srgb_table();
+
+  for (uint64 index = 0; index < texel_count; ++index) {
+    destination[index * 4 + 0] = to_srgb8(table, source[index * 4 + 0]);
+    destination[index * 4 + 1] = to_srgb8(table, source[index * 4 + 1]);
+    destination[index * 4 + 2] = to_srgb8(table, source[index * 4 + 2]);
+
+    // Alpha is always stored linearly
+    destination[index * 4 + 3] = to_unorm8(source[index * 4 + 3]);
+  }
+}
+
+void convert_rgba32f_to_rgba16f(const float* source,
+                                uint16* destination,
+                                const uint64 texel_count) noexcept
+{
+  for (uint64 index = 0; index < texel_count * 4; ++index) {
+    destination[index] = float_to_half(source[index]);
+  }
+}
+
+void premultiply_rgba8(const uint8* source,
+                       uint8* destination,
+                       const uint64 texel_count) noexcept
+{
+  for (uint64 index = 0; index < texel_count; ++index) {
+    const uint32 alpha = source[index * 4 + 3];
+
+    destination[index * 4 + 0] = multiply_unorm8(source[index * 4 + 0], alpha);
+    destination[index * 4 + 1] = multiply_unorm8(source[index * 4 + 1], alpha);
+    destination[index * 4 + 2] = multiply_unorm8(source[index * 4 + 2], alpha);
+    destination[index * 4 + 3] = static_cast<uint8>(alpha);
+  }
+}
+
+}  // namespace
+
+auto get_source_texel_size(const PixelConversion conversion) noexcept -> uint64
+{
+  switch (conversion) {
+    case PixelConversion::kRgb8ToRgba8:
+      return 3;
+
+    case PixelConversion::kLinearRgba32fToSrgba8:
+    case PixelConversion::kRgba32fToRgba16f:
+      return 4 * sizeof(float);
+
+    case PixelConversion::kPremultiplyRgba8:
+      return 4;
+  }
+
+  return 0;
+}
+
+auto get_target_texel_size(const PixelConversion conversion) noexcept -> uint64
+{
+  switch (conversion) {
+    case PixelConversion::kRgb8ToRgba8:
+    case PixelConversion::kLinearRgba32fToSrgba8:
+    case PixelConversion::kPremultiplyRgba8:
+      return 4;
+
+    case PixelConversion::kRgba32fToRgba16f:
+      return 4 * sizeof(uint16);
+  }
+
+  return 0;
+}
+
+auto is_conversion_target(const PixelConversion conversion,
+                          const VkFormat format) noexcept -> bool
+{
+  switch (conversion) {
+    case PixelConversion::kRgb8ToRgba8:
+    case PixelConversion::kPremultiplyRgba8:
+      return format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_R8G8B8A8_SRGB;
+
+    case PixelConversion::kLinearRgba32fToSrgba8:
+      return format == VK_FORMAT_R8G8B8A8_SRGB;
+
+    case PixelConversion::kRgba32fToRgba16f:
+      return format == VK_FORMAT_R16G16B16A16_SFLOAT;
+  }
+
+  return false;
+}
+
+auto float_to_half(const float value) noexcept -> uint16
+{
+  // Based on the conversion by Fabian Giesen (float_to_half_fast3), with the branches
+  // replaced by masks, so that loops over this function can be vectorized
+  constexpr uint32 f32_infinity = 255u << 23;
+  constexpr uint32 f16_max = (127u + 16u) << 23;
+  constexpr uint32 f16_min_normal = 113u << 23;
+  constexpr uint32 denorm_magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+  constexpr uint32 sign_mask = 0x80000000u;
+
+  auto bits = std::bit_cast<uint32>(value);
+
+  const uint32 sign = bits & sign_mask;
+  bits ^= sign;
+
+  // Infinity or NaN (all exponent bits set), NaN becomes a quiet NaN
+  const uint32 nan_mask = 0u - static_cast<uint32>(bits > f32_infinity);
+  const uint32 overflow_half = 0x7C00u | (nan_mask & 0x0200u);
+
+  // Denormalized values are rounded by the floating-point addition
+  const auto rounded = std::bit_cast<float>(bits) + std::bit_cast<float>(denorm_magic);
+  const uint32 denormal_half = std::bit_cast<uint32>(rounded) - denorm_magic;
+
+  // Updates the exponent and rounds to the nearest even value
+  const uint32 odd_mantissa = (bits >> 13) & 1u;
+  const uint32 normal_half = (bits + ((15u - 127u) << 23) + 0xFFFu + odd_mantissa) >> 13;
+
+  const uint32 overflow_mask = 0u - static_cast<uint32>(bits >= f16_max);
+  const uint32 denormal_mask = 0u - static_cast<uint32>(bits < f16_min_normal);
+
+  const uint32 finite_half =
+      (denormal_mask & denormal_half) | (~denormal_mask & normal_half);
+  const uint32 half = (overflow_mask & overflow_half) | (~overflow_mask & finite_half);
+
+  return static_cast<uint16>(half | (sign >> 16));
+}
+
+void convert_pixels(const PixelConversion conversion,
+                    const void* source,
+                    void* destination,
+                    const uint64 texel_count) noexcept
+{
+  switch (conversion) {
+    case PixelConversion::kRgb8ToRgba8:
+      convert_rgb8_to_rgba8(static_cast<const uint8*>(source),
+                            static_cast<uint8*>(destination),
+                            texel_count);
+      break;
+
+    case PixelConversion::kLinearRgba32fToSrgba8:
+      convert_linear_rgba32f_to_srgba8(static_cast<const float*>(source),
+                                       static_cast<uint8*>(destination),
+                                       texel_count);
+      break;
+
+    case PixelConversion::kRgba32fToRgba16f:
+      convert_rgba32f_to_rgba16f(static_cast<const float*>(source),
+                                 static_cast<uint16*>(destination),
+                                 texel_count);
+      break;
+
+    case PixelConversion::kPremultiplyRgba8:
+      premultiply_rgba8(static_cast<const uint8*>(source),
+                        static_cast<uint8*>(destination),
+                        texel_count);
+      break;
+  }
+}
+
+}  // namespace grace
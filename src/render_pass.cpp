@@ -220,12 +220,16 @@ auto RenderPassBuilder::color_attachment(const VkFormat format,
 
 auto RenderPassBuilder::depth_attachment(const VkFormat format,
                                          const VkImageLayout initial_layout,
-                                         const VkSampleCountFlagBits samples) -> Self&
+                                         const VkSampleCountFlagBits samples,
+                                         const VkAttachmentStoreOp store_op) -> Self&
 {
-  return attachment(format,
-                    initial_layout,
-                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-                    samples);
+  auto description = make_attachment_description(format,
+                                                 initial_layout,
+                                                 VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                                                 samples);
+  description.storeOp = store_op;
+
+  return attachment(description);
 }
 
 auto RenderPassBuilder::subpass_dependency(const VkSubpassDependency& dependency) -> Self&
@@ -0,0 +1,217 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/rendering.hpp"
+
+#include "grace/device.hpp"
+
+namespace grace {
+namespace {
+
+void cmd_image_barrier(VkCommandBuffer cmd_buf,
+                       VkImage image,
+                       const VkImageAspectFlags aspects,
+                       const VkImageLayout old_layout,
+                       const VkImageLayout new_layout,
+                       const VkPipelineStageFlags src_stages,
+                       const VkPipelineStageFlags dst_stages,
+                       const VkAccessFlags src_access,
+                       const VkAccessFlags dst_access)
+{
+  const VkImageMemoryBarrier image_memory_barrier {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+      .pNext = nullptr,
+      .srcAccessMask = src_access,
+      .dstAccessMask = dst_access,
+      .oldLayout = old_layout,
+      .newLayout = new_layout,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .image = image,
+      .subresourceRange =
+          {
+              .aspectMask = aspects,
+              .baseMipLevel = 0,
+              .levelCount = VK_REMAINING_MIP_LEVELS,
+              .baseArrayLayer = 0,
+              .layerCount = VK_REMAINING_ARRAY_LAYERS,
+          },
+  };
+
+  vkCmdPipelineBarrier(cmd_buf,
+                       src_stages,
+                       dst_stages,
+                       0,
+                       0,
+                       nullptr,
+                       0,
+                       nullptr,
+                       1,
+                       &image_memory_barrier);
+}
+
+}  // namespace
+
+void cmd_transition_to_color_attachment(VkCommandBuffer cmd_buf, VkImage image)
+{
+  // The source stage matches the typical wait stage of image acquisition semaphores
+  cmd_image_barrier(cmd_buf,
+                    image,
+                    VK_IMAGE_ASPECT_COLOR_BIT,
+                    VK_IMAGE_LAYOUT_UNDEFINED,
+                    VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                    0,
+                    VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+}
+
+void cmd_transition_to_depth_attachment(VkCommandBuffer cmd_buf,
+                                        VkImage image,
+                                        const VkImageAspectFlags aspects)
+{
+  constexpr VkPipelineStageFlags fragment_test_stages =
+      VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+      VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+  cmd_image_barrier(cmd_buf,
+                    image,
+                    aspects,
+                    VK_IMAGE_LAYOUT_UNDEFINED,
+                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                    fragment_test_stages,
+                    fragment_test_stages,
+                    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+}
+
+void cmd_transition_to_present(VkCommandBuffer cmd_buf, VkImage image)
+{
+  cmd_image_barrier(cmd_buf,
+                    image,
+                    VK_IMAGE_ASPECT_COLOR_BIT,
+                    VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                    VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                    VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                    VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                    VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                    0);
+}
+
+#ifdef VK_KHR_dynamic_rendering
+
+auto get_dynamic_rendering_functions(VkDevice device) -> DynamicRenderingFunctions
+{
+  DynamicRenderingFunctions functions;
+
+  functions.vkCmdBeginRenderingKHR =
+      get_function<PFN_vkCmdBeginRenderingKHR>(device, "vkCmdBeginRenderingKHR");
+  functions.vkCmdEndRenderingKHR =
+      get_function<PFN_vkCmdEndRenderingKHR>(device, "vkCmdEndRenderingKHR");
+
+  return functions;
+}
+
+auto is_dynamic_rendering_supported(VkPhysicalDevice gpu) -> bool
+{
+  VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamic_rendering_features = {};
+  dynamic_rendering_features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+
+  VkPhysicalDeviceFeatures2 features = {};
+  features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+  features.pNext = &dynamic_rendering_features;
+
+  vkGetPhysicalDeviceFeatures2(gpu, &features);
+
+  return dynamic_rendering_features.dynamicRendering == VK_TRUE;
+}
+
+auto make_rendering_attachment_info(VkImageView image_view,
+                                    const VkImageLayout layout,
+                                    const VkAttachmentLoadOp load_op,
+                                    const VkAttachmentStoreOp store_op,
+                                    const VkClearValue& clear_value)
+    -> VkRenderingAttachmentInfoKHR
+{
+  return {
+      .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR,
+      .pNext = nullptr,
+      .imageView = image_view,
+      .imageLayout = layout,
+      .resolveMode = VK_RESOLVE_MODE_NONE,
+      .resolveImageView = VK_NULL_HANDLE,
+      .resolveImageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+      .loadOp = load_op,
+      .storeOp = store_op,
+      .clearValue = clear_value,
+  };
+}
+
+auto make_rendering_info(
+    const VkRect2D& render_area,
+    const std::span<const VkRenderingAttachmentInfoKHR> color_attachments,
+    const VkRenderingAttachmentInfoKHR* depth_attachment,
+    const VkRenderingAttachmentInfoKHR* stencil_attachment) -> VkRenderingInfoKHR
+{
+  return {
+      .sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,
+      .pNext = nullptr,
+      .flags = 0,
+      .renderArea = render_area,
+      .layerCount = 1,
+      .viewMask = 0,
+      .colorAttachmentCount = static_cast<uint32>(color_attachments.size()),
+      .pColorAttachments = color_attachments.data(),
+      .pDepthAttachment = depth_attachment,
+      .pStencilAttachment = stencil_attachment,
+  };
+}
+
+void cmd_begin_rendering(
+    const DynamicRenderingFunctions& functions,
+    VkCommandBuffer cmd_buf,
+    const VkRect2D& render_area,
+    const std::span<const VkRenderingAttachmentInfoKHR> color_attachments,
+    const VkRenderingAttachmentInfoKHR* depth_attachment,
+    const VkRenderingAttachmentInfoKHR* stencil_attachment)
+{
+  const auto rendering_info = make_rendering_info(render_area,
+                                                  color_attachments,
+                                                  depth_attachment,
+                                                  stencil_attachment);
+  functions.vkCmdBeginRenderingKHR(cmd_buf, &rendering_info);
+}
+
+void cmd_end_rendering(const DynamicRenderingFunctions& functions,
+                       VkCommandBuffer cmd_buf)
+{
+  functions.vkCmdEndRenderingKHR(cmd_buf);
+}
+
+#endif  // VK_KHR_dynamic_rendering
+
+}  // namespace grace
@@ -26,19 +26,13 @@
 
 namespace grace {
 
-auto make_sampler_info(VkPhysicalDevice gpu,
+auto make_sampler_info(const PhysicalDeviceInfo& gpu_info,
                        const VkFilter min_filter,
                        const VkFilter mag_filter,
                        const VkSamplerAddressMode address_mode,
                        const float min_lod,
                        const float max_lod) -> VkSamplerCreateInfo
 {
-  VkPhysicalDeviceFeatures gpu_features = {};
-  vkGetPhysicalDeviceFeatures(gpu, &gpu_features);
-
-  VkPhysicalDeviceProperties gpu_properties = {};
-  vkGetPhysicalDeviceProperties(gpu, &gpu_properties);
-
   return {
       .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
       .pNext = nullptr,
@@ -50,8 +44,8 @@ auto make_sampler_info(VkPhysicalDevice gpu,
       .addressModeV = address_mode,
       .addressModeW = address_mode,
       .mipLodBias = 0.0f,
-      .anisotropyEnable = gpu_features.samplerAnisotropy,
-      .maxAnisotropy = gpu_properties.limits.maxSamplerAnisotropy,
+      .anisotropyEnable = gpu_info.features.samplerAnisotropy,
+      .maxAnisotropy = gpu_info.properties.limits.maxSamplerAnisotropy,
       .compareEnable = VK_FALSE,
       .compareOp = VK_COMPARE_OP_NEVER,
       .minLod = min_lod,
@@ -61,6 +55,21 @@ auto make_sampler_info(VkPhysicalDevice gpu,
   };
 }
 
+auto make_sampler_info(VkPhysicalDevice gpu,
+                       const VkFilter min_filter,
+                       const VkFilter mag_filter,
+                       const VkSamplerAddressMode address_mode,
+                       const float min_lod,
+                       const float max_lod) -> VkSamplerCreateInfo
+{
+  return make_sampler_info(get_physical_device_info(gpu),
+                           min_filter,
+                           mag_filter,
+                           address_mode,
+                           min_lod,
+                           max_lod);
+}
+
 Sampler::Sampler(VkDevice device, VkSampler sampler) noexcept
     : mDevice {device},
       mSampler {sampler}
@@ -0,0 +1,121 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/sampler_cache.hpp"
+
+#include <cassert>  // assert
+#include <utility>  // move
+
+namespace grace {
+
+auto SamplerCache::SamplerInfoHasher::operator()(
+    const VkSamplerCreateInfo& info) const noexcept -> usize
+{
+  usize seed = 0;
+
+  hash_combine(seed, info.flags);
+  hash_combine(seed, info.magFilter);
+  hash_combine(seed, info.minFilter);
+  hash_combine(seed, info.mipmapMode);
+  hash_combine(seed, info.addressModeU);
+  hash_combine(seed, info.addressModeV);
+  hash_combine(seed, info.addressModeW);
+  hash_combine(seed, info.mipLodBias);
+  hash_combine(seed, info.anisotropyEnable);
+  hash_combine(seed, info.maxAnisotropy);
+  hash_combine(seed, info.compareEnable);
+  hash_combine(seed, info.compareOp);
+  hash_combine(seed, info.minLod);
+  hash_combine(seed, info.maxLod);
+  hash_combine(seed, info.borderColor);
+  hash_combine(seed, info.unnormalizedCoordinates);
+
+  return seed;
+}
+
+auto SamplerCache::SamplerInfoEqual::operator()(
+    const VkSamplerCreateInfo& lhs,
+    const VkSamplerCreateInfo& rhs) const noexcept -> bool
+{
+  return lhs.flags == rhs.flags &&                        //
+         lhs.magFilter == rhs.magFilter &&                //
+         lhs.minFilter == rhs.minFilter &&                //
+         lhs.mipmapMode == rhs.mipmapMode &&              //
+         lhs.addressModeU == rhs.addressModeU &&          //
+         lhs.addressModeV == rhs.addressModeV &&          //
+         lhs.addressModeW == rhs.addressModeW &&          //
+         lhs.mipLodBias == rhs.mipLodBias &&              //
+         lhs.anisotropyEnable == rhs.anisotropyEnable &&  //
+         lhs.maxAnisotropy == rhs.maxAnisotropy &&        //
+         lhs.compareEnable == rhs.compareEnable &&        //
+         lhs.compareOp == rhs.compareOp &&                //
+         lhs.minLod == rhs.minLod &&                      //
+         lhs.maxLod == rhs.maxLod &&                      //
+         lhs.borderColor == rhs.borderColor &&            //
+         lhs.unnormalizedCoordinates == rhs.unnormalizedCoordinates;
+}
+
+SamplerCache::SamplerCache(VkDevice device, VkPhysicalDevice gpu)
+    : mDevice {device},
+      mGpuInfo {get_physical_device_info(gpu)}
+{
+}
+
+void SamplerCache::clear() noexcept
+{
+  mSamplers.clear();
+}
+
+auto SamplerCache::get(const VkSamplerCreateInfo& sampler_info, VkResult* result)
+    -> VkSampler
+{
+  assert(sampler_info.pNext == nullptr && "Sampler extension structures are unsupported");
+
+  if (const auto iter = mSamplers.find(sampler_info); iter != mSamplers.end()) {
+    if (result) {
+      *result = VK_SUCCESS;
+    }
+
+    return iter->second.get();
+  }
+
+  auto sampler = Sampler::make(mDevice, sampler_info, result);
+  if (!sampler) {
+    return VK_NULL_HANDLE;
+  }
+
+  const auto iter = mSamplers.try_emplace(sampler_info, std::move(sampler)).first;
+  return iter->second.get();
+}
+
+auto SamplerCache::get(const VkFilter filter,
+                       const VkSamplerAddressMode address_mode,
+                       VkResult* result) -> VkSampler
+{
+  const auto sampler_info =
+      make_sampler_info(mGpuInfo, filter, filter, address_mode, 0.0f, 64.0f);
+  return get(sampler_info, result);
+}
+
+}  // namespace grace
@@ -0,0 +1,185 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/shader_hot_reload.hpp"
+
+#include <algorithm>  // count_if, find, max
+#include <chrono>     // seconds
+#include <utility>    // move
+
+namespace grace {
+
+ShaderHotReloader::ShaderHotReloader(ThreadPool& pool,
+                                     const uint32 frames_in_flight,
+                                     ShaderLibrary* library,
+                                     VkPipelineCache cache)
+    : mPool {&pool},
+      mLibrary {library},
+      mCache {cache},
+      mFramesInFlight {std::max(frames_in_flight, 1u)}
+{
+}
+
+ShaderHotReloader::~ShaderHotReloader() noexcept
+{
+  for (auto& entry : mEntries) {
+    if (entry.pending.has_value()) {
+      entry.pending->wait();
+    }
+  }
+}
+
+auto ShaderHotReloader::add(const GraphicsPipelineBuilder& builder, VkResult* result)
+    -> usize
+{
+  Entry entry {builder};
+
+  if (mCache != VK_NULL_HANDLE) {
+    entry.builder.with_cache(mCache);
+  }
+
+  for (const auto& path : builder.get_shader_paths()) {
+    auto file_path = normalize_file_path(path);
+    mWatcher.watch(file_path);
+    entry.shader_files.push_back(std::move(file_path));
+  }
+
+  entry.pipeline = entry.builder.build(&entry.result);
+
+  if (result) {
+    *result = entry.result;
+  }
+
+  mEntries.push_back(std::move(entry));
+  return mEntries.size() - 1;
+}
+
+auto ShaderHotReloader::reload(const std::filesystem::path& path) -> usize
+{
+  const auto file_path = normalize_file_path(path);
+
+  // Otherwise, the shader library would keep providing the old shader code
+  if (mLibrary) {
+    mLibrary->invalidate(file_path);
+  }
+
+  usize affected_count = 0;
+
+  for (auto& entry : mEntries) {
+    const auto& files = entry.shader_files;
+    if (std::find(files.begin(), files.end(), file_path) == files.end()) {
+      continue;
+    }
+
+    ++affected_count;
+
+    // Builders may use another library than the one given to the constructor
+    auto* builder_library = entry.builder.get_shader_library();
+    if (builder_library && builder_library != mLibrary) {
+      builder_library->invalidate(file_path);
+    }
+
+    // The pending rebuild may have read the old shader code
+    if (entry.pending.has_value()) {
+      entry.stale = true;
+    }
+    else {
+      _rebuild(entry);
+    }
+  }
+
+  return affected_count;
+}
+
+auto ShaderHotReloader::update() -> usize
+{
+  for (const auto& path : mWatcher.poll()) {
+    reload(path);
+  }
+
+  usize swap_count = 0;
+
+  for (auto& entry : mEntries) {
+    if (!entry.pending.has_value() ||
+        entry.pending->wait_for(std::chrono::seconds {0}) != std::future_status::ready) {
+      continue;
+    }
+
+    auto rebuilt = entry.pending->get();
+    entry.pending.reset();
+    entry.result = rebuilt.result;
+
+    if (rebuilt.pipeline) {
+      if (entry.pipeline) {
+        mRetired.push_back({std::move(entry.pipeline), mFrame});
+      }
+
+      entry.pipeline = std::move(rebuilt.pipeline);
+      ++swap_count;
+    }
+
+    if (entry.stale) {
+      entry.stale = false;
+      _rebuild(entry);
+    }
+  }
+
+  // Frames recorded before a pipeline was replaced may still be executing
+  std::erase_if(mRetired, [this](const RetiredPipeline& retired) {
+    return mFrame >= retired.frame + mFramesInFlight;
+  });
+
+  ++mFrame;
+
+  return swap_count;
+}
+
+auto ShaderHotReloader::get(const usize id) -> VkPipeline
+{
+  return (id < mEntries.size()) ? mEntries[id].pipeline.get() : VK_NULL_HANDLE;
+}
+
+auto ShaderHotReloader::result(const usize id) const -> VkResult
+{
+  return (id < mEntries.size()) ? mEntries[id].result : VK_ERROR_UNKNOWN;
+}
+
+auto ShaderHotReloader::pending_count() const -> usize
+{
+  return static_cast<usize>(
+      std::count_if(mEntries.begin(), mEntries.end(), [](const Entry& entry) {
+        return entry.pending.has_value();
+      }));
+}
+
+void ShaderHotReloader::_rebuild(Entry& entry)
+{
+  entry.pending = mPool->submit([builder = entry.builder] {
+    GraphicsPipelineResult rebuilt;
+    rebuilt.pipeline = builder.build(&rebuilt.result);
+    return rebuilt;
+  });
+}
+
+}  // namespace grace
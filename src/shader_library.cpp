@@ -0,0 +1,194 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/shader_library.hpp"
+
+#include "grace/file_watcher.hpp"
+
+namespace grace {
+
+ShaderLibrary::ShaderLibrary(VkDevice device)
+    : mDevice {device}
+{
+}
+
+void ShaderLibrary::clear() noexcept
+{
+  const std::scoped_lock lock {mMutex};
+
+  mPathKeys.clear();
+  mShaders.clear();
+}
+
+void ShaderLibrary::invalidate(const std::filesystem::path& path)
+{
+  const auto file_path = normalize_file_path(path);
+
+  const std::scoped_lock lock {mMutex};
+
+  std::erase_if(mPathKeys, [&](const auto& entry) {
+    return normalize_file_path(entry.first) == file_path;
+  });
+}
+
+auto ShaderLibrary::get_module(const std::filesystem::path& path, VkResult* result)
+    -> VkShaderModule
+{
+  const auto path_key = path.string();
+
+  {
+    const std::scoped_lock lock {mMutex};
+
+    if (const auto iter = mPathKeys.find(path_key); iter != mPathKeys.end()) {
+      if (result) {
+        *result = VK_SUCCESS;
+      }
+
+      return mShaders.at(iter->second).module.get();
+    }
+  }
+
+  // The file is read without holding the lock, so that other threads aren't blocked
+  VkResult read_result = VK_SUCCESS;
+  auto code = read_binary_file(path_key.c_str(), &read_result);
+
+  if (read_result != VK_SUCCESS || code.empty()) {
+    if (result) {
+      *result = (read_result != VK_SUCCESS) ? read_result : VK_ERROR_UNKNOWN;
+    }
+
+    return VK_NULL_HANDLE;
+  }
+
+  const auto hash = fnv1a_hash(code.data(), code.size());
+
+  const std::scoped_lock lock {mMutex};
+
+  const auto [module, key] = _get_or_create(code, hash, result);
+  if (module != VK_NULL_HANDLE) {
+    mPathKeys.try_emplace(path_key, key);
+  }
+
+  return module;
+}
+
+auto ShaderLibrary::get_module(const void* code, const usize code_size, VkResult* result)
+    -> VkShaderModule
+{
+  const std::string_view bytes {static_cast<const char*>(code), code_size};
+  const auto hash = fnv1a_hash(bytes.data(), bytes.size());
+
+  const std::scoped_lock lock {mMutex};
+  return _get_or_create(bytes, hash, result).first;
+}
+
+auto ShaderLibrary::get_reflection(const std::filesystem::path& path, VkResult* result)
+    -> ShaderReflection
+{
+  VkResult module_result = VK_SUCCESS;
+  if (get_module(path, &module_result) == VK_NULL_HANDLE) {
+    if (result) {
+      *result = module_result;
+    }
+
+    return {};
+  }
+
+  const std::scoped_lock lock {mMutex};
+
+  // The library may have been cleared after the module was loaded
+  const auto key_iter = mPathKeys.find(path.string());
+  if (key_iter == mPathKeys.end()) {
+    if (result) {
+      *result = VK_ERROR_UNKNOWN;
+    }
+
+    return {};
+  }
+
+  auto& entry = mShaders.at(key_iter->second);
+
+  if (!entry.reflection.has_value()) {
+    VkResult reflect_result = VK_SUCCESS;
+    auto reflection =
+        reflect_shader(entry.code.data(), entry.code.size(), &reflect_result);
+
+    if (reflect_result != VK_SUCCESS) {
+      if (result) {
+        *result = reflect_result;
+      }
+
+      return {};
+    }
+
+    entry.reflection = std::move(reflection);
+  }
+
+  if (result) {
+    *result = VK_SUCCESS;
+  }
+
+  return *entry.reflection;
+}
+
+auto ShaderLibrary::module_count() const -> usize
+{
+  const std::scoped_lock lock {mMutex};
+  return mShaders.size();
+}
+
+auto ShaderLibrary::_get_or_create(const std::string_view code,
+                                   const uint64 hash,
+                                   VkResult* result)
+    -> std::pair<VkShaderModule, uint64>
+{
+  auto key = hash;
+
+  // Hash collisions between different shaders are resolved by probing subsequent keys
+  auto iter = mShaders.find(key);
+  while (iter != mShaders.end() && iter->second.code != code) {
+    iter = mShaders.find(++key);
+  }
+
+  if (iter != mShaders.end()) {
+    if (result) {
+      *result = VK_SUCCESS;
+    }
+
+    return {iter->second.module.get(), key};
+  }
+
+  auto module = ShaderModule::make(mDevice, code.data(), code.size(), result);
+  if (!module) {
+    return {VK_NULL_HANDLE, key};
+  }
+
+  // The code is only copied once it's known to be new
+  const auto handle = module.get();
+  mShaders.try_emplace(key, ShaderEntry {std::string {code}, std::move(module)});
+
+  return {handle, key};
+}
+
+}  // namespace grace
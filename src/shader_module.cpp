@@ -24,9 +24,7 @@
 
 #include "grace/shader_module.hpp"
 
-#include <fstream>   // ifstream
-#include <ios>       // ios
-#include <iterator>  // istreambuf_iterator
+#include "grace/mapped_file.hpp"
 
 namespace grace {
 
@@ -44,24 +42,13 @@ auto make_shader_module_info(const void* code, const usize code_size)
 
 auto read_binary_file(const char* file_path, VkResult* result) -> std::string
 {
-  std::ifstream stream {file_path, std::ios::in | std::ios::binary};
-
-  if (stream.is_open() && stream.good()) {
-    std::string code {std::istreambuf_iterator {stream},
-                      std::istreambuf_iterator<char> {}};
-
-    if (result) {
-      *result = VK_SUCCESS;
-    }
-
-    return code;
-  }
-
-  if (result) {
-    *result = VK_ERROR_UNKNOWN;
+  const auto file = MappedFile::open(file_path, result);
+  if (!file || file.empty()) {
+    return {};
   }
 
-  return {};
+  // Copy the file contents with a single allocation
+  return {static_cast<const char*>(file.data()), file.size()};
 }
 
 ShaderModule::ShaderModule(VkDevice device, VkShaderModule shader_module) noexcept
@@ -136,8 +123,9 @@ auto ShaderModule::make(VkDevice device,
 auto ShaderModule::read(VkDevice device, const char* code_path, VkResult* result)
     -> ShaderModule
 {
+  // The mapped code is suitably aligned, so it can be used without copying it
   VkResult parse_result = VK_ERROR_UNKNOWN;
-  const auto code = read_binary_file(code_path, &parse_result);
+  const auto code = MappedFile::open(code_path, &parse_result);
 
   if (parse_result != VK_SUCCESS) {
     if (result) {
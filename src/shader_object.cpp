@@ -0,0 +1,494 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/shader_object.hpp"
+
+#include <algorithm>  // find
+#include <array>      // array
+#include <utility>    // move, pair
+
+#include "grace/device.hpp"
+
+namespace grace {
+
+#ifdef VK_EXT_shader_object
+
+auto get_shader_object_functions(VkDevice device) -> ShaderObjectFunctions
+{
+  ShaderObjectFunctions functions;
+
+#define GRACE_LOAD_FUNCTION(Name) functions.Name = get_function<PFN_##Name>(device, #Name)
+
+  GRACE_LOAD_FUNCTION(vkCreateShadersEXT);
+  GRACE_LOAD_FUNCTION(vkDestroyShaderEXT);
+  GRACE_LOAD_FUNCTION(vkCmdBindShadersEXT);
+
+  GRACE_LOAD_FUNCTION(vkCmdSetVertexInputEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetPrimitiveTopologyEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetPrimitiveRestartEnableEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetPatchControlPointsEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetViewportWithCountEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetScissorWithCountEXT);
+
+  GRACE_LOAD_FUNCTION(vkCmdSetRasterizerDiscardEnableEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetPolygonModeEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetCullModeEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetFrontFaceEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetDepthBiasEnableEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetDepthClampEnableEXT);
+
+  GRACE_LOAD_FUNCTION(vkCmdSetRasterizationSamplesEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetSampleMaskEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetAlphaToCoverageEnableEXT);
+
+  GRACE_LOAD_FUNCTION(vkCmdSetDepthTestEnableEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetDepthWriteEnableEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetDepthCompareOpEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetDepthBoundsTestEnableEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetStencilTestEnableEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetStencilOpEXT);
+
+  GRACE_LOAD_FUNCTION(vkCmdSetLogicOpEnableEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetLogicOpEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetColorBlendEnableEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetColorBlendEquationEXT);
+  GRACE_LOAD_FUNCTION(vkCmdSetColorWriteMaskEXT);
+
+#undef GRACE_LOAD_FUNCTION
+
+  return functions;
+}
+
+auto make_shader_object_info(
+    const VkShaderStageFlagBits stage,
+    const VkShaderStageFlags next_stage,
+    const std::span<const uint32> code,
+    const char* entry_name,
+    const std::span<const VkDescriptorSetLayout> set_layouts,
+    const std::span<const VkPushConstantRange> push_constant_ranges,
+    const VkSpecializationInfo* specialization) -> VkShaderCreateInfoEXT
+{
+  return {
+      .sType = VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT,
+      .pNext = nullptr,
+      .flags = 0,
+      .stage = stage,
+      .nextStage = next_stage,
+      .codeType = VK_SHADER_CODE_TYPE_SPIRV_EXT,
+      .codeSize = code.size_bytes(),
+      .pCode = code.data(),
+      .pName = entry_name,
+      .setLayoutCount = u32_size(set_layouts),
+      .pSetLayouts = set_layouts.data(),
+      .pushConstantRangeCount = u32_size(push_constant_ranges),
+      .pPushConstantRanges = push_constant_ranges.data(),
+      .pSpecializationInfo = specialization,
+  };
+}
+
+auto ShaderObject::make(VkDevice device,
+                        const ShaderObjectFunctions& functions,
+                        const VkShaderCreateInfoEXT& shader_info,
+                        VkResult* result) -> ShaderObject
+{
+  auto shaders = ShaderObject::make_all(device, functions, {&shader_info, 1}, result);
+
+  if (shaders.empty()) {
+    return {};
+  }
+
+  return std::move(shaders.front());
+}
+
+auto ShaderObject::make_all(VkDevice device,
+                            const ShaderObjectFunctions& functions,
+                            const std::span<const VkShaderCreateInfoEXT> shader_infos,
+                            VkResult* result) -> std::vector<ShaderObject>
+{
+  if (!functions.vkCreateShadersEXT) {
+    if (result) {
+      *result = VK_ERROR_EXTENSION_NOT_PRESENT;
+    }
+
+    return {};
+  }
+
+  const auto shader_count = u32_size(shader_infos);
+
+  std::vector<VkShaderEXT> handles(shader_count, VK_NULL_HANDLE);
+  const auto status = functions.vkCreateShadersEXT(device,
+                                                   shader_count,
+                                                   shader_infos.data(),
+                                                   nullptr,
+                                                   handles.data());
+
+  if (result) {
+    *result = status;
+  }
+
+  // Incompatible shader binaries leave some handles null, so those are destroyed too
+  if (status != VK_SUCCESS) {
+    for (const auto handle : handles) {
+      if (handle != VK_NULL_HANDLE) {
+        functions.vkDestroyShaderEXT(device, handle, nullptr);
+      }
+    }
+
+    return {};
+  }
+
+  std::vector<ShaderObject> shaders;
+  shaders.reserve(handles.size());
+
+  for (const auto handle : handles) {
+    shaders.emplace_back(device, handle, functions.vkDestroyShaderEXT);
+  }
+
+  return shaders;
+}
+
+ShaderObject::ShaderObject(VkDevice device,
+                           VkShaderEXT shader,
+                           PFN_vkDestroyShaderEXT destroy_function) noexcept
+    : mDevice {device},
+      mShader {shader},
+      mDestroyFunction {destroy_function}
+{
+}
+
+ShaderObject::ShaderObject(ShaderObject&& other) noexcept
+    : mDevice {other.mDevice},
+      mShader {other.mShader},
+      mDestroyFunction {other.mDestroyFunction}
+{
+  other.mDevice = VK_NULL_HANDLE;
+  other.mShader = VK_NULL_HANDLE;
+  other.mDestroyFunction = nullptr;
+}
+
+auto ShaderObject::operator=(ShaderObject&& other) noexcept -> ShaderObject&
+{
+  if (this != &other) {
+    destroy();
+
+    mDevice = other.mDevice;
+    mShader = other.mShader;
+    mDestroyFunction = other.mDestroyFunction;
+
+    other.mDevice = VK_NULL_HANDLE;
+    other.mShader = VK_NULL_HANDLE;
+    other.mDestroyFunction = nullptr;
+  }
+
+  return *this;
+}
+
+ShaderObject::~ShaderObject() noexcept
+{
+  destroy();
+}
+
+void ShaderObject::destroy() noexcept
+{
+  if (mShader != VK_NULL_HANDLE) {
+    mDestroyFunction(mDevice, mShader, nullptr);
+    mShader = VK_NULL_HANDLE;
+  }
+}
+
+void cmd_bind_graphics_shaders(const ShaderObjectFunctions& functions,
+                               VkCommandBuffer cmd_buf,
+                               const VkPhysicalDeviceFeatures& enabled_features,
+                               VkShaderEXT vertex_shader,
+                               VkShaderEXT fragment_shader)
+{
+  std::array<VkShaderStageFlagBits, 5> stages {};
+  std::array<VkShaderEXT, 5> shaders {};
+  uint32 stage_count = 0;
+
+  const auto add_stage = [&](const VkShaderStageFlagBits stage, VkShaderEXT shader) {
+    stages[stage_count] = stage;
+    shaders[stage_count] = shader;
+    ++stage_count;
+  };
+
+  add_stage(VK_SHADER_STAGE_VERTEX_BIT, vertex_shader);
+
+  if (enabled_features.tessellationShader) {
+    add_stage(VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT, VK_NULL_HANDLE);
+    add_stage(VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT, VK_NULL_HANDLE);
+  }
+
+  if (enabled_features.geometryShader) {
+    add_stage(VK_SHADER_STAGE_GEOMETRY_BIT, VK_NULL_HANDLE);
+  }
+
+  add_stage(VK_SHADER_STAGE_FRAGMENT_BIT, fragment_shader);
+
+  functions.vkCmdBindShadersEXT(cmd_buf, stage_count, stages.data(), shaders.data());
+}
+
+void cmd_set_graphics_state(const ShaderObjectFunctions& functions,
+                            VkCommandBuffer cmd_buf,
+                            const GraphicsPipelineBuilder& builder)
+{
+  const auto dynamic_state = builder.get_dynamic_state_info();
+  const std::span dynamic_states {dynamic_state.pDynamicStates,
+                                  dynamic_state.dynamicStateCount};
+
+  // States that are dynamic in the builder are set by the application instead
+  const auto is_baked = [&](const VkDynamicState state) {
+    return std::find(dynamic_states.begin(), dynamic_states.end(), state) ==
+           dynamic_states.end();
+  };
+
+  if (is_baked(VK_DYNAMIC_STATE_VERTEX_INPUT_EXT)) {
+    const auto vertex_input = builder.get_vertex_input_state_info();
+
+    std::vector<VkVertexInputBindingDescription2EXT> bindings;
+    bindings.reserve(vertex_input.vertexBindingDescriptionCount);
+
+    for (const auto& binding :
+         std::span {vertex_input.pVertexBindingDescriptions,
+                    vertex_input.vertexBindingDescriptionCount}) {
+      bindings.push_back({
+          .sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_BINDING_DESCRIPTION_2_EXT,
+          .pNext = nullptr,
+          .binding = binding.binding,
+          .stride = binding.stride,
+          .inputRate = binding.inputRate,
+          .divisor = 1,
+      });
+    }
+
+    std::vector<VkVertexInputAttributeDescription2EXT> attributes;
+    attributes.reserve(vertex_input.vertexAttributeDescriptionCount);
+
+    for (const auto& attribute :
+         std::span {vertex_input.pVertexAttributeDescriptions,
+                    vertex_input.vertexAttributeDescriptionCount}) {
+      attributes.push_back({
+          .sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT,
+          .pNext = nullptr,
+          .location = attribute.location,
+          .binding = attribute.binding,
+          .format = attribute.format,
+          .offset = attribute.offset,
+      });
+    }
+
+    functions.vkCmdSetVertexInputEXT(cmd_buf,
+                                     u32_size(bindings),
+                                     data_or_null(bindings),
+                                     u32_size(attributes),
+                                     data_or_null(attributes));
+  }
+
+  const auto input_assembly = builder.get_input_assembly_state_info();
+
+  if (is_baked(VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT)) {
+    functions.vkCmdSetPrimitiveTopologyEXT(cmd_buf, input_assembly.topology);
+  }
+
+  if (is_baked(VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT)) {
+    functions.vkCmdSetPrimitiveRestartEnableEXT(cmd_buf,
+                                                input_assembly.primitiveRestartEnable);
+  }
+
+  const auto tessellation = builder.get_tessellation_state_info();
+
+  if (tessellation.patchControlPoints != 0 &&
+      is_baked(VK_DYNAMIC_STATE_PATCH_CONTROL_POINTS_EXT)) {
+    functions.vkCmdSetPatchControlPointsEXT(cmd_buf, tessellation.patchControlPoints);
+  }
+
+  const auto viewport = builder.get_viewport_state_info();
+
+  if (viewport.pViewports) {
+    functions.vkCmdSetViewportWithCountEXT(cmd_buf,
+                                           viewport.viewportCount,
+                                           viewport.pViewports);
+  }
+
+  if (viewport.pScissors) {
+    functions.vkCmdSetScissorWithCountEXT(cmd_buf,
+                                          viewport.scissorCount,
+                                          viewport.pScissors);
+  }
+
+  const auto rasterization = builder.get_rasterization_state_info();
+
+  if (is_baked(VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE_EXT)) {
+    functions.vkCmdSetRasterizerDiscardEnableEXT(cmd_buf,
+                                                 rasterization.rasterizerDiscardEnable);
+  }
+
+  if (is_baked(VK_DYNAMIC_STATE_POLYGON_MODE_EXT)) {
+    functions.vkCmdSetPolygonModeEXT(cmd_buf, rasterization.polygonMode);
+  }
+
+  if (is_baked(VK_DYNAMIC_STATE_CULL_MODE_EXT)) {
+    functions.vkCmdSetCullModeEXT(cmd_buf, rasterization.cullMode);
+  }
+
+  if (is_baked(VK_DYNAMIC_STATE_FRONT_FACE_EXT)) {
+    functions.vkCmdSetFrontFaceEXT(cmd_buf, rasterization.frontFace);
+  }
+
+  if (is_baked(VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT)) {
+    functions.vkCmdSetDepthBiasEnableEXT(cmd_buf, rasterization.depthBiasEnable);
+  }
+
+  if (is_baked(VK_DYNAMIC_STATE_DEPTH_BIAS)) {
+    vkCmdSetDepthBias(cmd_buf,
+                      rasterization.depthBiasConstantFactor,
+                      rasterization.depthBiasClamp,
+                      rasterization.depthBiasSlopeFactor);
+  }
+
+  if (is_baked(VK_DYNAMIC_STATE_DEPTH_CLAMP_ENABLE_EXT)) {
+    functions.vkCmdSetDepthClampEnableEXT(cmd_buf, rasterization.depthClampEnable);
+  }
+
+  if (is_baked(VK_DYNAMIC_STATE_LINE_WIDTH)) {
+    vkCmdSetLineWidth(cmd_buf, rasterization.lineWidth);
+  }
+
+  const auto multisample = builder.get_multisample_state_info();
+
+  // The sample mask is all ones by default, which enables every sample
+  const VkSampleMask sample_mask = ~VkSampleMask {0};
+
+  functions.vkCmdSetRasterizationSamplesEXT(cmd_buf, multisample.rasterizationSamples);
+  functions.vkCmdSetSampleMaskEXT(
+      cmd_buf,
+      multisample.rasterizationSamples,
+      multisample.pSampleMask ? multisample.pSampleMask : &sample_mask);
+  functions.vkCmdSetAlphaToCoverageEnableEXT(cmd_buf, multisample.alphaToCoverageEnable);
+
+  const auto depth_stencil = builder.get_depth_stencil_state_info();
+
+  if (is_baked(VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT)) {
+    functions.vkCmdSetDepthTestEnableEXT(cmd_buf, depth_stencil.depthTestEnable);
+  }
+
+  if (is_baked(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT)) {
+    functions.vkCmdSetDepthWriteEnableEXT(cmd_buf, depth_stencil.depthWriteEnable);
+  }
+
+  if (is_baked(VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT)) {
+    functions.vkCmdSetDepthCompareOpEXT(cmd_buf, depth_stencil.depthCompareOp);
+  }
+
+  if (is_baked(VK_DYNAMIC_STATE_DEPTH_BOUNDS_TEST_ENABLE_EXT)) {
+    functions.vkCmdSetDepthBoundsTestEnableEXT(cmd_buf,
+                                               depth_stencil.depthBoundsTestEnable);
+  }
+
+  if (is_baked(VK_DYNAMIC_STATE_DEPTH_BOUNDS)) {
+    vkCmdSetDepthBounds(cmd_buf,
+                        depth_stencil.minDepthBounds,
+                        depth_stencil.maxDepthBounds);
+  }
+
+  if (is_baked(VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT)) {
+    functions.vkCmdSetStencilTestEnableEXT(cmd_buf, depth_stencil.stencilTestEnable);
+  }
+
+  const std::array stencil_faces = {
+      std::pair {VK_STENCIL_FACE_FRONT_BIT, depth_stencil.front},
+      std::pair {VK_STENCIL_FACE_BACK_BIT, depth_stencil.back},
+  };
+
+  for (const auto& [face, stencil] : stencil_faces) {
+    if (is_baked(VK_DYNAMIC_STATE_STENCIL_OP_EXT)) {
+      functions.vkCmdSetStencilOpEXT(cmd_buf,
+                                     face,
+                                     stencil.failOp,
+                                     stencil.passOp,
+                                     stencil.depthFailOp,
+                                     stencil.compareOp);
+    }
+
+    if (is_baked(VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK)) {
+      vkCmdSetStencilCompareMask(cmd_buf, face, stencil.compareMask);
+    }
+
+    if (is_baked(VK_DYNAMIC_STATE_STENCIL_WRITE_MASK)) {
+      vkCmdSetStencilWriteMask(cmd_buf, face, stencil.writeMask);
+    }
+
+    if (is_baked(VK_DYNAMIC_STATE_STENCIL_REFERENCE)) {
+      vkCmdSetStencilReference(cmd_buf, face, stencil.reference);
+    }
+  }
+
+  const auto color_blend = builder.get_color_blend_state_info();
+
+  if (is_baked(VK_DYNAMIC_STATE_LOGIC_OP_ENABLE_EXT)) {
+    functions.vkCmdSetLogicOpEnableEXT(cmd_buf, color_blend.logicOpEnable);
+  }
+
+  if (color_blend.logicOpEnable && is_baked(VK_DYNAMIC_STATE_LOGIC_OP_EXT)) {
+    functions.vkCmdSetLogicOpEXT(cmd_buf, color_blend.logicOp);
+  }
+
+  const std::span attachments {color_blend.pAttachments, color_blend.attachmentCount};
+
+  if (!attachments.empty()) {
+    std::vector<VkBool32> blend_enables;
+    std::vector<VkColorBlendEquationEXT> blend_equations;
+    std::vector<VkColorComponentFlags> write_masks;
+
+    blend_enables.reserve(attachments.size());
+    blend_equations.reserve(attachments.size());
+    write_masks.reserve(attachments.size());
+
+    for (const auto& attachment : attachments) {
+      blend_enables.push_back(attachment.blendEnable);
+      blend_equations.push_back({
+          .srcColorBlendFactor = attachment.srcColorBlendFactor,
+          .dstColorBlendFactor = attachment.dstColorBlendFactor,
+          .colorBlendOp = attachment.colorBlendOp,
+          .srcAlphaBlendFactor = attachment.srcAlphaBlendFactor,
+          .dstAlphaBlendFactor = attachment.dstAlphaBlendFactor,
+          .alphaBlendOp = attachment.alphaBlendOp,
+      });
+      write_masks.push_back(attachment.colorWriteMask);
+    }
+
+    const auto count = u32_size(attachments);
+    functions.vkCmdSetColorBlendEnableEXT(cmd_buf, 0, count, blend_enables.data());
+    functions.vkCmdSetColorBlendEquationEXT(cmd_buf, 0, count, blend_equations.data());
+    functions.vkCmdSetColorWriteMaskEXT(cmd_buf, 0, count, write_masks.data());
+  }
+
+  if (is_baked(VK_DYNAMIC_STATE_BLEND_CONSTANTS)) {
+    vkCmdSetBlendConstants(cmd_buf, color_blend.blendConstants);
+  }
+}
+
+#endif  // VK_EXT_shader_object
+
+}  // namespace grace
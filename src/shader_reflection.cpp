@@ -0,0 +1,794 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/shader_reflection.hpp"
+
+#include <algorithm>      // min, max, sort, find, find_if
+#include <cstring>        // memcpy
+#include <optional>       // optional
+#include <string>         // string
+#include <span>           // span
+#include <tuple>          // tie
+#include <unordered_map>  // unordered_map
+#include <utility>        // pair
+
+#include "grace/descriptor_set_layout.hpp"
+#include "grace/pipeline.hpp"
+#include "grace/pipeline_layout.hpp"
+
+namespace grace {
+namespace {
+
+// See the SPIR-V specification for the meaning of these values.
+inline constexpr uint32 kSpirvMagic = 0x07230203;
+inline constexpr usize kSpirvHeaderWordCount = 5;
+
+// Guards against cyclic or absurdly nested types in malformed code.
+inline constexpr uint32 kMaxTypeDepth = 32;
+
+inline constexpr uint32 kOpEntryPoint = 15;
+inline constexpr uint32 kOpExecutionMode = 16;
+inline constexpr uint32 kOpTypeBool = 20;
+inline constexpr uint32 kOpTypeInt = 21;
+inline constexpr uint32 kOpTypeFloat = 22;
+inline constexpr uint32 kOpTypeVector = 23;
+inline constexpr uint32 kOpTypeMatrix = 24;
+inline constexpr uint32 kOpTypeImage = 25;
+inline constexpr uint32 kOpTypeSampler = 26;
+inline constexpr uint32 kOpTypeSampledImage = 27;
+inline constexpr uint32 kOpTypeArray = 28;
+inline constexpr uint32 kOpTypeRuntimeArray = 29;
+inline constexpr uint32 kOpTypeStruct = 30;
+inline constexpr uint32 kOpTypePointer = 32;
+inline constexpr uint32 kOpConstant = 43;
+inline constexpr uint32 kOpSpecConstant = 50;
+inline constexpr uint32 kOpVariable = 59;
+inline constexpr uint32 kOpDecorate = 71;
+inline constexpr uint32 kOpMemberDecorate = 72;
+inline constexpr uint32 kOpTypeAccelerationStructure = 5341;
+
+inline constexpr uint32 kDecorationBlock = 2;
+inline constexpr uint32 kDecorationBufferBlock = 3;
+inline constexpr uint32 kDecorationArrayStride = 6;
+inline constexpr uint32 kDecorationMatrixStride = 7;
+inline constexpr uint32 kDecorationBuiltIn = 11;
+inline constexpr uint32 kDecorationLocation = 30;
+inline constexpr uint32 kDecorationBinding = 33;
+inline constexpr uint32 kDecorationDescriptorSet = 34;
+inline constexpr uint32 kDecorationOffset = 35;
+
+inline constexpr uint32 kStorageClassUniformConstant = 0;
+inline constexpr uint32 kStorageClassInput = 1;
+inline constexpr uint32 kStorageClassUniform = 2;
+inline constexpr uint32 kStorageClassPushConstant = 9;
+inline constexpr uint32 kStorageClassStorageBuffer = 12;
+
+inline constexpr uint32 kExecutionModeLocalSize = 17;
+
+inline constexpr uint32 kDimBuffer = 5;
+inline constexpr uint32 kDimSubpassData = 6;
+
+struct SpirvDecorations final {
+  std::optional<uint32> set;
+  std::optional<uint32> binding;
+  std::optional<uint32> location;
+  uint32 array_stride {0};
+  bool block        : 1 {false};
+  bool buffer_block : 1 {false};
+  bool builtin      : 1 {false};
+};
+
+struct SpirvMember final {
+  uint32 offset {0};
+  uint32 matrix_stride {0};
+};
+
+struct SpirvType final {
+  uint32 opcode {0};
+  std::vector<uint32> operands;  // Excluding the result identifier
+};
+
+struct SpirvVariable final {
+  uint32 id {0};
+  uint32 type {0};
+  uint32 storage_class {0};
+};
+
+[[nodiscard]] auto get_stage(const uint32 execution_model) -> VkShaderStageFlags
+{
+  switch (execution_model) {
+    case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+    case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+    case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+    case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+    case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+    case 5: return VK_SHADER_STAGE_COMPUTE_BIT;
+    default: return 0;
+  }
+}
+
+[[nodiscard]] auto get_vertex_format(const SpirvType& component,
+                                     const uint32 component_count) -> VkFormat
+{
+  if (component_count < 1 || component_count > 4 || component.operands.empty()) {
+    return VK_FORMAT_UNDEFINED;
+  }
+
+  const auto width = component.operands[0];
+  const auto index = static_cast<usize>(component_count - 1);
+
+  if (component.opcode == kOpTypeFloat && width == 32) {
+    constexpr std::array formats = {VK_FORMAT_R32_SFLOAT,
+                                    VK_FORMAT_R32G32_SFLOAT,
+                                    VK_FORMAT_R32G32B32_SFLOAT,
+                                    VK_FORMAT_R32G32B32A32_SFLOAT};
+    return formats[index];
+  }
+
+  if (component.opcode == kOpTypeFloat && width == 64) {
+    constexpr std::array formats = {VK_FORMAT_R64_SFLOAT,
+                                    VK_FORMAT_R64G64_SFLOAT,
+                                    VK_FORMAT_R64G64B64_SFLOAT,
+                                    VK_FORMAT_R64G64B64A64_SFLOAT};
+    return formats[index];
+  }
+
+  if (component.opcode == kOpTypeFloat && width == 16) {
+    constexpr std::array formats = {VK_FORMAT_R16_SFLOAT,
+                                    VK_FORMAT_R16G16_SFLOAT,
+                                    VK_FORMAT_R16G16B16_SFLOAT,
+                                    VK_FORMAT_R16G16B16A16_SFLOAT};
+    return formats[index];
+  }
+
+  if (component.opcode == kOpTypeInt && width == 32) {
+    const auto is_signed = component.operands.size() > 1 && component.operands[1] != 0;
+
+    constexpr std::array signed_formats = {VK_FORMAT_R32_SINT,
+                                           VK_FORMAT_R32G32_SINT,
+                                           VK_FORMAT_R32G32B32_SINT,
+                                           VK_FORMAT_R32G32B32A32_SINT};
+    constexpr std::array unsigned_formats = {VK_FORMAT_R32_UINT,
+                                             VK_FORMAT_R32G32_UINT,
+                                             VK_FORMAT_R32G32B32_UINT,
+                                             VK_FORMAT_R32G32B32A32_UINT};
+    return is_signed ? signed_formats[index] : unsigned_formats[index];
+  }
+
+  return VK_FORMAT_UNDEFINED;
+}
+
+// A minimal SPIR-V parser that only tracks what's needed for reflection.
+class SpirvModule final {
+ public:
+  [[nodiscard]] auto parse(std::span<const uint32> words) -> bool;
+
+  [[nodiscard]] auto reflect() const -> ShaderReflection;
+
+ private:
+  std::unordered_map<uint32, SpirvType> mTypes;
+  std::unordered_map<uint32, uint32> mConstants;
+  std::unordered_map<uint32, SpirvDecorations> mDecorations;
+  std::unordered_map<uint64, SpirvMember> mMembers;
+  std::vector<SpirvVariable> mVariables;
+  std::string mEntryPoint;
+  std::array<uint32, 3> mLocalSize {};
+  uint32 mEntryPointId {0};
+  uint32 mExecutionModel {0};
+  bool mHasEntryPoint {false};
+
+  [[nodiscard]] static auto _member_key(const uint32 id, const uint32 member) -> uint64
+  {
+    return (static_cast<uint64>(id) << 32u) | static_cast<uint64>(member);
+  }
+
+  [[nodiscard]] auto _find_type(uint32 id) const -> const SpirvType*;
+
+  [[nodiscard]] auto _find_decorations(uint32 id) const -> const SpirvDecorations*;
+
+  [[nodiscard]] auto _get_size(uint32 type_id,
+                               uint32 matrix_stride = 0,
+                               uint32 depth = 0) const -> uint32;
+
+  [[nodiscard]] auto _get_descriptor_type(const SpirvType& type,
+                                          uint32 type_id,
+                                          uint32 storage_class) const
+      -> std::optional<VkDescriptorType>;
+
+  void _reflect_descriptor(const SpirvVariable& variable,
+                           ShaderReflection& reflection) const;
+
+  void _reflect_push_constants(const SpirvVariable& variable,
+                               ShaderReflection& reflection) const;
+
+  void _reflect_vertex_input(const SpirvVariable& variable,
+                             ShaderReflection& reflection) const;
+};
+
+auto SpirvModule::parse(const std::span<const uint32> words) -> bool
+{
+  if (words.size() < kSpirvHeaderWordCount || words[0] != kSpirvMagic) {
+    return false;
+  }
+
+  usize offset = kSpirvHeaderWordCount;
+  while (offset < words.size()) {
+    const auto opcode = words[offset] & 0xFFFFu;
+    const auto word_count = static_cast<usize>(words[offset] >> 16u);
+
+    if (word_count == 0 || offset + word_count > words.size()) {
+      return false;
+    }
+
+    const auto operands = words.subspan(offset + 1, word_count - 1);
+    offset += word_count;
+
+    switch (opcode) {
+      case kOpEntryPoint: {
+        if (mHasEntryPoint || operands.size() < 3) {
+          break;
+        }
+
+        mHasEntryPoint = true;
+        mExecutionModel = operands[0];
+        mEntryPointId = operands[1];
+
+        // The name is a nul-terminated string packed into little-endian words
+        const auto name = operands.subspan(2);
+        const auto* name_begin = reinterpret_cast<const char*>(name.data());
+        const auto* name_end = name_begin + name.size() * sizeof(uint32);
+        mEntryPoint.assign(name_begin, std::find(name_begin, name_end, '\0'));
+        break;
+      }
+      case kOpExecutionMode: {
+        if (operands.size() >= 5 && operands[0] == mEntryPointId &&
+            operands[1] == kExecutionModeLocalSize) {
+          mLocalSize = {operands[2], operands[3], operands[4]};
+        }
+        break;
+      }
+      case kOpTypeBool:
+      case kOpTypeInt:
+      case kOpTypeFloat:
+      case kOpTypeVector:
+      case kOpTypeMatrix:
+      case kOpTypeImage:
+      case kOpTypeSampler:
+      case kOpTypeSampledImage:
+      case kOpTypeArray:
+      case kOpTypeRuntimeArray:
+      case kOpTypeStruct:
+      case kOpTypePointer:
+      case kOpTypeAccelerationStructure: {
+        if (!operands.empty()) {
+          auto& type = mTypes[operands[0]];
+          type.opcode = opcode;
+          type.operands.assign(operands.begin() + 1, operands.end());
+        }
+        break;
+      }
+      case kOpConstant:
+      case kOpSpecConstant: {
+        // Only 32-bit constants matter, since they're used as array lengths.
+        // Specialization constants are assumed to keep their default values.
+        if (operands.size() >= 3) {
+          mConstants[operands[1]] = operands[2];
+        }
+        break;
+      }
+      case kOpVariable: {
+        if (operands.size() >= 3) {
+          mVariables.push_back({operands[1], operands[0], operands[2]});
+        }
+        break;
+      }
+      case kOpDecorate: {
+        if (operands.size() < 2) {
+          break;
+        }
+
+        auto& decorations = mDecorations[operands[0]];
+        const auto value = (operands.size() >= 3) ? operands[2] : 0u;
+
+        switch (operands[1]) {
+          case kDecorationBlock: decorations.block = true; break;
+          case kDecorationBufferBlock: decorations.buffer_block = true; break;
+          case kDecorationArrayStride: decorations.array_stride = value; break;
+          case kDecorationBuiltIn: decorations.builtin = true; break;
+          case kDecorationLocation: decorations.location = value; break;
+          case kDecorationBinding: decorations.binding = value; break;
+          case kDecorationDescriptorSet: decorations.set = value; break;
+          default: break;
+        }
+        break;
+      }
+      case kOpMemberDecorate: {
+        if (operands.size() < 4) {
+          break;
+        }
+
+        auto& member = mMembers[_member_key(operands[0], operands[1])];
+
+        if (operands[2] == kDecorationOffset) {
+          member.offset = operands[3];
+        }
+        else if (operands[2] == kDecorationMatrixStride) {
+          member.matrix_stride = operands[3];
+        }
+        break;
+      }
+      default: break;
+    }
+  }
+
+  return mHasEntryPoint;
+}
+
+auto SpirvModule::reflect() const -> ShaderReflection
+{
+  ShaderReflection reflection;
+  reflection.stages = get_stage(mExecutionModel);
+  reflection.entry_point = mEntryPoint;
+  reflection.local_size = mLocalSize;
+
+  for (const auto& variable : mVariables) {
+    switch (variable.storage_class) {
+      case kStorageClassUniformConstant:
+      case kStorageClassUniform:
+      case kStorageClassStorageBuffer:
+        _reflect_descriptor(variable, reflection);
+        break;
+
+      case kStorageClassPushConstant:
+        _reflect_push_constants(variable, reflection);
+        break;
+
+      case kStorageClassInput:
+        if (reflection.stages == VK_SHADER_STAGE_VERTEX_BIT) {
+          _reflect_vertex_input(variable, reflection);
+        }
+        break;
+
+      default: break;
+    }
+  }
+
+  std::sort(reflection.descriptors.begin(),
+            reflection.descriptors.end(),
+            [](const ShaderDescriptorBinding& a, const ShaderDescriptorBinding& b) {
+              return std::tie(a.set, a.binding) < std::tie(b.set, b.binding);
+            });
+
+  std::sort(reflection.vertex_inputs.begin(),
+            reflection.vertex_inputs.end(),
+            [](const ShaderVertexInput& a, const ShaderVertexInput& b) {
+              return a.location < b.location;
+            });
+
+  return reflection;
+}
+
+auto SpirvModule::_find_type(const uint32 id) const -> const SpirvType*
+{
+  const auto iter = mTypes.find(id);
+  return (iter != mTypes.end()) ? &iter->second : nullptr;
+}
+
+auto SpirvModule::_find_decorations(const uint32 id) const -> const SpirvDecorations*
+{
+  const auto iter = mDecorations.find(id);
+  return (iter != mDecorations.end()) ? &iter->second : nullptr;
+}
+
+auto SpirvModule::_get_size(const uint32 type_id,
+                            const uint32 matrix_stride,
+                            const uint32 depth) const -> uint32
+{
+  const auto* type = _find_type(type_id);
+  if (!type || depth > kMaxTypeDepth) {
+    return 0;
+  }
+
+  const auto& operands = type->operands;
+
+  switch (type->opcode) {
+    case kOpTypeBool: return 4;
+
+    case kOpTypeInt:
+    case kOpTypeFloat: return !operands.empty() ? operands[0] / 8u : 0u;
+
+    case kOpTypeVector:
+      return (operands.size() >= 2) ? operands[1] * _get_size(operands[0], 0, depth + 1)
+                                    : 0u;
+
+    case kOpTypeMatrix: {
+      if (operands.size() < 2) {
+        return 0;
+      }
+
+      const auto column_size = _get_size(operands[0], 0, depth + 1);
+      const auto column_stride = (matrix_stride != 0) ? matrix_stride : column_size;
+
+      // The last column doesn't include any padding
+      return (operands[1] - 1) * column_stride + column_size;
+    }
+    case kOpTypeArray: {
+      if (operands.size() < 2 || !mConstants.contains(operands[1])) {
+        return 0;
+      }
+
+      const auto* decorations = _find_decorations(type_id);
+      const auto length = mConstants.at(operands[1]);
+      const auto element_size = _get_size(operands[0], matrix_stride, depth + 1);
+      const auto stride = (decorations && decorations->array_stride != 0)
+                              ? decorations->array_stride
+                              : element_size;
+
+      return (length > 0) ? (length - 1) * stride + element_size : 0u;
+    }
+    case kOpTypeStruct: {
+      uint32 size = 0;
+
+      for (uint32 index = 0; index < static_cast<uint32>(operands.size()); ++index) {
+        SpirvMember member;
+        if (const auto iter = mMembers.find(_member_key(type_id, index));
+            iter != mMembers.end()) {
+          member = iter->second;
+        }
+
+        const auto member_size =
+            _get_size(operands[index], member.matrix_stride, depth + 1);
+        size = std::max(size, member.offset + member_size);
+      }
+
+      return size;
+    }
+    default: return 0;
+  }
+}
+
+auto SpirvModule::_get_descriptor_type(const SpirvType& type,
+                                       const uint32 type_id,
+                                       const uint32 storage_class) const
+    -> std::optional<VkDescriptorType>
+{
+  switch (type.opcode) {
+    case kOpTypeSampler: return VK_DESCRIPTOR_TYPE_SAMPLER;
+
+    case kOpTypeSampledImage: return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+
+    case kOpTypeImage: {
+      if (type.operands.size() < 6) {
+        return std::nullopt;
+      }
+
+      const auto dim = type.operands[1];
+      const auto is_storage = type.operands[5] == 2;
+
+      if (dim == kDimBuffer) {
+        return is_storage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER
+                          : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+      }
+
+      if (dim == kDimSubpassData) {
+        return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+      }
+
+      return is_storage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+                        : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    }
+    case kOpTypeStruct: {
+      const auto* decorations = _find_decorations(type_id);
+
+      if (storage_class == kStorageClassStorageBuffer ||
+          (decorations && decorations->buffer_block)) {
+        return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+      }
+
+      return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    }
+
+#ifdef VK_KHR_acceleration_structure
+    case kOpTypeAccelerationStructure:
+      return VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+#endif  // VK_KHR_acceleration_structure
+
+    default: return std::nullopt;
+  }
+}
+
+void SpirvModule::_reflect_descriptor(const SpirvVariable& variable,
+                                      ShaderReflection& reflection) const
+{
+  const auto* decorations = _find_decorations(variable.id);
+  if (!decorations || !decorations->binding.has_value()) {
+    return;
+  }
+
+  const auto* pointer = _find_type(variable.type);
+  if (!pointer || pointer->opcode != kOpTypePointer || pointer->operands.size() < 2) {
+    return;
+  }
+
+  uint32 count = 1;
+  uint32 type_id = pointer->operands[1];
+  const auto* type = _find_type(type_id);
+
+  // Unwrap (possibly nested) descriptor arrays
+  uint32 depth = 0;
+  while (type && (type->opcode == kOpTypeArray || type->opcode == kOpTypeRuntimeArray)) {
+    if (++depth > kMaxTypeDepth) {
+      return;
+    }
+
+    if (type->opcode == kOpTypeRuntimeArray || type->operands.size() < 2) {
+      count = 0;
+    }
+    else if (const auto iter = mConstants.find(type->operands[1]);
+             iter != mConstants.end()) {
+      count *= iter->second;
+    }
+
+    type_id = type->operands[0];
+    type = _find_type(type_id);
+  }
+
+  if (!type) {
+    return;
+  }
+
+  const auto descriptor_type =
+      _get_descriptor_type(*type, type_id, variable.storage_class);
+  if (!descriptor_type.has_value()) {
+    return;
+  }
+
+  ShaderDescriptorBinding descriptor;
+  descriptor.set = decorations->set.value_or(0);
+  descriptor.binding = *decorations->binding;
+  descriptor.type = *descriptor_type;
+  descriptor.count = count;
+  descriptor.stages = reflection.stages;
+
+  reflection.descriptors.push_back(descriptor);
+}
+
+void SpirvModule::_reflect_push_constants(const SpirvVariable& variable,
+                                          ShaderReflection& reflection) const
+{
+  const auto* pointer = _find_type(variable.type);
+  if (!pointer || pointer->opcode != kOpTypePointer || pointer->operands.size() < 2) {
+    return;
+  }
+
+  const auto struct_id = pointer->operands[1];
+  const auto* type = _find_type(struct_id);
+  if (!type || type->opcode != kOpTypeStruct || type->operands.empty()) {
+    return;
+  }
+
+  auto offset = kMaxU32;
+  for (uint32 index = 0; index < static_cast<uint32>(type->operands.size()); ++index) {
+    const auto iter = mMembers.find(_member_key(struct_id, index));
+    offset = std::min(offset, (iter != mMembers.end()) ? iter->second.offset : 0u);
+  }
+
+  reflection.push_constant_offset = offset;
+  reflection.push_constant_size = _get_size(struct_id) - offset;
+}
+
+void SpirvModule::_reflect_vertex_input(const SpirvVariable& variable,
+                                        ShaderReflection& reflection) const
+{
+  const auto* decorations = _find_decorations(variable.id);
+  if (!decorations || decorations->builtin || !decorations->location.has_value()) {
+    return;
+  }
+
+  const auto* pointer = _find_type(variable.type);
+  if (!pointer || pointer->opcode != kOpTypePointer || pointer->operands.size() < 2) {
+    return;
+  }
+
+  const auto* type = _find_type(pointer->operands[1]);
+  if (!type) {
+    return;
+  }
+
+  // Matrices occupy one location per column
+  uint32 location_count = 1;
+  if (type->opcode == kOpTypeMatrix && type->operands.size() >= 2) {
+    location_count = type->operands[1];
+    type = _find_type(type->operands[0]);
+  }
+
+  if (!type) {
+    return;
+  }
+
+  const SpirvType* component = type;
+  uint32 component_count = 1;
+
+  if (type->opcode == kOpTypeVector && type->operands.size() >= 2) {
+    component = _find_type(type->operands[0]);
+    component_count = type->operands[1];
+  }
+
+  if (!component) {
+    return;
+  }
+
+  // Skip inputs without a matching vertex format, e.g. 8-bit integers
+  const auto format = get_vertex_format(*component, component_count);
+  if (format == VK_FORMAT_UNDEFINED) {
+    return;
+  }
+
+  const auto size = component_count * (!component->operands.empty()
+                                           ? component->operands[0] / 8u
+                                           : 0u);
+
+  for (uint32 index = 0; index < location_count; ++index) {
+    reflection.vertex_inputs.push_back({*decorations->location + index, format, size});
+  }
+}
+
+}  // namespace
+
+auto reflect_shader(const void* code, const usize code_size, VkResult* result)
+    -> ShaderReflection
+{
+  if (!code || code_size % sizeof(uint32) != 0) {
+    if (result) {
+      *result = VK_ERROR_UNKNOWN;
+    }
+
+    return {};
+  }
+
+  // The code isn't necessarily aligned to word boundaries
+  std::vector<uint32> words;
+  words.resize(code_size / sizeof(uint32));
+  std::memcpy(words.data(), code, code_size);
+
+  SpirvModule module;
+  if (!module.parse(words)) {
+    if (result) {
+      *result = VK_ERROR_UNKNOWN;
+    }
+
+    return {};
+  }
+
+  if (result) {
+    *result = VK_SUCCESS;
+  }
+
+  return module.reflect();
+}
+
+auto merge_shader_reflections(const ShaderReflection& a, const ShaderReflection& b)
+    -> ShaderReflection
+{
+  ShaderReflection merged = a;
+  merged.stages |= b.stages;
+
+  if (merged.entry_point.empty()) {
+    merged.entry_point = b.entry_point;
+  }
+
+  for (const auto& descriptor : b.descriptors) {
+    const auto iter = std::find_if(merged.descriptors.begin(),
+                                   merged.descriptors.end(),
+                                   [&](const ShaderDescriptorBinding& other) {
+                                     return other.set == descriptor.set &&
+                                            other.binding == descriptor.binding;
+                                   });
+
+    if (iter != merged.descriptors.end()) {
+      iter->stages |= descriptor.stages;
+    }
+    else {
+      merged.descriptors.push_back(descriptor);
+    }
+  }
+
+  std::sort(merged.descriptors.begin(),
+            merged.descriptors.end(),
+            [](const ShaderDescriptorBinding& x, const ShaderDescriptorBinding& y) {
+              return std::tie(x.set, x.binding) < std::tie(y.set, y.binding);
+            });
+
+  // Only vertex shaders have reflected vertex inputs
+  if (merged.vertex_inputs.empty()) {
+    merged.vertex_inputs = b.vertex_inputs;
+  }
+
+  if (b.push_constant_size != 0) {
+    if (merged.push_constant_size == 0) {
+      merged.push_constant_offset = b.push_constant_offset;
+      merged.push_constant_size = b.push_constant_size;
+    }
+    else {
+      const auto begin = std::min(a.push_constant_offset, b.push_constant_offset);
+      const auto end = std::max(a.push_constant_offset + a.push_constant_size,
+                                b.push_constant_offset + b.push_constant_size);
+
+      merged.push_constant_offset = begin;
+      merged.push_constant_size = end - begin;
+    }
+  }
+
+  if (merged.local_size == std::array<uint32, 3> {}) {
+    merged.local_size = b.local_size;
+  }
+
+  return merged;
+}
+
+void populate_descriptor_set_layout(const ShaderReflection& reflection,
+                                    const uint32 set,
+                                    DescriptorSetLayoutBuilder& builder,
+                                    const uint32 runtime_array_count)
+{
+  for (const auto& descriptor : reflection.descriptors) {
+    if (descriptor.set == set) {
+      const auto count =
+          (descriptor.count != 0) ? descriptor.count : runtime_array_count;
+      builder.descriptor(descriptor.binding, descriptor.type, descriptor.stages, count);
+    }
+  }
+}
+
+void populate_push_constants(const ShaderReflection& reflection,
+                             PipelineLayoutBuilder& builder)
+{
+  if (reflection.push_constant_size != 0) {
+    builder.push_constant(reflection.stages,
+                          reflection.push_constant_offset,
+                          reflection.push_constant_size);
+  }
+}
+
+void populate_vertex_input(const ShaderReflection& reflection,
+                           GraphicsPipelineBuilder& builder,
+                           const uint32 binding)
+{
+  uint32 offset = 0;
+
+  for (const auto& input : reflection.vertex_inputs) {
+    if (input.format == VK_FORMAT_UNDEFINED) {
+      continue;
+    }
+
+    builder.vertex_attribute(binding, input.location, input.format, offset);
+    offset += input.size;
+  }
+
+  if (offset != 0) {
+    builder.vertex_input_binding(binding, offset);
+  }
+}
+
+}  // namespace grace
@@ -0,0 +1,93 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/specialization_constants.hpp"
+
+#include <algorithm>  // lower_bound
+#include <cstring>    // memcpy
+
+namespace grace {
+
+void SpecializationConstants::clear() noexcept
+{
+  mConstants.clear();
+  mEntries.clear();
+  mData.clear();
+}
+
+auto SpecializationConstants::info() const noexcept -> VkSpecializationInfo
+{
+  return {
+      .mapEntryCount = u32_size(mEntries),
+      .pMapEntries = data_or_null(mEntries),
+      .dataSize = mData.size(),
+      .pData = data_or_null(mData),
+  };
+}
+
+void SpecializationConstants::_set(const uint32 constant_id,
+                                   const void* value,
+                                   const usize value_size)
+{
+  Constant constant;
+  constant.id = constant_id;
+  constant.size = static_cast<uint32>(value_size);
+  std::memcpy(constant.value.data(), value, value_size);
+
+  // Constants are kept sorted, so that equal sets always produce equal data
+  const auto iter = std::lower_bound(
+      mConstants.begin(),
+      mConstants.end(),
+      constant_id,
+      [](const Constant& existing, const uint32 id) { return existing.id < id; });
+
+  if (iter != mConstants.end() && iter->id == constant_id) {
+    *iter = constant;
+  }
+  else {
+    mConstants.insert(iter, constant);
+  }
+
+  _update_map();
+}
+
+void SpecializationConstants::_update_map()
+{
+  mEntries.clear();
+  mData.clear();
+
+  for (const auto& constant : mConstants) {
+    mEntries.push_back(VkSpecializationMapEntry {
+        .constantID = constant.id,
+        .offset = static_cast<uint32>(mData.size()),
+        .size = constant.size,
+    });
+
+    mData.insert(mData.end(),
+                 constant.value.begin(),
+                 constant.value.begin() + constant.size);
+  }
+}
+
+}  // namespace grace
@@ -164,7 +164,8 @@ Swapchain::Swapchain(Swapchain&& other) noexcept
       mDepthBuffer {std::move(other.mDepthBuffer)},
       mImages {std::move(other.mImages)},
       mImageViews {std::move(other.mImageViews)},
-      mFramebuffers {std::move(other.mFramebuffers)}
+      mFramebuffers {std::move(other.mFramebuffers)},
+      mUsesFramebuffers {other.mUsesFramebuffers}
 {
   other.mSurface = VK_NULL_HANDLE;
   other.mDevice = VK_NULL_HANDLE;
@@ -187,6 +188,7 @@ auto Swapchain::operator=(Swapchain&& other) noexcept -> Swapchain&
     mImages = std::move(other.mImages);
     mImageViews = std::move(other.mImageViews);
     mFramebuffers = std::move(other.mFramebuffers);
+    mUsesFramebuffers = other.mUsesFramebuffers;
 
     other.mSurface = VK_NULL_HANDLE;
     other.mDevice = VK_NULL_HANDLE;
@@ -337,9 +339,13 @@ auto Swapchain::recreate(VkRenderPass render_pass) -> VkResult
     }
   }
 
-  result = new_swapchain._recreate_framebuffers(render_pass);
-  if (result != VK_SUCCESS) {
-    return result;
+  // Framebuffers are not needed with dynamic rendering
+  new_swapchain.mUsesFramebuffers = render_pass != VK_NULL_HANDLE;
+  if (new_swapchain.mUsesFramebuffers) {
+    result = new_swapchain._recreate_framebuffers(render_pass);
+    if (result != VK_SUCCESS) {
+      return result;
+    }
   }
 
   *this = std::move(new_swapchain);
@@ -402,14 +408,13 @@ auto Swapchain::_recreate_depth_buffer() -> VkResult
 
   const uint32 mip_levels = 1;
 
-  auto image = Image::make(mAllocator,
-                           VK_IMAGE_TYPE_2D,
-                           {mInfo.image_extent.width, mInfo.image_extent.height, 1},
-                           mInfo.depth_buffer_format,
-                           VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-                           mip_levels,
-                           VK_SAMPLE_COUNT_1_BIT,
-                           &result);
+  auto image =
+      Image::make_transient(mAllocator,
+                            {mInfo.image_extent.width, mInfo.image_extent.height, 1},
+                            mInfo.depth_buffer_format,
+                            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                            VK_SAMPLE_COUNT_1_BIT,
+                            &result);
   if (result != VK_SUCCESS) {
     return result;
   }
@@ -471,6 +476,28 @@ auto Swapchain::get_current_framebuffer() -> VkFramebuffer
   return VK_NULL_HANDLE;
 }
 
+auto Swapchain::get_current_image() -> VkImage
+{
+  const auto current_index = static_cast<usize>(mImageIndex);
+
+  if (is_ready() && current_index < mImages.size()) {
+    return mImages[current_index];
+  }
+
+  return VK_NULL_HANDLE;
+}
+
+auto Swapchain::get_current_image_view() -> VkImageView
+{
+  const auto current_index = static_cast<usize>(mImageIndex);
+
+  if (is_ready() && current_index < mImageViews.size()) {
+    return mImageViews[current_index].get();
+  }
+
+  return VK_NULL_HANDLE;
+}
+
 auto Swapchain::get_current_image_index() -> uint32
 {
   return mImageIndex;
@@ -490,12 +517,22 @@ auto Swapchain::get_depth_buffer_format() const -> VkFormat
   return VK_FORMAT_UNDEFINED;
 }
 
+auto Swapchain::get_depth_buffer_image() -> VkImage
+{
+  return mDepthBuffer.image.get();
+}
+
+auto Swapchain::get_depth_buffer_image_view() -> VkImageView
+{
+  return mDepthBuffer.image_view.get();
+}
+
 auto Swapchain::is_ready() const -> bool
 {
   return mSwapchain != VK_NULL_HANDLE &&  //
          !mImages.empty() &&              //
          !mImageViews.empty() &&          //
-         !mFramebuffers.empty();
+         (!mUsesFramebuffers || !mFramebuffers.empty());
 }
 
 }  // namespace grace
@@ -41,7 +41,7 @@ auto Texture::make_2d(VkDevice device,
 
   texture.image = Image::make(allocator,
                               VK_IMAGE_TYPE_2D,
-                              {extent.width, extent.width, 1},
+                              {extent.width, extent.height, 1},
                               format,
                               usage,
                               mip_levels,
@@ -0,0 +1,225 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/texture_loader.hpp"
+
+#include <utility>  // move
+
+#include "grace/command_pool.hpp"
+#include "grace/image.hpp"
+
+namespace grace {
+
+TextureStagingArea::TextureStagingArea(VmaAllocator allocator) noexcept
+    : mAllocator {allocator}
+{
+}
+
+TextureStagingArea::~TextureStagingArea() noexcept
+{
+  if (mData) {
+    mTexture.buffer.unmap();
+  }
+}
+
+auto TextureStagingArea::allocate(const VkExtent2D& extent,
+                                  const VkFormat format,
+                                  const uint64 data_size) -> void*
+{
+  if (mData) {
+    mTexture.buffer.unmap();
+    mData = nullptr;
+  }
+
+  mTexture.extent = extent;
+  mTexture.format = format;
+
+  // The upload copies the entire extent, which must not read past the staged data
+  const auto texel_size = get_format_texel_size(format);
+  const auto required_size = uint64 {extent.width} * uint64 {extent.height} * texel_size;
+
+  if (data_size < required_size) {
+    mTexture.buffer = Buffer {};
+    mTexture.result = VK_ERROR_VALIDATION_FAILED_EXT;
+    return nullptr;
+  }
+
+  mTexture.buffer = Buffer::for_staging(mAllocator, data_size, 0, &mTexture.result);
+
+  if (mTexture.buffer) {
+    mData = mTexture.buffer.map(&mTexture.result);
+  }
+
+  return mData;
+}
+
+auto TextureStagingArea::finish(const bool decoded) -> StagedTexture
+{
+  if (mData) {
+    mTexture.buffer.unmap();
+    mData = nullptr;
+  }
+
+  if (mTexture.result == VK_SUCCESS && (!decoded || !mTexture.buffer)) {
+    mTexture.result = VK_ERROR_INITIALIZATION_FAILED;
+  }
+
+  return std::move(mTexture);
+}
+
+TextureLoader::TextureLoader(VkDevice device,
+                             VmaAllocator allocator,
+                             ThreadPool& pool,
+                             Decoder decoder)
+    : mDevice {device},
+      mAllocator {allocator},
+      mPool {&pool},
+      mDecoder {std::move(decoder)}
+{
+}
+
+auto TextureLoader::enqueue(const std::filesystem::path& path,
+                            const bool generate_mipmaps) -> usize
+{
+  // The task doesn't capture the loader, so the loader may be moved or destroyed
+  auto task = [allocator = mAllocator, decoder = mDecoder, path] {
+    TextureStagingArea staging {allocator};
+    const bool decoded = decoder(path, staging);
+    return staging.finish(decoded);
+  };
+
+  mPending.push_back(PendingTexture {
+      .staged = mPool->submit(std::move(task)),
+      .generate_mipmaps = generate_mipmaps,
+  });
+
+  return mPending.size() - 1;
+}
+
+namespace {
+
+[[nodiscard]] auto get_staged_texture(std::future<StagedTexture>& staged) noexcept
+    -> StagedTexture
+{
+  // Exceptions thrown by decoders are rethrown here, and are treated as failed decodes
+  try {
+    return staged.get();
+  }
+  catch (...) {
+    return StagedTexture {.result = VK_ERROR_INITIALIZATION_FAILED};
+  }
+}
+
+}  // namespace
+
+auto TextureLoader::flush(const CommandContext& ctx, VkResult* result)
+    -> std::vector<Texture>
+{
+  VkResult status = VK_SUCCESS;
+
+  std::vector<StagedTexture> staged_textures;
+  staged_textures.reserve(mPending.size());
+
+  std::vector<Texture> textures;
+  textures.reserve(mPending.size());
+
+  for (auto& pending : mPending) {
+    auto staged = get_staged_texture(pending.staged);
+
+    Texture texture;
+
+    if (staged.result == VK_SUCCESS) {
+      const VkExtent3D extent = {staged.extent.width, staged.extent.height, 1};
+      const auto mip_levels =
+          pending.generate_mipmaps ? get_max_image_mip_levels(extent) : 1;
+
+      texture = Texture::make_2d(mDevice,
+                                 mAllocator,
+                                 staged.extent,
+                                 VK_IMAGE_VIEW_TYPE_2D,
+                                 staged.format,
+                                 VK_IMAGE_USAGE_SAMPLED_BIT,
+                                 VK_IMAGE_ASPECT_COLOR_BIT,
+                                 mip_levels,
+                                 VK_SAMPLE_COUNT_1_BIT,
+                                 &staged.result);
+    }
+
+    if (staged.result != VK_SUCCESS) {
+      texture = Texture {};
+
+      if (status == VK_SUCCESS) {
+        status = staged.result;
+      }
+    }
+
+    textures.push_back(std::move(texture));
+    staged_textures.push_back(std::move(staged));
+  }
+
+  mPending.clear();
+
+  if (textures.empty()) {
+    if (result) {
+      *result = status;
+    }
+
+    return textures;
+  }
+
+  const auto upload_result = execute_now(ctx, [&](VkCommandBuffer cmd_buf) {
+    for (usize index = 0; index < textures.size(); ++index) {
+      auto& image = textures[index].image;
+      if (!image) {
+        continue;
+      }
+
+      image.cmd_change_layout(cmd_buf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+      image.cmd_copy_buffer(cmd_buf, staged_textures[index].buffer);
+
+      if (image.info().mip_levels > 1) {
+        image.cmd_generate_mipmaps(cmd_buf);
+      }
+      else {
+        image.cmd_change_layout(cmd_buf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+      }
+    }
+  });
+
+  if (upload_result != VK_SUCCESS) {
+    status = upload_result;
+
+    for (auto& texture : textures) {
+      texture = Texture {};
+    }
+  }
+
+  if (result) {
+    *result = status;
+  }
+
+  return textures;
+}
+
+}  // namespace grace
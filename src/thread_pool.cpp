@@ -0,0 +1,92 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/thread_pool.hpp"
+
+#include <algorithm>  // max
+
+namespace grace {
+
+auto get_default_thread_count() noexcept -> usize
+{
+  return std::max(usize {1}, static_cast<usize>(std::thread::hardware_concurrency()));
+}
+
+ThreadPool::ThreadPool(const usize thread_count)
+{
+  const auto count = std::max(usize {1}, thread_count);
+  mThreads.reserve(count);
+
+  for (usize index = 0; index < count; ++index) {
+    mThreads.emplace_back([this] { _run_worker(); });
+  }
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+  {
+    const std::scoped_lock lock {mMutex};
+    mStopping = true;
+  }
+
+  mCondition.notify_all();
+
+  for (auto& thread : mThreads) {
+    thread.join();
+  }
+}
+
+void ThreadPool::_enqueue(std::function<void()> task)
+{
+  {
+    const std::scoped_lock lock {mMutex};
+    mTasks.push(std::move(task));
+  }
+
+  mCondition.notify_one();
+}
+
+void ThreadPool::_run_worker()
+{
+  while (true) {
+    std::function<void()> task;
+
+    {
+      std::unique_lock lock {mMutex};
+      mCondition.wait(lock, [this] { return mStopping || !mTasks.empty(); });
+
+      // Pending tasks are always completed, even if the pool is being destroyed
+      if (mTasks.empty()) {
+        return;
+      }
+
+      task = std::move(mTasks.front());
+      mTasks.pop();
+    }
+
+    task();
+  }
+}
+
+}  // namespace grace
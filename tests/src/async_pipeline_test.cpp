@@ -0,0 +1,110 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/async_pipeline.hpp"
+
+#include <exception>  // make_exception_ptr
+#include <future>     // promise
+#include <new>        // bad_alloc
+#include <stdexcept>  // runtime_error
+#include <utility>    // move
+
+#include <gtest/gtest.h>
+
+#include "test_utils.hpp"
+
+using namespace grace;
+
+GRACE_TEST_FIXTURE(AsyncPipelineFixture);
+
+TEST(AsyncPipeline, Defaults)
+{
+  AsyncPipeline pipeline;
+  EXPECT_FALSE(pipeline.ready());
+  EXPECT_FALSE(pipeline.pending());
+  EXPECT_EQ(pipeline.result(), VK_ERROR_UNKNOWN);
+  EXPECT_EQ(pipeline.get(), VK_NULL_HANDLE);
+  EXPECT_EQ(pipeline.fallback(), VK_NULL_HANDLE);
+  EXPECT_FALSE(pipeline.bind(VK_NULL_HANDLE));
+}
+
+TEST(AsyncPipeline, FallbackWhilePending)
+{
+  const auto fallback = make_fake_ptr<VkPipeline>(42);
+
+  std::promise<GraphicsPipelineResult> promise;
+  AsyncPipeline pipeline {promise.get_future(), fallback};
+
+  EXPECT_TRUE(pipeline.pending());
+  EXPECT_FALSE(pipeline.ready());
+  EXPECT_EQ(pipeline.result(), VK_NOT_READY);
+  EXPECT_EQ(pipeline.get(), fallback);
+
+  GraphicsPipelineResult failure;
+  failure.result = VK_ERROR_OUT_OF_HOST_MEMORY;
+  promise.set_value(std::move(failure));
+
+  // The fallback remains in use if the compilation fails
+  EXPECT_FALSE(pipeline.pending());
+  EXPECT_FALSE(pipeline.ready());
+  EXPECT_EQ(pipeline.result(), VK_ERROR_OUT_OF_HOST_MEMORY);
+  EXPECT_EQ(pipeline.get(), fallback);
+}
+
+TEST(AsyncPipeline, CompilationException)
+{
+  const auto fallback = make_fake_ptr<VkPipeline>(42);
+
+  std::promise<GraphicsPipelineResult> promise;
+  AsyncPipeline pipeline {promise.get_future(), fallback};
+
+  promise.set_exception(std::make_exception_ptr(std::runtime_error {"oops"}));
+
+  EXPECT_FALSE(pipeline.pending());
+  EXPECT_FALSE(pipeline.ready());
+  EXPECT_EQ(pipeline.result(), VK_ERROR_UNKNOWN);
+  EXPECT_EQ(pipeline.get(), fallback);
+
+  std::promise<GraphicsPipelineResult> other_promise;
+  AsyncPipeline other_pipeline {other_promise.get_future()};
+
+  other_promise.set_exception(std::make_exception_ptr(std::bad_alloc {}));
+  EXPECT_EQ(other_pipeline.result(), VK_ERROR_OUT_OF_HOST_MEMORY);
+}
+
+TEST_F(AsyncPipelineFixture, RequestIncompleteBuilder)
+{
+  ThreadPool pool {1};
+
+  const auto fallback = make_fake_ptr<VkPipeline>(123);
+  const GraphicsPipelineBuilder builder {mDevice};
+
+  auto pipeline = AsyncPipeline::request(builder, pool, fallback);
+  pipeline.wait();
+
+  EXPECT_FALSE(pipeline.pending());
+  EXPECT_FALSE(pipeline.ready());
+  EXPECT_EQ(pipeline.result(), VK_INCOMPLETE);
+  EXPECT_EQ(pipeline.get(), fallback);
+}
@@ -93,3 +93,13 @@ TEST(Common, DataOrNull)
     EXPECT_EQ(data_or_null(arr), arr.data());
   }
 }
+
+TEST(Common, Fnv1aHash)
+{
+  EXPECT_EQ(fnv1a_hash(nullptr, 0), kFnv1aOffsetBasis);
+  EXPECT_EQ(fnv1a_hash("a", 1), 0xAF63DC4C8601EC8C);
+  EXPECT_EQ(fnv1a_hash("foobar", 6), 0x85944171F73967E8);
+
+  // Incremental hashing yields the same result as hashing all bytes at once
+  EXPECT_EQ(fnv1a_hash("bar", 3, fnv1a_hash("foo", 3)), fnv1a_hash("foobar", 6));
+}
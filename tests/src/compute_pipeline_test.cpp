@@ -0,0 +1,196 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/compute_pipeline.hpp"
+
+#include <array>   // array
+#include <vector>  // vector
+
+#include <gtest/gtest.h>
+
+#include "grace/buffer.hpp"
+#include "grace/command_pool.hpp"
+#include "grace/descriptor_set_layout.hpp"
+#include "grace/descriptors.hpp"
+#include "grace/device.hpp"
+#include "grace/physical_device.hpp"
+#include "grace/pipeline_layout.hpp"
+#include "test_shaders.hpp"
+#include "test_utils.hpp"
+
+using namespace grace;
+
+static_assert(WrapperType<ComputePipeline, VkPipeline>);
+
+GRACE_TEST_FIXTURE(ComputePipelineFixture);
+
+TEST(ComputePipeline, GetGroupCount)
+{
+  EXPECT_EQ(get_group_count(0, 64), 0u);
+  EXPECT_EQ(get_group_count(1, 64), 1u);
+  EXPECT_EQ(get_group_count(64, 64), 1u);
+  EXPECT_EQ(get_group_count(65, 64), 2u);
+  EXPECT_EQ(get_group_count(1920, 16), 120u);
+  EXPECT_EQ(get_group_count(1080, 16), 68u);
+  EXPECT_EQ(get_group_count(100, 1), 100u);
+  EXPECT_EQ(get_group_count(100, 0), 0u);
+  EXPECT_EQ(get_group_count(kMaxU32, 64), kMaxU32 / 64 + 1);
+  EXPECT_EQ(get_group_count(kMaxU32, 1), kMaxU32);
+
+  static_assert(get_group_count(257, 256) == 2);
+}
+
+TEST_F(ComputePipelineFixture, IncompleteBuilder)
+{
+  ComputePipelineBuilder builder {mDevice};
+
+  VkResult result = VK_SUCCESS;
+  auto pipeline = builder.build(&result);
+  EXPECT_FALSE(pipeline);
+  EXPECT_EQ(result, VK_INCOMPLETE);
+
+  builder.shader("assets/shaders/test.comp.spv");
+
+  result = VK_SUCCESS;
+  pipeline = builder.build(&result);
+  EXPECT_FALSE(pipeline);
+  EXPECT_EQ(result, VK_INCOMPLETE);
+
+  builder.reset().with_layout(VK_NULL_HANDLE);
+
+  result = VK_SUCCESS;
+  pipeline = builder.build(&result);
+  EXPECT_FALSE(pipeline);
+  EXPECT_EQ(result, VK_INCOMPLETE);
+}
+
+TEST_F(ComputePipelineFixture, BuildAndDispatch)
+{
+  // The local workgroup size of the test compute shader
+  constexpr uint32 local_size = 64;
+  constexpr uint32 value_count = 4 * local_size;
+
+  const auto vkCmdPushDescriptorSetKHR =
+      get_function<PFN_vkCmdPushDescriptorSetKHR>(mDevice, "vkCmdPushDescriptorSetKHR");
+  ASSERT_NE(vkCmdPushDescriptorSetKHR, nullptr);
+
+  VkResult result = VK_ERROR_UNKNOWN;
+
+  auto set_layout =
+      DescriptorSetLayoutBuilder {mDevice}
+          .use_push_descriptors()
+          .descriptor(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+          .build(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  auto layout =
+      PipelineLayoutBuilder {mDevice}.descriptor_set_layout(set_layout).build(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  ComputePipelineBuilder builder {mDevice};
+  builder.with_layout(layout).shader("assets/shaders/test.comp.spv");
+
+  auto file_pipeline = builder.build(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  EXPECT_TRUE(file_pipeline);
+
+  builder.shader(test_shaders::kTestCompSpv);
+
+  auto pipeline = builder.build(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  ASSERT_TRUE(pipeline);
+
+  auto buffer = Buffer::make(mAllocator,
+                             value_count * sizeof(uint32),
+                             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                 VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                             0,
+                             VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT,
+                             VMA_MEMORY_USAGE_AUTO,
+                             &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  const std::vector<uint32> zeros(value_count, 0);
+  ASSERT_EQ(buffer.set_data(zeros.data(), value_count * sizeof(uint32)), VK_SUCCESS);
+
+  const auto compute_family = get_queue_family_indices(mGPU, mSurface).graphics;
+  ASSERT_TRUE(compute_family.has_value());
+
+  VkQueue queue = VK_NULL_HANDLE;
+  vkGetDeviceQueue(mDevice, compute_family.value(), 0, &queue);
+
+  auto cmd_pool = CommandPool::make(mDevice, compute_family.value());
+  ASSERT_TRUE(cmd_pool);
+
+  const auto buffer_info =
+      make_descriptor_buffer_info(buffer.get(), value_count * sizeof(uint32));
+  const std::array descriptor_writes = {
+      make_buffer_descriptor_write(VK_NULL_HANDLE,
+                                   0,
+                                   VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                   1,
+                                   &buffer_info),
+  };
+
+  result = cmd_pool.execute_now(queue, [&](VkCommandBuffer cmd_buf) {
+    pipeline.bind(cmd_buf);
+    vkCmdPushDescriptorSetKHR(cmd_buf,
+                              VK_PIPELINE_BIND_POINT_COMPUTE,
+                              layout,
+                              0,
+                              u32_size(descriptor_writes),
+                              descriptor_writes.data());
+
+    cmd_dispatch_1d(cmd_buf, value_count, local_size);
+
+    // Makes the shader writes visible to the host once the commands have completed
+    const VkMemoryBarrier barrier {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .pNext = nullptr,
+        .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+    };
+    vkCmdPipelineBarrier(cmd_buf,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_HOST_BIT,
+                         0,
+                         1,
+                         &barrier,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr);
+  });
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  const auto* values = static_cast<const uint32*>(buffer.map(&result));
+  ASSERT_NE(values, nullptr);
+
+  for (uint32 index = 0; index < value_count; ++index) {
+    EXPECT_EQ(values[index], index);
+  }
+
+  buffer.unmap();
+}
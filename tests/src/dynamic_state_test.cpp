@@ -0,0 +1,117 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "grace/dynamic_state.hpp"
+
+#include <gtest/gtest.h>
+
+#include "grace/command_pool.hpp"
+#include "grace/physical_device.hpp"
+#include "grace/pipeline.hpp"
+#include "test_utils.hpp"
+
+using namespace grace;
+
+GRACE_TEST_FIXTURE(DynamicStateFixture);
+
+TEST_F(DynamicStateFixture, BuildAndSetExtendedDynamicState)
+{
+  // The test context enables every feature set that is supported
+  const auto support = get_extended_dynamic_state_support(mGPU);
+  if (!support.state1 && !support.state2 && !support.state3) {
+    GTEST_SKIP() << "Extended dynamic state is not supported";
+  }
+
+  const auto functions = get_extended_dynamic_state_functions(mDevice);
+
+  auto objects = make_test_pipeline_objects(mDevice);
+  ASSERT_TRUE(objects.pipeline_layout);
+
+  auto builder = make_test_pipeline_builder(mDevice, objects);
+
+#ifdef VK_EXT_extended_dynamic_state
+  if (support.state1) {
+    builder.dynamic_states(kExtendedDynamicStates);
+  }
+#endif  // VK_EXT_extended_dynamic_state
+
+#ifdef VK_EXT_extended_dynamic_state2
+  if (support.state2) {
+    builder.dynamic_states(kExtendedDynamicStates2);
+  }
+#endif  // VK_EXT_extended_dynamic_state2
+
+#ifdef VK_EXT_extended_dynamic_state3
+  if (support.state3) {
+    builder.dynamic_states(kExtendedDynamicStates3);
+  }
+#endif  // VK_EXT_extended_dynamic_state3
+
+  VkResult result = VK_ERROR_UNKNOWN;
+  auto pipeline = builder.build(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  ASSERT_TRUE(pipeline);
+
+  const auto graphics_family = get_queue_family_indices(mGPU, mSurface).graphics;
+  ASSERT_TRUE(graphics_family.has_value());
+
+  VkQueue queue = VK_NULL_HANDLE;
+  vkGetDeviceQueue(mDevice, graphics_family.value(), 0, &queue);
+
+  auto cmd_pool = CommandPool::make(mDevice, graphics_family.value());
+  ASSERT_TRUE(cmd_pool);
+
+  result = cmd_pool.execute_now(queue, [&](VkCommandBuffer cmd_buf) {
+    vkCmdBindPipeline(cmd_buf, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+#ifdef VK_EXT_extended_dynamic_state
+    if (support.state1) {
+      cmd_set_primitive_topology(functions, cmd_buf, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+      cmd_set_cull_mode(functions, cmd_buf, VK_CULL_MODE_BACK_BIT);
+      cmd_set_depth_test(functions, cmd_buf, true, true, VK_COMPARE_OP_LESS_OR_EQUAL);
+      cmd_set_depth_bounds_test(functions, cmd_buf, false);
+      cmd_set_stencil_test(functions, cmd_buf, false);
+    }
+#endif  // VK_EXT_extended_dynamic_state
+
+#ifdef VK_EXT_extended_dynamic_state2
+    if (support.state2) {
+      cmd_set_depth_bias_enable(functions, cmd_buf, false);
+      cmd_set_primitive_restart_enable(functions, cmd_buf, false);
+      cmd_set_rasterizer_discard_enable(functions, cmd_buf, false);
+      cmd_set_logic_op(functions, cmd_buf, VK_LOGIC_OP_COPY);
+    }
+#endif  // VK_EXT_extended_dynamic_state2
+
+#ifdef VK_EXT_extended_dynamic_state3
+    if (support.state3) {
+      cmd_set_polygon_mode(functions, cmd_buf, VK_POLYGON_MODE_FILL);
+      cmd_set_depth_clamp_enable(functions, cmd_buf, false);
+      cmd_set_logic_op_enable(functions, cmd_buf, false);
+    }
+#endif  // VK_EXT_extended_dynamic_state3
+  });
+  EXPECT_EQ(result, VK_SUCCESS);
+}
@@ -0,0 +1,83 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/file_watcher.hpp"
+
+#include <chrono>      // milliseconds
+#include <filesystem>  // path, temp_directory_path, remove
+#include <fstream>     // ofstream
+#include <thread>      // sleep_for
+
+#include <gtest/gtest.h>
+
+using namespace grace;
+
+namespace {
+
+void write_file(const std::filesystem::path& path, const char* contents)
+{
+  std::ofstream stream {path, std::ios::out | std::ios::trunc};
+  stream << contents;
+}
+
+}  // namespace
+
+TEST(FileWatcher, NormalizeFilePath)
+{
+  const auto path = normalize_file_path("assets/shaders/../shaders/test.vert.spv");
+
+  EXPECT_TRUE(path.is_absolute());
+  EXPECT_EQ(path, normalize_file_path("assets/shaders/test.vert.spv"));
+}
+
+TEST(FileWatcher, DetectModifications)
+{
+  const auto directory = std::filesystem::temp_directory_path();
+  const auto watched = directory / "grace_file_watcher_test.txt";
+  const auto unwatched = directory / "grace_file_watcher_test_other.txt";
+
+  write_file(watched, "a");
+
+  FileWatcher watcher;
+  ASSERT_TRUE(watcher.watch(watched));
+  ASSERT_TRUE(watcher.watch(watched));
+  EXPECT_EQ(watcher.watched_count(), 1u);
+
+  EXPECT_TRUE(watcher.poll().empty());
+
+  // Make sure that the modification time changes when polling
+  std::this_thread::sleep_for(std::chrono::milliseconds {20});
+
+  write_file(watched, "b");
+  write_file(unwatched, "c");
+
+  const auto modified = watcher.poll();
+  ASSERT_EQ(modified.size(), 1u);
+  EXPECT_EQ(modified.front(), normalize_file_path(watched));
+
+  EXPECT_TRUE(watcher.poll().empty());
+
+  std::filesystem::remove(watched);
+  std::filesystem::remove(unwatched);
+}
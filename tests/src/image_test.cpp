@@ -0,0 +1,469 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/image.hpp"
+
+#include <vector>  // vector
+
+#include <gtest/gtest.h>
+
+#include "grace/command_pool.hpp"
+#include "grace/context.hpp"
+#include "grace/device.hpp"
+#include "grace/physical_device.hpp"
+#include "grace/pixel_conversion.hpp"
+#include "test_utils.hpp"
+
+using namespace grace;
+
+TEST(Images, MakeBufferImageCopy)
+{
+  const uint64 buffer_offset = 256;
+  const VkOffset3D image_offset = {12, 34, 0};
+  const VkExtent3D image_extent = {64, 32, 1};
+  const uint32 row_pitch = 128;
+  const uint32 mip_level = 2;
+  const uint32 array_layer = 3;
+
+  const auto region = make_buffer_image_copy(buffer_offset,
+                                             image_offset,
+                                             image_extent,
+                                             row_pitch,
+                                             mip_level,
+                                             array_layer);
+
+  EXPECT_EQ(region.bufferOffset, buffer_offset);
+  EXPECT_EQ(region.bufferRowLength, row_pitch);
+  EXPECT_EQ(region.bufferImageHeight, 0);
+  EXPECT_EQ(region.imageSubresource.aspectMask, VK_IMAGE_ASPECT_COLOR_BIT);
+  EXPECT_EQ(region.imageSubresource.mipLevel, mip_level);
+  EXPECT_EQ(region.imageSubresource.baseArrayLayer, array_layer);
+  EXPECT_EQ(region.imageSubresource.layerCount, 1);
+  EXPECT_EQ(region.imageOffset.x, image_offset.x);
+  EXPECT_EQ(region.imageOffset.y, image_offset.y);
+  EXPECT_EQ(region.imageOffset.z, image_offset.z);
+  EXPECT_EQ(region.imageExtent.width, image_extent.width);
+  EXPECT_EQ(region.imageExtent.height, image_extent.height);
+  EXPECT_EQ(region.imageExtent.depth, image_extent.depth);
+}
+
+TEST(Images, MakeBufferImageCopyDefaults)
+{
+  const auto region = make_buffer_image_copy(0, {0, 0, 0}, {16, 16, 1});
+
+  EXPECT_EQ(region.bufferOffset, 0);
+  EXPECT_EQ(region.bufferRowLength, 0);
+  EXPECT_EQ(region.imageSubresource.mipLevel, 0);
+  EXPECT_EQ(region.imageSubresource.baseArrayLayer, 0);
+}
+
+TEST(Images, MakeImageSubresourceRange)
+{
+  const auto range = make_image_subresource_range(VK_IMAGE_ASPECT_DEPTH_BIT, 1, 2, 3, 4);
+
+  EXPECT_EQ(range.aspectMask, VK_IMAGE_ASPECT_DEPTH_BIT);
+  EXPECT_EQ(range.baseMipLevel, 1);
+  EXPECT_EQ(range.levelCount, 2);
+  EXPECT_EQ(range.baseArrayLayer, 3);
+  EXPECT_EQ(range.layerCount, 4);
+}
+
+TEST(Images, ImageViewKeyHashing)
+{
+  const ImageViewKeyHasher hasher;
+
+  const ImageViewKey a {.type = VK_IMAGE_VIEW_TYPE_2D, .base_mip_level = 1};
+  const ImageViewKey b {.type = VK_IMAGE_VIEW_TYPE_2D, .base_mip_level = 1};
+  const ImageViewKey c {.type = VK_IMAGE_VIEW_TYPE_2D, .base_mip_level = 2};
+
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+  EXPECT_EQ(hasher(a), hasher(b));
+}
+
+TEST(Images, IsAttachmentOnlyUsage)
+{
+  EXPECT_TRUE(is_attachment_only_usage(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT));
+  EXPECT_TRUE(is_attachment_only_usage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                       VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT));
+  EXPECT_TRUE(is_attachment_only_usage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                       VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT));
+
+  EXPECT_FALSE(is_attachment_only_usage(0));
+  EXPECT_FALSE(is_attachment_only_usage(VK_IMAGE_USAGE_SAMPLED_BIT));
+  EXPECT_FALSE(is_attachment_only_usage(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                        VK_IMAGE_USAGE_SAMPLED_BIT));
+}
+
+TEST(Images, MakeImageInfoTransferUsage)
+{
+  const VkExtent3D extent = {128, 128, 1};
+
+  const auto sampled_info = make_image_info(VK_IMAGE_TYPE_2D,
+                                            extent,
+                                            VK_FORMAT_R8G8B8A8_SRGB,
+                                            VK_IMAGE_USAGE_SAMPLED_BIT);
+  EXPECT_EQ(sampled_info.usage,
+            VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+
+  // Attachments may be read back or blitted, so they have transfer usage as well
+  const auto color_info = make_image_info(VK_IMAGE_TYPE_2D,
+                                          extent,
+                                          VK_FORMAT_B8G8R8A8_UNORM,
+                                          VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT);
+  EXPECT_EQ(color_info.usage,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+}
+
+TEST(Images, GetFormatTexelSize)
+{
+  EXPECT_EQ(get_format_texel_size(VK_FORMAT_R8_UNORM), 1u);
+  EXPECT_EQ(get_format_texel_size(VK_FORMAT_R16_SFLOAT), 2u);
+  EXPECT_EQ(get_format_texel_size(VK_FORMAT_R8G8B8_SRGB), 3u);
+  EXPECT_EQ(get_format_texel_size(VK_FORMAT_B8G8R8A8_UNORM), 4u);
+  EXPECT_EQ(get_format_texel_size(VK_FORMAT_D32_SFLOAT), 4u);
+  EXPECT_EQ(get_format_texel_size(VK_FORMAT_R16G16B16A16_SFLOAT), 8u);
+  EXPECT_EQ(get_format_texel_size(VK_FORMAT_R32G32B32A32_SFLOAT), 16u);
+
+  EXPECT_EQ(get_format_texel_size(VK_FORMAT_UNDEFINED), 0u);
+  EXPECT_EQ(get_format_texel_size(VK_FORMAT_D24_UNORM_S8_UINT), 0u);
+  EXPECT_EQ(get_format_texel_size(VK_FORMAT_BC1_RGB_UNORM_BLOCK), 0u);
+}
+
+GRACE_TEST_FIXTURE(ImageFixture);
+
+TEST_F(ImageFixture, TransientAttachment)
+{
+  VkPhysicalDeviceMemoryProperties memory_properties = {};
+  vkGetPhysicalDeviceMemoryProperties(mGPU, &memory_properties);
+
+  bool has_lazy_memory = false;
+  for (uint32 index = 0; index < memory_properties.memoryTypeCount; ++index) {
+    const auto flags = memory_properties.memoryTypes[index].propertyFlags;
+    has_lazy_memory |= (flags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0;
+  }
+
+  VkResult result = VK_ERROR_UNKNOWN;
+
+  // D16 is the only depth format that all devices must support as an attachment
+  auto image = Image::make_transient(mAllocator,
+                                     {800, 600, 1},
+                                     VK_FORMAT_D16_UNORM,
+                                     VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                                     VK_SAMPLE_COUNT_1_BIT,
+                                     &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  ASSERT_TRUE(image);
+
+  EXPECT_EQ(image.info().format, VK_FORMAT_D16_UNORM);
+  EXPECT_EQ(image.info().mip_levels, 1u);
+
+  VkMemoryPropertyFlags memory_flags = 0;
+  vmaGetAllocationMemoryProperties(mAllocator, image.allocation(), &memory_flags);
+
+  // Devices without lazily allocated memory fall back to device local memory
+  if (has_lazy_memory) {
+    EXPECT_TRUE(memory_flags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+  }
+  else {
+    EXPECT_FALSE(memory_flags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+    EXPECT_TRUE(memory_flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  }
+}
+
+TEST_F(ImageFixture, UpdateRegions)
+{
+  const auto graphics_family = get_queue_family_indices(mGPU, mSurface).graphics;
+  ASSERT_TRUE(graphics_family.has_value());
+
+  VkQueue queue = VK_NULL_HANDLE;
+  vkGetDeviceQueue(mDevice, graphics_family.value(), 0, &queue);
+
+  auto cmd_pool = CommandPool::make(mDevice, graphics_family.value());
+  ASSERT_TRUE(cmd_pool);
+
+  const CommandContext ctx {
+      .device = mDevice,
+      .queue = queue,
+      .cmd_pool = cmd_pool.get(),
+  };
+
+  const VkExtent3D extent = {8, 8, 1};
+  const uint64 texel_size = 4;
+
+  auto image = Image::make(mAllocator,
+                           VK_IMAGE_TYPE_2D,
+                           extent,
+                           VK_FORMAT_R8G8B8A8_UNORM,
+                           VK_IMAGE_USAGE_SAMPLED_BIT);
+  ASSERT_TRUE(image);
+
+  const std::vector<uint8> texels(extent.width * extent.height * texel_size, 0xFF);
+
+  EXPECT_EQ(image.update_region(ctx,
+                                mAllocator,
+                                texels.data(),
+                                4 * 4 * texel_size,
+                                {0, 0, 0},
+                                {4, 4, 1}),
+            VK_SUCCESS);
+  EXPECT_EQ(image.info().layout, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+  // The second region reads its rows from the full 8x8 source image
+  const std::vector regions = {
+      ImageRegion {
+          .data = texels.data(),
+          .data_size = 4 * 4 * texel_size,
+          .offset = {4, 0, 0},
+          .extent = {4, 4, 1},
+      },
+      ImageRegion {
+          .data = texels.data(),
+          .data_size = (3 * 8 + 4) * texel_size,
+          .offset = {0, 4, 0},
+          .extent = {4, 4, 1},
+          .row_pitch = 8,
+      },
+  };
+
+  EXPECT_EQ(image.update_regions(ctx, mAllocator, regions), VK_SUCCESS);
+  EXPECT_EQ(image.info().layout, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+  // The data doesn't cover the region
+  EXPECT_EQ(image.update_region(ctx,
+                                mAllocator,
+                                texels.data(),
+                                4 * 4 * texel_size - 1,
+                                {0, 0, 0},
+                                {4, 4, 1}),
+            VK_ERROR_VALIDATION_FAILED_EXT);
+
+  // The row pitch is shorter than the rows of the region
+  EXPECT_EQ(image.update_region(ctx,
+                                mAllocator,
+                                texels.data(),
+                                texels.size(),
+                                {0, 0, 0},
+                                {4, 4, 1},
+                                2),
+            VK_ERROR_VALIDATION_FAILED_EXT);
+
+  // The region extends past the edge of the image
+  EXPECT_EQ(image.update_region(ctx,
+                                mAllocator,
+                                texels.data(),
+                                texels.size(),
+                                {6, 0, 0},
+                                {4, 4, 1}),
+            VK_ERROR_VALIDATION_FAILED_EXT);
+
+  // The offset of the region is negative
+  EXPECT_EQ(image.update_region(ctx,
+                                mAllocator,
+                                texels.data(),
+                                texels.size(),
+                                {0, -1, 0},
+                                {4, 4, 1}),
+            VK_ERROR_VALIDATION_FAILED_EXT);
+
+  // The image has neither a second mipmap level nor a second array layer
+  EXPECT_EQ(image.update_region(ctx,
+                                mAllocator,
+                                texels.data(),
+                                texels.size(),
+                                {0, 0, 0},
+                                {1, 1, 1},
+                                0,
+                                1),
+            VK_ERROR_VALIDATION_FAILED_EXT);
+  EXPECT_EQ(image.update_region(ctx,
+                                mAllocator,
+                                texels.data(),
+                                texels.size(),
+                                {0, 0, 0},
+                                {1, 1, 1},
+                                0,
+                                0,
+                                1),
+            VK_ERROR_VALIDATION_FAILED_EXT);
+}
+
+TEST_F(ImageFixture, UpdateRegionsWithUnalignedTexelSize)
+{
+  constexpr VkFormat format = VK_FORMAT_R32G32B32_SFLOAT;
+
+  VkFormatProperties format_properties = {};
+  vkGetPhysicalDeviceFormatProperties(mGPU, format, &format_properties);
+
+  if (!(format_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_TRANSFER_DST_BIT)) {
+    GTEST_SKIP() << "R32G32B32_SFLOAT images can't be copied to";
+  }
+
+  const auto graphics_family = get_queue_family_indices(mGPU, mSurface).graphics;
+  ASSERT_TRUE(graphics_family.has_value());
+
+  VkQueue queue = VK_NULL_HANDLE;
+  vkGetDeviceQueue(mDevice, graphics_family.value(), 0, &queue);
+
+  auto cmd_pool = CommandPool::make(mDevice, graphics_family.value());
+  ASSERT_TRUE(cmd_pool);
+
+  const CommandContext ctx {
+      .device = mDevice,
+      .queue = queue,
+      .cmd_pool = cmd_pool.get(),
+  };
+
+  auto image = Image::make(mAllocator,
+                           VK_IMAGE_TYPE_2D,
+                           {4, 4, 1},
+                           format,
+                           VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+  ASSERT_TRUE(image);
+
+  // A single 12-byte texel per region, so a 16-byte alignment would be invalid
+  const std::vector<float> texel = {1.0f, 2.0f, 3.0f};
+  const auto texel_size = texel.size() * sizeof(float);
+
+  std::vector<ImageRegion> regions;
+  for (int32 x = 0; x < 4; ++x) {
+    regions.push_back(ImageRegion {
+        .data = texel.data(),
+        .data_size = texel_size,
+        .offset = {x, 0, 0},
+        .extent = {1, 1, 1},
+    });
+  }
+
+  EXPECT_EQ(image.update_regions(ctx, mAllocator, regions), VK_SUCCESS);
+}
+
+TEST_F(ImageFixture, SetDataWithConversionValidation)
+{
+  const VkExtent3D extent = {4, 4, 1};
+
+  auto image = Image::make(mAllocator,
+                           VK_IMAGE_TYPE_2D,
+                           extent,
+                           VK_FORMAT_R8G8B8A8_UNORM,
+                           VK_IMAGE_USAGE_SAMPLED_BIT);
+  ASSERT_TRUE(image);
+
+  // No commands are submitted when the validation fails
+  const CommandContext ctx {.device = mDevice};
+  const std::vector<uint8> texels(extent.width * extent.height * 4, 0xFF);
+
+  EXPECT_EQ(image.set_data(ctx,
+                           mAllocator,
+                           texels.data(),
+                           extent.width * extent.height,
+                           PixelConversion::kRgba32fToRgba16f),
+            VK_ERROR_FORMAT_NOT_SUPPORTED);
+  EXPECT_EQ(image.set_data(ctx,
+                           mAllocator,
+                           texels.data(),
+                           extent.width * extent.height,
+                           PixelConversion::kLinearRgba32fToSrgba8),
+            VK_ERROR_FORMAT_NOT_SUPPORTED);
+  EXPECT_EQ(image.set_data(ctx,
+                           mAllocator,
+                           texels.data(),
+                           extent.width * extent.height - 1,
+                           PixelConversion::kPremultiplyRgba8),
+            VK_ERROR_VALIDATION_FAILED_EXT);
+}
+
+#ifdef VK_EXT_host_image_copy
+
+TEST_F(ImageFixture, HostCopyRoundTrip)
+{
+  const auto functions = get_host_image_copy_functions(mDevice);
+  const auto copy_image_to_memory =
+      get_function<PFN_vkCopyImageToMemoryEXT>(mDevice, "vkCopyImageToMemoryEXT");
+
+  if (!functions.vkCopyMemoryToImageEXT || !copy_image_to_memory) {
+    GTEST_SKIP() << "VK_EXT_host_image_copy is not supported";
+  }
+
+  const VkExtent3D extent = {4, 4, 1};
+  const auto format = VK_FORMAT_R8G8B8A8_UNORM;
+  const VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT |
+                                  VK_IMAGE_USAGE_HOST_TRANSFER_BIT_EXT |
+                                  VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                  VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+  VkImageFormatProperties format_properties = {};
+  if (vkGetPhysicalDeviceImageFormatProperties(mGPU,
+                                               format,
+                                               VK_IMAGE_TYPE_2D,
+                                               VK_IMAGE_TILING_OPTIMAL,
+                                               usage,
+                                               0,
+                                               &format_properties) != VK_SUCCESS) {
+    GTEST_SKIP() << "Host image copies aren't supported for the format";
+  }
+
+  auto image = Image::make(mAllocator, VK_IMAGE_TYPE_2D, extent, format, usage);
+  ASSERT_TRUE(image);
+
+  std::vector<uint8> texels(extent.width * extent.height * 4);
+  for (usize index = 0; index < texels.size(); ++index) {
+    texels[index] = static_cast<uint8>(index);
+  }
+
+  // The general layout is always supported as a host copy source and destination
+  ASSERT_EQ(image.host_copy(functions, texels.data(), VK_IMAGE_LAYOUT_GENERAL),
+            VK_SUCCESS);
+  EXPECT_EQ(image.info().layout, VK_IMAGE_LAYOUT_GENERAL);
+
+  std::vector<uint8> read_texels(texels.size(), 0);
+
+  const VkImageToMemoryCopyEXT region = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_TO_MEMORY_COPY_EXT,
+      .pNext = nullptr,
+      .pHostPointer = read_texels.data(),
+      .memoryRowLength = 0,
+      .memoryImageHeight = 0,
+      .imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+      .imageOffset = {0, 0, 0},
+      .imageExtent = extent,
+  };
+
+  const VkCopyImageToMemoryInfoEXT copy_info = {
+      .sType = VK_STRUCTURE_TYPE_COPY_IMAGE_TO_MEMORY_INFO_EXT,
+      .pNext = nullptr,
+      .flags = 0,
+      .srcImage = image.get(),
+      .srcImageLayout = VK_IMAGE_LAYOUT_GENERAL,
+      .regionCount = 1,
+      .pRegions = &region,
+  };
+
+  ASSERT_EQ(copy_image_to_memory(mDevice, &copy_info), VK_SUCCESS);
+  EXPECT_EQ(read_texels, texels);
+}
+
+#endif  // VK_EXT_host_image_copy
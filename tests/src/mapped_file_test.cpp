@@ -0,0 +1,122 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/mapped_file.hpp"
+
+#include <array>       // array
+#include <cstddef>     // byte
+#include <cstdint>     // uintptr_t
+#include <cstring>     // memcmp
+#include <filesystem>  // temp_directory_path, directory_iterator, exists, remove_all
+#include <iterator>    // distance
+#include <utility>     // move
+
+#include <gtest/gtest.h>
+
+#include "grace/shader_module.hpp"
+
+using namespace grace;
+
+TEST(MappedFile, Open)
+{
+  const auto code = read_binary_file("assets/shaders/test.vert.spv");
+  ASSERT_FALSE(code.empty());
+
+  VkResult result = VK_ERROR_UNKNOWN;
+  const auto file = MappedFile::open("assets/shaders/test.vert.spv", &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  ASSERT_TRUE(file);
+
+  ASSERT_EQ(file.size(), code.size());
+  EXPECT_EQ(file.bytes().size(), code.size());
+  EXPECT_EQ(std::memcmp(file.data(), code.data(), code.size()), 0);
+
+  // The data must be usable as SPIR-V code without copying it
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(file.data()) % sizeof(uint32), 0u);
+}
+
+TEST(MappedFile, MissingFile)
+{
+  VkResult result = VK_SUCCESS;
+  const auto file = MappedFile::open("assets/shaders/missing.spv", &result);
+
+  EXPECT_EQ(result, VK_ERROR_UNKNOWN);
+  EXPECT_FALSE(file);
+  EXPECT_EQ(file.data(), nullptr);
+  EXPECT_TRUE(file.empty());
+}
+
+TEST(MappedFile, Move)
+{
+  auto file = MappedFile::open("assets/shaders/test.frag.spv");
+  ASSERT_TRUE(file);
+
+  const auto* data = file.data();
+  const auto size = file.size();
+
+  MappedFile other {std::move(file)};
+  EXPECT_FALSE(file);
+  EXPECT_TRUE(other);
+  EXPECT_EQ(other.data(), data);
+  EXPECT_EQ(other.size(), size);
+
+  other.close();
+  EXPECT_FALSE(other);
+  EXPECT_EQ(other.data(), nullptr);
+  EXPECT_EQ(other.size(), 0u);
+}
+
+TEST(MappedFile, WriteFileAtomically)
+{
+  const auto directory = std::filesystem::temp_directory_path() / "grace_write_test";
+  const auto path = directory / "file.bin";
+  const std::array bytes = {std::byte {0x12}, std::byte {0x34}, std::byte {0x56}};
+
+  std::filesystem::remove_all(directory);
+  ASSERT_TRUE(std::filesystem::create_directory(directory));
+
+  ASSERT_EQ(write_file_atomically(path, bytes), VK_SUCCESS);
+
+  // The temporary file is renamed, so the written file is the only one left
+  const std::filesystem::directory_iterator entries {directory};
+  EXPECT_EQ(std::distance(begin(entries), end(entries)), 1);
+
+  {
+    const auto file = MappedFile::open(path);
+    ASSERT_TRUE(file);
+    ASSERT_EQ(file.size(), bytes.size());
+    EXPECT_EQ(std::memcmp(file.data(), bytes.data(), bytes.size()), 0);
+  }
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(MappedFile, WriteFileAtomicallyToMissingDirectory)
+{
+  const auto path = std::filesystem::temp_directory_path() / "grace_missing" / "a.bin";
+  const std::array bytes = {std::byte {0x12}};
+
+  EXPECT_EQ(write_file_atomically(path, bytes), VK_ERROR_UNKNOWN);
+  EXPECT_FALSE(std::filesystem::exists(path));
+}
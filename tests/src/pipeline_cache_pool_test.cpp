@@ -0,0 +1,107 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/pipeline_cache_pool.hpp"
+
+#include <filesystem>  // path, remove, exists
+#include <thread>      // thread
+
+#include <gtest/gtest.h>
+
+#include "test_utils.hpp"
+
+using namespace grace;
+
+GRACE_TEST_FIXTURE(PipelineCachePoolFixture);
+
+TEST_F(PipelineCachePoolFixture, ThreadCaches)
+{
+  VkResult result = VK_ERROR_UNKNOWN;
+
+  auto primary = PipelineCache::make(mDevice, nullptr, 0, 0, &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  PipelineCachePool caches {std::move(primary)};
+  EXPECT_NE(caches.get_primary(), VK_NULL_HANDLE);
+  EXPECT_EQ(caches.thread_count(), 0u);
+
+  // Nothing to merge yet
+  EXPECT_EQ(caches.merge(), VK_SUCCESS);
+
+  const auto cache = caches.get(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  ASSERT_NE(cache, VK_NULL_HANDLE);
+  EXPECT_NE(cache, caches.get_primary());
+
+  // Threads keep using the same cache
+  EXPECT_EQ(caches.get(), cache);
+  EXPECT_EQ(caches.thread_count(), 1u);
+
+  VkPipelineCache other_cache = VK_NULL_HANDLE;
+  std::thread thread {[&] { other_cache = caches.get(); }};
+  thread.join();
+
+  EXPECT_NE(other_cache, VK_NULL_HANDLE);
+  EXPECT_NE(other_cache, cache);
+  EXPECT_EQ(caches.thread_count(), 2u);
+
+  EXPECT_EQ(caches.merge(), VK_SUCCESS);
+}
+
+TEST_F(PipelineCachePoolFixture, NullPrimary)
+{
+  PipelineCachePool caches {PipelineCache {}};
+  EXPECT_EQ(caches.get_primary(), VK_NULL_HANDLE);
+
+  VkResult result = VK_SUCCESS;
+  EXPECT_EQ(caches.get(&result), VK_NULL_HANDLE);
+  EXPECT_EQ(result, VK_ERROR_INITIALIZATION_FAILED);
+  EXPECT_EQ(caches.thread_count(), 0u);
+
+  EXPECT_EQ(caches.merge(), VK_ERROR_INITIALIZATION_FAILED);
+  EXPECT_EQ(caches.save("pipeline_cache_pool_null.bin"), VK_ERROR_INITIALIZATION_FAILED);
+}
+
+TEST_F(PipelineCachePoolFixture, Save)
+{
+  const std::filesystem::path path = "pipeline_cache_pool_test.bin";
+  std::filesystem::remove(path);
+
+  VkResult result = VK_ERROR_UNKNOWN;
+
+  auto primary = PipelineCache::load_or_create(mDevice, mGPU, path, &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  PipelineCachePool caches {std::move(primary)};
+  ASSERT_NE(caches.get(), VK_NULL_HANDLE);
+
+  ASSERT_EQ(caches.save(path), VK_SUCCESS);
+  EXPECT_TRUE(std::filesystem::exists(path));
+
+  // The saved cache seeds the thread caches of the next session
+  PipelineCachePool loaded_caches {PipelineCache::load_or_create(mDevice, mGPU, path)};
+  EXPECT_NE(loaded_caches.get(), VK_NULL_HANDLE);
+
+  std::filesystem::remove(path);
+}
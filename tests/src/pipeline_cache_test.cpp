@@ -0,0 +1,170 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/pipeline_cache.hpp"
+
+#include <array>       // array
+#include <cstring>     // memcpy
+#include <filesystem>  // path, remove, exists
+#include <vector>      // vector
+
+#include <gtest/gtest.h>
+
+#include "grace/mapped_file.hpp"
+#include "test_utils.hpp"
+
+using namespace grace;
+
+static_assert(WrapperType<PipelineCache, VkPipelineCache>);
+
+namespace {
+
+[[nodiscard]] auto make_fake_properties() -> VkPhysicalDeviceProperties
+{
+  VkPhysicalDeviceProperties properties = {};
+  properties.vendorID = 0x10DE;
+  properties.deviceID = 0x2204;
+
+  for (uint32 i = 0; i < VK_UUID_SIZE; ++i) {
+    properties.pipelineCacheUUID[i] = static_cast<uint8>(i);
+  }
+
+  return properties;
+}
+
+[[nodiscard]] auto make_fake_cache_data(const VkPhysicalDeviceProperties& properties)
+    -> std::vector<std::byte>
+{
+  VkPipelineCacheHeaderVersionOne header = {};
+  header.headerSize = sizeof header;
+  header.headerVersion = VK_PIPELINE_CACHE_HEADER_VERSION_ONE;
+  header.vendorID = properties.vendorID;
+  header.deviceID = properties.deviceID;
+  std::memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+  std::vector<std::byte> data(sizeof header + 64);
+  std::memcpy(data.data(), &header, sizeof header);
+
+  return data;
+}
+
+}  // namespace
+
+TEST(PipelineCache, IsPipelineCacheCompatible)
+{
+  const auto properties = make_fake_properties();
+  const auto data = make_fake_cache_data(properties);
+
+  EXPECT_TRUE(is_pipeline_cache_compatible(data.data(), data.size(), properties));
+
+  // Too small to contain a header
+  EXPECT_FALSE(is_pipeline_cache_compatible(data.data(), 8, properties));
+  EXPECT_FALSE(is_pipeline_cache_compatible(nullptr, 0, properties));
+
+  auto other_vendor = properties;
+  other_vendor.vendorID = 0x1002;
+  EXPECT_FALSE(is_pipeline_cache_compatible(data.data(), data.size(), other_vendor));
+
+  auto other_device = properties;
+  other_device.deviceID = 0x1234;
+  EXPECT_FALSE(is_pipeline_cache_compatible(data.data(), data.size(), other_device));
+
+  auto other_driver = properties;
+  other_driver.pipelineCacheUUID[7] = 0xFF;
+  EXPECT_FALSE(is_pipeline_cache_compatible(data.data(), data.size(), other_driver));
+}
+
+GRACE_TEST_FIXTURE(PipelineCacheFixture);
+
+TEST_F(PipelineCacheFixture, SaveAndLoad)
+{
+  const std::filesystem::path path = "pipeline_cache_test.bin";
+  std::filesystem::remove(path);
+
+  VkResult result = VK_ERROR_UNKNOWN;
+
+  // A missing file results in an empty cache
+  auto cache = PipelineCache::load_or_create(mDevice, mGPU, path, &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  ASSERT_TRUE(cache);
+
+  ASSERT_EQ(cache.save(path), VK_SUCCESS);
+  EXPECT_TRUE(std::filesystem::exists(path));
+
+  auto loaded_cache = PipelineCache::load_or_create(mDevice, mGPU, path, &result);
+  EXPECT_EQ(result, VK_SUCCESS);
+  EXPECT_TRUE(loaded_cache);
+
+  std::filesystem::remove(path);
+}
+
+TEST_F(PipelineCacheFixture, LoadIncompatibleFile)
+{
+  const std::filesystem::path path = "pipeline_cache_test_incompatible.bin";
+
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(mGPU, &properties);
+
+  auto other_vendor = properties;
+  other_vendor.vendorID += 1;
+
+  auto other_device = properties;
+  other_device.deviceID += 1;
+
+  auto other_driver = properties;
+  other_driver.pipelineCacheUUID[0] ^= 0xFF;
+
+  auto corrupt_data = make_fake_cache_data(properties);
+  corrupt_data[4] = std::byte {0xFF};  // Invalid header version
+
+  const std::array files = {make_fake_cache_data(other_vendor),
+                            make_fake_cache_data(other_device),
+                            make_fake_cache_data(other_driver),
+                            corrupt_data};
+
+  VkResult result = VK_ERROR_UNKNOWN;
+
+  const auto empty_cache = PipelineCache::make(mDevice, nullptr, 0, 0, &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  const auto empty_size = empty_cache.get_size(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  for (const auto& file : files) {
+    ASSERT_EQ(write_file_atomically(path, file), VK_SUCCESS);
+
+    // The file contents are ignored, so the cache is as if newly created
+    const auto cache = PipelineCache::load_or_create(mDevice, mGPU, path, &result);
+    ASSERT_EQ(result, VK_SUCCESS);
+    ASSERT_TRUE(cache);
+
+    const auto data = cache.get_data(&result);
+    ASSERT_EQ(result, VK_SUCCESS);
+
+    EXPECT_EQ(data.size(), empty_size);
+    EXPECT_TRUE(is_pipeline_cache_compatible(data.data(), data.size(), properties));
+  }
+
+  std::filesystem::remove(path);
+}
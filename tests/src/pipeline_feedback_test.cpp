@@ -0,0 +1,155 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/pipeline_feedback.hpp"
+
+#include <array>  // array
+
+#include <gtest/gtest.h>
+
+#include "test_utils.hpp"
+
+using namespace grace;
+
+#ifdef VK_EXT_pipeline_creation_feedback
+
+TEST(PipelineFeedbackQuery, CreateInfo)
+{
+  int next = 0;
+  PipelineFeedbackQuery query {2, &next};
+
+  const auto* info = query.get_info();
+  ASSERT_NE(info, nullptr);
+
+  EXPECT_EQ(info->sType, VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT);
+  EXPECT_EQ(info->pNext, &next);
+  EXPECT_NE(info->pPipelineCreationFeedback, nullptr);
+  EXPECT_EQ(info->pipelineStageCreationFeedbackCount, 2u);
+  EXPECT_NE(info->pPipelineStageCreationFeedbacks, nullptr);
+}
+
+TEST(PipelineFeedbackQuery, GetFeedback)
+{
+  PipelineFeedbackQuery query {2};
+  const auto* info = query.get_info();
+
+  // Simulate the driver writing the feedback
+  info->pPipelineCreationFeedback->flags =
+      VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT |
+      VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT;
+  info->pPipelineCreationFeedback->duration = 1'000;
+
+  info->pPipelineStageCreationFeedbacks[0].flags =
+      VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT;
+  info->pPipelineStageCreationFeedbacks[0].duration = 600;
+
+  std::array<VkPipelineShaderStageCreateInfo, 2> stages {};
+  stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+  stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+  const auto pipeline = make_fake_ptr<VkPipeline>(0xABC);
+  const auto feedback = query.get_feedback(pipeline, stages);
+
+  EXPECT_EQ(feedback.pipeline, pipeline);
+  EXPECT_EQ(feedback.duration_ns, 1'000u);
+  EXPECT_TRUE(feedback.valid);
+  EXPECT_TRUE(feedback.cache_hit);
+  EXPECT_FALSE(feedback.base_pipeline_acceleration);
+
+  ASSERT_EQ(feedback.stages.size(), 2u);
+
+  EXPECT_EQ(feedback.stages[0].stage, VK_SHADER_STAGE_VERTEX_BIT);
+  EXPECT_EQ(feedback.stages[0].duration_ns, 600u);
+  EXPECT_TRUE(feedback.stages[0].valid);
+  EXPECT_FALSE(feedback.stages[0].cache_hit);
+
+  EXPECT_EQ(feedback.stages[1].stage, VK_SHADER_STAGE_FRAGMENT_BIT);
+  EXPECT_FALSE(feedback.stages[1].valid);
+}
+
+GRACE_TEST_FIXTURE(PipelineFeedbackFixture);
+
+TEST_F(PipelineFeedbackFixture, BuilderCallback)
+{
+  if (!has_device_extension(mGPU, VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME)) {
+    GTEST_SKIP() << "VK_EXT_pipeline_creation_feedback is not supported";
+  }
+
+  auto objects = make_test_pipeline_objects(mDevice);
+  ASSERT_TRUE(objects.pipeline_layout);
+
+  usize callback_count = 0;
+  PipelineFeedback feedback;
+
+  auto builder = make_test_pipeline_builder(mDevice, objects);
+  builder.with_feedback_callback(
+      [&](const PipelineFeedback& pipeline_feedback) {
+        ++callback_count;
+        feedback = pipeline_feedback;
+      },
+      true);
+
+  VkResult result = VK_ERROR_UNKNOWN;
+  auto pipeline = builder.build(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  ASSERT_TRUE(pipeline);
+
+  // One stage entry is reported for each of the vertex and fragment shaders
+  EXPECT_EQ(callback_count, 1u);
+  EXPECT_EQ(feedback.pipeline, pipeline.get());
+  ASSERT_EQ(feedback.stages.size(), 2u);
+  EXPECT_EQ(feedback.stages[0].stage, VK_SHADER_STAGE_VERTEX_BIT);
+  EXPECT_EQ(feedback.stages[1].stage, VK_SHADER_STAGE_FRAGMENT_BIT);
+}
+
+TEST_F(PipelineFeedbackFixture, BuilderCallbackWithoutFeedback)
+{
+  auto objects = make_test_pipeline_objects(mDevice);
+  ASSERT_TRUE(objects.pipeline_layout);
+
+  usize callback_count = 0;
+  PipelineFeedback feedback;
+  feedback.valid = true;
+
+  auto builder = make_test_pipeline_builder(mDevice, objects);
+  builder.with_feedback_callback(
+      [&](const PipelineFeedback& pipeline_feedback) {
+        ++callback_count;
+        feedback = pipeline_feedback;
+      },
+      false);
+
+  VkResult result = VK_ERROR_UNKNOWN;
+  auto pipeline = builder.build(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  ASSERT_TRUE(pipeline);
+
+  // The pipeline is still reported, but without any statistics
+  EXPECT_EQ(callback_count, 1u);
+  EXPECT_EQ(feedback.pipeline, pipeline.get());
+  EXPECT_FALSE(feedback.valid);
+  EXPECT_TRUE(feedback.stages.empty());
+}
+
+#endif  // VK_EXT_pipeline_creation_feedback
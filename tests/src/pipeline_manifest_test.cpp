@@ -0,0 +1,234 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/pipeline_manifest.hpp"
+
+#include <cstddef>     // byte
+#include <filesystem>  // temp_directory_path, remove
+
+#include <gtest/gtest.h>
+
+#include "test_shaders.hpp"
+#include "test_utils.hpp"
+
+using namespace grace;
+
+GRACE_TEST_FIXTURE(PipelineManifestFixture);
+
+TEST_F(PipelineManifestFixture, SerializeRoundtrip)
+{
+  SpecializationConstants constants;
+  constants.set(0, true).set(1, 42.0).set(2, 7u);
+
+  GraphicsPipelineBuilder builder {mDevice};
+  builder.vertex_shader("assets/shaders/test.vert.spv")
+      .fragment_shader("assets/shaders/test.frag.spv", "main")
+      .fragment_specialization(constants)
+      .vertex_input_binding(0, 3 * sizeof(float))
+      .vertex_attribute(0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0)
+      .tessellation(3)
+      .rasterization(VK_POLYGON_MODE_LINE, VK_CULL_MODE_BACK_BIT)
+      .line_width(2.0f)
+      .depth_test(true, VK_COMPARE_OP_GREATER)
+      .depth_write(true)
+      .color_blend_attachment(true)
+      .dynamic_state(VK_DYNAMIC_STATE_VIEWPORT)
+      .dynamic_state(VK_DYNAMIC_STATE_SCISSOR);
+
+  const auto state = builder.serialize();
+  ASSERT_FALSE(state.empty());
+
+  auto restored = GraphicsPipelineBuilder::deserialize(mDevice, state);
+  ASSERT_TRUE(restored.has_value());
+  EXPECT_EQ(restored->serialize(), state);
+
+  // Handles aren't serialized, so they must be specified again
+  const auto layout = make_fake_ptr<VkPipelineLayout>(0x10);
+  builder.with_layout(layout);
+  EXPECT_NE(restored->get_state_key(), builder.get_state_key());
+
+  restored->with_layout(layout);
+  EXPECT_EQ(restored->get_state_key(), builder.get_state_key());
+}
+
+TEST_F(PipelineManifestFixture, SerializeEmbeddedShaders)
+{
+  GraphicsPipelineBuilder builder {mDevice};
+  builder.vertex_shader(test_shaders::kTestVertSpv)
+      .fragment_shader(test_shaders::kTestFragSpv);
+
+  const auto state = builder.serialize();
+  ASSERT_FALSE(state.empty());
+
+  // The code is resolved by hash
+  EXPECT_FALSE(GraphicsPipelineBuilder::deserialize(mDevice, state).has_value());
+
+  const ShaderCodeResolver resolver = [](const uint64 code_hash) {
+    for (const std::span<const uint32> code :
+         {std::span<const uint32> {test_shaders::kTestVertSpv},
+          std::span<const uint32> {test_shaders::kTestFragSpv}}) {
+      if (fnv1a_hash(code.data(), code.size_bytes()) == code_hash) {
+        return code;
+      }
+    }
+
+    return std::span<const uint32> {};
+  };
+
+  const auto restored = GraphicsPipelineBuilder::deserialize(mDevice, state, resolver);
+  ASSERT_TRUE(restored.has_value());
+  EXPECT_EQ(restored->get_state_key(), builder.get_state_key());
+}
+
+TEST_F(PipelineManifestFixture, SerializeShaderModule)
+{
+  GraphicsPipelineBuilder builder {mDevice};
+  builder.vertex_shader(make_fake_ptr<VkShaderModule>(0x20));
+
+  EXPECT_TRUE(builder.serialize().empty());
+}
+
+TEST_F(PipelineManifestFixture, DeserializeInvalidState)
+{
+  GraphicsPipelineBuilder builder {mDevice};
+  builder.vertex_shader("assets/shaders/test.vert.spv");
+
+  auto state = builder.serialize();
+  ASSERT_FALSE(state.empty());
+
+  const auto truncated = std::span {state}.first(state.size() - 1);
+  EXPECT_FALSE(GraphicsPipelineBuilder::deserialize(mDevice, {}).has_value());
+  EXPECT_FALSE(GraphicsPipelineBuilder::deserialize(mDevice, truncated).has_value());
+
+  state.push_back(std::byte {0});
+  EXPECT_FALSE(GraphicsPipelineBuilder::deserialize(mDevice, state).has_value());
+}
+
+TEST_F(PipelineManifestFixture, RecordRequiresRegisteredHandles)
+{
+  const auto layout = make_fake_ptr<VkPipelineLayout>(0x10);
+  const auto render_pass = make_fake_ptr<VkRenderPass>(0x20);
+
+  GraphicsPipelineBuilder builder {mDevice};
+  builder.with_layout(layout)
+      .with_render_pass(render_pass, 0)
+      .vertex_shader("assets/shaders/test.vert.spv");
+
+  PipelineManifest manifest;
+  EXPECT_FALSE(manifest.record(builder));
+
+  manifest.register_layout("main", layout);
+  EXPECT_FALSE(manifest.record(builder));
+
+  manifest.register_render_pass("forward", render_pass);
+  EXPECT_TRUE(manifest.record(builder));
+  EXPECT_TRUE(manifest.record(builder));
+  EXPECT_EQ(manifest.size(), 1u);
+
+  builder.line_width(2.0f);
+  EXPECT_TRUE(manifest.record(builder));
+  EXPECT_EQ(manifest.size(), 2u);
+
+  manifest.clear();
+  EXPECT_EQ(manifest.size(), 0u);
+}
+
+TEST_F(PipelineManifestFixture, SaveAndLoad)
+{
+  const auto path = std::filesystem::temp_directory_path() / "grace_manifest_test.bin";
+  const auto layout = make_fake_ptr<VkPipelineLayout>(0x10);
+
+  PipelineManifest manifest;
+  manifest.register_layout("main", layout);
+
+  GraphicsPipelineBuilder builder {mDevice};
+  builder.with_layout(layout).vertex_shader("assets/shaders/test.vert.spv");
+  ASSERT_TRUE(manifest.record(builder));
+
+  builder.primitive_topology(VK_PRIMITIVE_TOPOLOGY_LINE_LIST);
+  ASSERT_TRUE(manifest.record(builder));
+
+  ASSERT_EQ(manifest.save(path), VK_SUCCESS);
+
+  PipelineManifest loaded;
+  EXPECT_EQ(loaded.load(path), VK_SUCCESS);
+  EXPECT_EQ(loaded.size(), 2u);
+
+  // Loading the same entries again doesn't add any duplicates
+  EXPECT_EQ(loaded.load(path), VK_SUCCESS);
+  EXPECT_EQ(loaded.size(), 2u);
+
+  std::filesystem::remove(path);
+  EXPECT_NE(loaded.load(path), VK_SUCCESS);
+}
+
+TEST_F(PipelineManifestFixture, WarmUp)
+{
+  VkResult result = VK_ERROR_UNKNOWN;
+
+  auto objects = make_test_pipeline_objects(mDevice);
+  ASSERT_TRUE(objects.pipeline_layout);
+
+  // Embedded shaders are recorded by code hashes, rather than by file paths
+  auto builder = make_test_pipeline_builder(mDevice, objects);
+  builder.vertex_shader(test_shaders::kTestVertSpv)
+      .fragment_shader(test_shaders::kTestFragSpv);
+
+  PipelineManifest manifest;
+  manifest.register_layout("main", objects.pipeline_layout);
+  manifest.register_render_pass("forward", objects.render_pass);
+  manifest.register_shader_code(test_shaders::kTestVertSpv);
+  manifest.register_shader_code(test_shaders::kTestFragSpv);
+
+  // Pipelines built by the registry are recorded
+  {
+    PipelineRegistry registry;
+    registry.set_manifest(&manifest);
+
+    ASSERT_NE(registry.get(builder, &result), VK_NULL_HANDLE);
+    EXPECT_EQ(manifest.size(), 1u);
+  }
+
+  PipelineRegistry registry;
+  ThreadPool pool {2};
+
+  auto results = manifest.warm_up(mDevice, registry, pool);
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_EQ(results.front().get(), VK_SUCCESS);
+
+  EXPECT_EQ(registry.size(), 1u);
+  EXPECT_NE(registry.find(builder), VK_NULL_HANDLE);
+
+  // Pipelines can also be built with per-thread pipeline caches
+  PipelineRegistry cached_registry;
+  PipelineCachePool caches {PipelineCache::make(mDevice)};
+
+  results = manifest.warm_up(mDevice, cached_registry, pool, caches);
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_EQ(results.front().get(), VK_SUCCESS);
+
+  EXPECT_NE(cached_registry.find(builder), VK_NULL_HANDLE);
+  EXPECT_EQ(caches.thread_count(), 1u);
+  EXPECT_EQ(caches.merge(), VK_SUCCESS);
+}
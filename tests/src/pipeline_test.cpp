@@ -27,8 +27,12 @@
 #include <gtest/gtest.h>
 
 #include "grace/descriptor_set_layout.hpp"
+#include "grace/dynamic_state.hpp"
 #include "grace/pipeline_layout.hpp"
+#include "grace/pipeline_library.hpp"
+#include "grace/pipeline_registry.hpp"
 #include "grace/render_pass.hpp"
+#include "test_shaders.hpp"
 #include "test_utils.hpp"
 
 using namespace grace;
@@ -404,4 +408,315 @@ TEST_F(PipelineFixture, GraphicsPipelineBuilderMinimalPipeline)
 
   ASSERT_EQ(result, VK_SUCCESS);
   ASSERT_TRUE(pipeline);
-}
\ No newline at end of file
+}
+
+TEST_F(PipelineFixture, GraphicsPipelineBuilderBuildMany)
+{
+  ThreadPool pool {2};
+
+  // The builders are incomplete, so no pipelines should be created
+  const std::vector builders = {GraphicsPipelineBuilder {mDevice},
+                                GraphicsPipelineBuilder {mDevice},
+                                GraphicsPipelineBuilder {mDevice}};
+
+  auto pipelines = GraphicsPipelineBuilder::build_many(builders, pool);
+  ASSERT_EQ(pipelines.size(), builders.size());
+
+  for (auto& future : pipelines) {
+    const auto pipeline = future.get();
+    EXPECT_EQ(pipeline.result, VK_INCOMPLETE);
+    EXPECT_FALSE(pipeline.pipeline);
+  }
+}
+
+TEST_F(PipelineFixture, GraphicsPipelineBuilderBuildManyComplete)
+{
+  ThreadPool pool {2};
+
+  auto objects = make_test_pipeline_objects(mDevice);
+  ASSERT_TRUE(objects.pipeline_layout);
+
+  const auto builder = make_test_pipeline_builder(mDevice, objects);
+
+  auto embedded_builder = builder;
+  embedded_builder.vertex_shader(test_shaders::kTestVertSpv)
+      .fragment_shader(test_shaders::kTestFragSpv);
+
+  const std::vector builders = {builder, embedded_builder, builder, embedded_builder};
+
+  auto pipelines = GraphicsPipelineBuilder::build_many(builders, pool);
+  ASSERT_EQ(pipelines.size(), builders.size());
+
+  for (auto& future : pipelines) {
+    const auto pipeline = future.get();
+    EXPECT_EQ(pipeline.result, VK_SUCCESS);
+    EXPECT_TRUE(pipeline.pipeline);
+  }
+}
+
+TEST_F(PipelineFixture, GraphicsPipelineBuilderStateKey)
+{
+  const auto make_builder = [] {
+    GraphicsPipelineBuilder builder {mDevice};
+    builder.vertex_shader("assets/shaders/test.vert.spv")
+        .fragment_shader("assets/shaders/test.frag.spv")
+        .vertex_input_binding(0, 8 * sizeof(float))
+        .vertex_attribute(0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0)
+        .color_blend_attachment(false)
+        .dynamic_state(VK_DYNAMIC_STATE_VIEWPORT);
+    return builder;
+  };
+
+  const auto a = make_builder();
+  auto b = make_builder();
+
+  EXPECT_EQ(a.get_state_key(), b.get_state_key());
+  EXPECT_EQ(a.get_state_hash(), b.get_state_hash());
+
+  // The pipeline cache doesn't affect the resulting pipeline
+  b.with_cache(make_fake_ptr<VkPipelineCache>(42));
+  EXPECT_EQ(a.get_state_key(), b.get_state_key());
+
+  b.rasterization(VK_POLYGON_MODE_LINE);
+  EXPECT_NE(a.get_state_key(), b.get_state_key());
+  EXPECT_NE(a.get_state_hash(), b.get_state_hash());
+
+  b.rasterization(GraphicsPipelineBuilder::kDefaultPolygonMode);
+  EXPECT_EQ(a.get_state_key(), b.get_state_key());
+
+  b.depth_test(true);
+  EXPECT_NE(a.get_state_key(), b.get_state_key());
+}
+
+TEST_F(PipelineFixture, PipelineRegistryIncompleteBuilder)
+{
+  PipelineRegistry registry;
+  EXPECT_EQ(registry.size(), 0u);
+
+  const GraphicsPipelineBuilder builder {mDevice};
+
+  VkResult result = VK_SUCCESS;
+  EXPECT_EQ(registry.get(builder, &result), VK_NULL_HANDLE);
+  EXPECT_EQ(result, VK_INCOMPLETE);
+  EXPECT_EQ(registry.find(builder), VK_NULL_HANDLE);
+  EXPECT_EQ(registry.size(), 0u);
+}
+
+TEST_F(PipelineFixture, GraphicsPipelineBuilderSpecializationStateKey)
+{
+  SpecializationConstants constants;
+  constants.set(0, true);
+
+  auto builder = GraphicsPipelineBuilder {mDevice};
+  const auto base_key = builder.get_state_key();
+
+  builder.fragment_specialization(constants);
+  const auto enabled_key = builder.get_state_key();
+  EXPECT_NE(base_key, enabled_key);
+
+  constants.set(0, false);
+  builder.fragment_specialization(constants);
+  EXPECT_NE(builder.get_state_key(), enabled_key);
+
+  builder.reset();
+  EXPECT_EQ(builder.get_state_key(), base_key);
+}
+
+#ifdef VK_KHR_dynamic_rendering
+
+TEST_F(PipelineFixture, GraphicsPipelineBuilderRenderingFormats)
+{
+  GraphicsPipelineBuilder builder {mDevice};
+
+  auto rendering_info = builder.get_rendering_info();
+  EXPECT_EQ(rendering_info.sType, VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR);
+  EXPECT_EQ(rendering_info.colorAttachmentCount, 0u);
+  EXPECT_EQ(rendering_info.pColorAttachmentFormats, nullptr);
+  EXPECT_EQ(rendering_info.depthAttachmentFormat, VK_FORMAT_UNDEFINED);
+  EXPECT_EQ(rendering_info.stencilAttachmentFormat, VK_FORMAT_UNDEFINED);
+
+  const auto initial_key = builder.get_state_key();
+
+  builder.with_rendering_formats({VK_FORMAT_B8G8R8A8_SRGB, VK_FORMAT_R16G16B16A16_SFLOAT},
+                                 VK_FORMAT_D32_SFLOAT_S8_UINT,
+                                 VK_FORMAT_D32_SFLOAT_S8_UINT);
+  EXPECT_NE(builder.get_state_key(), initial_key);
+
+  rendering_info = builder.get_rendering_info();
+  ASSERT_EQ(rendering_info.colorAttachmentCount, 2u);
+  ASSERT_NE(rendering_info.pColorAttachmentFormats, nullptr);
+  EXPECT_EQ(rendering_info.pColorAttachmentFormats[0], VK_FORMAT_B8G8R8A8_SRGB);
+  EXPECT_EQ(rendering_info.pColorAttachmentFormats[1], VK_FORMAT_R16G16B16A16_SFLOAT);
+  EXPECT_EQ(rendering_info.depthAttachmentFormat, VK_FORMAT_D32_SFLOAT_S8_UINT);
+  EXPECT_EQ(rendering_info.stencilAttachmentFormat, VK_FORMAT_D32_SFLOAT_S8_UINT);
+
+  builder.reset();
+  EXPECT_EQ(builder.get_state_key(), initial_key);
+  EXPECT_EQ(builder.get_rendering_info().colorAttachmentCount, 0u);
+}
+
+#endif  // VK_KHR_dynamic_rendering
+
+TEST_F(PipelineFixture, GraphicsPipelineBuilderDynamicStateKey)
+{
+  GraphicsPipelineBuilder a {mDevice};
+  GraphicsPipelineBuilder b {mDevice};
+
+  a.line_width(2.0f);
+  b.line_width(4.0f);
+  EXPECT_NE(a.get_state_key(), b.get_state_key());
+
+  // Baked values of dynamic states don't affect the key, nor does the state order
+  a.dynamic_state(VK_DYNAMIC_STATE_LINE_WIDTH).dynamic_state(VK_DYNAMIC_STATE_VIEWPORT);
+  b.dynamic_state(VK_DYNAMIC_STATE_VIEWPORT).dynamic_state(VK_DYNAMIC_STATE_LINE_WIDTH);
+  EXPECT_EQ(a.get_state_key(), b.get_state_key());
+
+  // Duplicate dynamic states are ignored
+  b.dynamic_state(VK_DYNAMIC_STATE_VIEWPORT);
+  EXPECT_EQ(a.get_state_key(), b.get_state_key());
+  EXPECT_EQ(b.get_dynamic_state_info().dynamicStateCount, 2u);
+
+#ifdef VK_EXT_extended_dynamic_state
+  a.rasterization(VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT, VK_FRONT_FACE_CLOCKWISE)
+      .depth_test(true, VK_COMPARE_OP_GREATER)
+      .depth_write(true);
+  EXPECT_NE(a.get_state_key(), b.get_state_key());
+
+  a.dynamic_states(kExtendedDynamicStates);
+  b.dynamic_states(kExtendedDynamicStates);
+  EXPECT_EQ(a.get_state_key(), b.get_state_key());
+  EXPECT_EQ(a.get_dynamic_state_info().dynamicStateCount,
+            2u + static_cast<uint32>(kExtendedDynamicStates.size()));
+#endif  // VK_EXT_extended_dynamic_state
+
+#ifdef VK_EXT_extended_dynamic_state2
+  a.color_logic_op(true, VK_LOGIC_OP_XOR);
+  b.color_logic_op(true, VK_LOGIC_OP_AND);
+  EXPECT_NE(a.get_state_key(), b.get_state_key());
+
+  // The logic operator is dynamic, but whether it's enabled is still baked
+  a.dynamic_states(kExtendedDynamicStates2);
+  b.dynamic_states(kExtendedDynamicStates2);
+  EXPECT_EQ(a.get_state_key(), b.get_state_key());
+#endif  // VK_EXT_extended_dynamic_state2
+}
+
+#ifdef VK_EXT_graphics_pipeline_library
+
+TEST_F(PipelineFixture, GraphicsPipelineBuilderLibraryStateKeys)
+{
+  constexpr auto vertex_input =
+      VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT;
+  constexpr auto pre_rasterization =
+      VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT;
+  constexpr auto fragment_shader = VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+  constexpr auto fragment_output =
+      VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+
+  GraphicsPipelineBuilder a {mDevice};
+  a.vertex_shader("assets/shaders/test.vert.spv")
+      .fragment_shader("assets/shaders/test.frag.spv")
+      .color_blend_attachment(false);
+
+  auto b = a;
+  b.fragment_shader("assets/shaders/other.frag.spv").depth_test(true);
+
+  // Only the fragment shader part differs
+  EXPECT_NE(a.get_state_key(), b.get_state_key());
+  EXPECT_EQ(a.get_library_state_key(vertex_input), b.get_library_state_key(vertex_input));
+  EXPECT_EQ(a.get_library_state_key(pre_rasterization),
+            b.get_library_state_key(pre_rasterization));
+  EXPECT_NE(a.get_library_state_key(fragment_shader),
+            b.get_library_state_key(fragment_shader));
+  EXPECT_EQ(a.get_library_state_key(fragment_output),
+            b.get_library_state_key(fragment_output));
+
+  // Keys of different parts never match
+  EXPECT_NE(a.get_library_state_key(vertex_input),
+            a.get_library_state_key(fragment_output));
+
+  b.rasterization(VK_POLYGON_MODE_LINE);
+  EXPECT_NE(a.get_library_state_key(pre_rasterization),
+            b.get_library_state_key(pre_rasterization));
+  EXPECT_EQ(a.get_library_state_key(vertex_input), b.get_library_state_key(vertex_input));
+}
+
+TEST_F(PipelineFixture, GraphicsPipelineBuilderIncompleteLibrary)
+{
+  const GraphicsPipelineBuilder builder {mDevice};
+
+  VkResult result = VK_SUCCESS;
+  auto library = builder.build_library(0, &result);
+  EXPECT_FALSE(library);
+  EXPECT_EQ(result, VK_INCOMPLETE);
+
+  result = VK_SUCCESS;
+  library = builder.build_library(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+                                  &result);
+  EXPECT_FALSE(library);
+  EXPECT_EQ(result, VK_INCOMPLETE);
+}
+
+TEST_F(PipelineFixture, PipelineLibraryCacheSharesLibraries)
+{
+  if (!is_graphics_pipeline_library_supported(mGPU)) {
+    GTEST_SKIP() << "VK_EXT_graphics_pipeline_library is not supported";
+  }
+
+  auto objects = make_test_pipeline_objects(mDevice);
+  ASSERT_TRUE(objects.pipeline_layout);
+
+  const auto a = make_test_pipeline_builder(mDevice, objects);
+
+  auto b = a;
+  b.fragment_shader(test_shaders::kTestFragSpv);
+
+  PipelineLibraryCache cache;
+
+  VkResult result = VK_ERROR_UNKNOWN;
+  auto pipeline_a = cache.link(a, false, &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  EXPECT_TRUE(pipeline_a);
+  EXPECT_EQ(cache.size(), 4u);
+
+  // Only the fragment shader library differs, so the other three are reused
+  result = VK_ERROR_UNKNOWN;
+  auto pipeline_b = cache.link(b, false, &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  EXPECT_TRUE(pipeline_b);
+  EXPECT_EQ(cache.size(), 5u);
+}
+
+#endif  // VK_EXT_graphics_pipeline_library
+
+TEST_F(PipelineFixture, GraphicsPipelineBuilderEmbeddedShaders)
+{
+  GraphicsPipelineBuilder a {mDevice};
+  a.vertex_shader(test_shaders::kTestVertSpv).fragment_shader(test_shaders::kTestFragSpv);
+
+  // Embedded shaders don't depend on any files
+  EXPECT_TRUE(a.get_shader_paths().empty());
+
+  auto b = a;
+  EXPECT_EQ(a.get_state_key(), b.get_state_key());
+
+  b.fragment_shader(test_shaders::kTestVertSpv);
+  EXPECT_NE(a.get_state_key(), b.get_state_key());
+
+  b.fragment_shader("assets/shaders/test.frag.spv");
+  EXPECT_NE(a.get_state_key(), b.get_state_key());
+  EXPECT_EQ(b.get_shader_paths().size(), 1u);
+
+  auto objects = make_test_pipeline_objects(mDevice);
+  ASSERT_TRUE(objects.pipeline_layout);
+
+  auto builder = make_test_pipeline_builder(mDevice, objects);
+  builder.vertex_shader(test_shaders::kTestVertSpv)
+      .fragment_shader(test_shaders::kTestFragSpv);
+
+  VkResult result = VK_ERROR_UNKNOWN;
+  auto pipeline = builder.build(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  EXPECT_TRUE(pipeline);
+  EXPECT_TRUE(builder.get_shader_paths().empty());
+}
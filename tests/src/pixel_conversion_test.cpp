@@ -0,0 +1,139 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/pixel_conversion.hpp"
+
+#include <array>   // array
+#include <limits>  // numeric_limits
+
+#include <gtest/gtest.h>
+
+using namespace grace;
+
+TEST(PixelConversion, TexelSizes)
+{
+  EXPECT_EQ(get_source_texel_size(PixelConversion::kRgb8ToRgba8), 3);
+  EXPECT_EQ(get_target_texel_size(PixelConversion::kRgb8ToRgba8), 4);
+
+  EXPECT_EQ(get_source_texel_size(PixelConversion::kLinearRgba32fToSrgba8), 16);
+  EXPECT_EQ(get_target_texel_size(PixelConversion::kLinearRgba32fToSrgba8), 4);
+
+  EXPECT_EQ(get_source_texel_size(PixelConversion::kRgba32fToRgba16f), 16);
+  EXPECT_EQ(get_target_texel_size(PixelConversion::kRgba32fToRgba16f), 8);
+
+  EXPECT_EQ(get_source_texel_size(PixelConversion::kPremultiplyRgba8), 4);
+  EXPECT_EQ(get_target_texel_size(PixelConversion::kPremultiplyRgba8), 4);
+}
+
+TEST(PixelConversion, IsConversionTarget)
+{
+  EXPECT_TRUE(is_conversion_target(PixelConversion::kRgb8ToRgba8,
+                                   VK_FORMAT_R8G8B8A8_UNORM));
+  EXPECT_TRUE(is_conversion_target(PixelConversion::kRgb8ToRgba8,
+                                   VK_FORMAT_R8G8B8A8_SRGB));
+  EXPECT_FALSE(is_conversion_target(PixelConversion::kRgb8ToRgba8,
+                                    VK_FORMAT_R8G8B8_UNORM));
+
+  EXPECT_TRUE(is_conversion_target(PixelConversion::kLinearRgba32fToSrgba8,
+                                   VK_FORMAT_R8G8B8A8_SRGB));
+  EXPECT_FALSE(is_conversion_target(PixelConversion::kLinearRgba32fToSrgba8,
+                                    VK_FORMAT_R8G8B8A8_UNORM));
+
+  EXPECT_TRUE(is_conversion_target(PixelConversion::kRgba32fToRgba16f,
+                                   VK_FORMAT_R16G16B16A16_SFLOAT));
+  EXPECT_FALSE(is_conversion_target(PixelConversion::kRgba32fToRgba16f,
+                                    VK_FORMAT_R32G32B32A32_SFLOAT));
+
+  EXPECT_TRUE(is_conversion_target(PixelConversion::kPremultiplyRgba8,
+                                   VK_FORMAT_R8G8B8A8_UNORM));
+  EXPECT_FALSE(is_conversion_target(PixelConversion::kPremultiplyRgba8,
+                                    VK_FORMAT_B8G8R8A8_UNORM));
+}
+
+TEST(PixelConversion, FloatToHalf)
+{
+  EXPECT_EQ(float_to_half(0.0f), 0x0000);
+  EXPECT_EQ(float_to_half(-0.0f), 0x8000);
+  EXPECT_EQ(float_to_half(1.0f), 0x3C00);
+  EXPECT_EQ(float_to_half(0.5f), 0x3800);
+  EXPECT_EQ(float_to_half(-2.0f), 0xC000);
+  EXPECT_EQ(float_to_half(65504.0f), 0x7BFF);
+  EXPECT_EQ(float_to_half(1e6f), 0x7C00);
+  EXPECT_EQ(float_to_half(6e-8f), 0x0001);
+  EXPECT_EQ(float_to_half(std::numeric_limits<float>::infinity()), 0x7C00);
+  EXPECT_EQ(float_to_half(std::numeric_limits<float>::quiet_NaN()), 0x7E00);
+}
+
+TEST(PixelConversion, Rgb8ToRgba8)
+{
+  const std::array<uint8, 6> source = {1, 2, 3, 4, 5, 6};
+  std::array<uint8, 8> destination {};
+
+  convert_pixels(PixelConversion::kRgb8ToRgba8, source.data(), destination.data(), 2);
+
+  const std::array<uint8, 8> expected = {1, 2, 3, 255, 4, 5, 6, 255};
+  EXPECT_EQ(destination, expected);
+}
+
+TEST(PixelConversion, LinearRgba32fToSrgba8)
+{
+  const std::array<float, 8> source = {0.0f, 0.5f, 1.0f, 0.5f, 2.0f, -1.0f, 0.2f, 1.0f};
+  std::array<uint8, 8> destination {};
+
+  convert_pixels(PixelConversion::kLinearRgba32fToSrgba8,
+                 source.data(),
+                 destination.data(),
+                 2);
+
+  const std::array<uint8, 8> expected = {0, 188, 255, 128, 255, 0, 124, 255};
+  EXPECT_EQ(destination, expected);
+}
+
+TEST(PixelConversion, Rgba32fToRgba16f)
+{
+  const std::array<float, 4> source = {1.0f, 0.5f, -2.0f, 0.0f};
+  std::array<uint16, 4> destination {};
+
+  convert_pixels(PixelConversion::kRgba32fToRgba16f,
+                 source.data(),
+                 destination.data(),
+                 1);
+
+  const std::array<uint16, 4> expected = {0x3C00, 0x3800, 0xC000, 0x0000};
+  EXPECT_EQ(destination, expected);
+}
+
+TEST(PixelConversion, PremultiplyRgba8)
+{
+  const std::array<uint8, 8> source = {255, 128, 0, 128, 10, 20, 30, 255};
+  std::array<uint8, 8> destination {};
+
+  convert_pixels(PixelConversion::kPremultiplyRgba8,
+                 source.data(),
+                 destination.data(),
+                 2);
+
+  const std::array<uint8, 8> expected = {128, 64, 0, 128, 10, 20, 30, 255};
+  EXPECT_EQ(destination, expected);
+}
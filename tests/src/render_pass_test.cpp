@@ -214,4 +214,24 @@ TEST_F(RenderPassFixture, RenderPassBuilderAdvancedRenderPass)
   EXPECT_EQ(render_pass_info.pSubpasses, subpass_descriptions.data());
   EXPECT_NE(render_pass_info.pAttachments, nullptr);
   EXPECT_NE(render_pass_info.pDependencies, nullptr);
+
+  EXPECT_EQ(render_pass_info.pAttachments[3].storeOp, VK_ATTACHMENT_STORE_OP_STORE);
+}
+
+TEST_F(RenderPassFixture, TransientDepthAttachment)
+{
+  RenderPassBuilder builder {mDevice};
+  builder.depth_attachment(VK_FORMAT_D32_SFLOAT,
+                           VK_IMAGE_LAYOUT_UNDEFINED,
+                           VK_SAMPLE_COUNT_1_BIT,
+                           VK_ATTACHMENT_STORE_OP_DONT_CARE);
+
+  const auto subpass_descriptions = builder.get_subpass_descriptions();
+  const auto render_pass_info = builder.get_render_pass_info(subpass_descriptions);
+
+  ASSERT_EQ(render_pass_info.attachmentCount, 1);
+  EXPECT_EQ(render_pass_info.pAttachments[0].format, VK_FORMAT_D32_SFLOAT);
+  EXPECT_EQ(render_pass_info.pAttachments[0].storeOp, VK_ATTACHMENT_STORE_OP_DONT_CARE);
+  EXPECT_EQ(render_pass_info.pAttachments[0].finalLayout,
+            VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
 }
@@ -0,0 +1,166 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/rendering.hpp"
+
+#include <array>  // array
+
+#include <gtest/gtest.h>
+
+#include "grace/command_pool.hpp"
+#include "grace/image.hpp"
+#include "grace/physical_device.hpp"
+#include "grace/pipeline.hpp"
+#include "test_utils.hpp"
+
+using namespace grace;
+
+#ifdef VK_KHR_dynamic_rendering
+
+TEST(Rendering, MakeRenderingAttachmentInfo)
+{
+  const auto image_view = make_fake_ptr<VkImageView>(42);
+
+  VkClearValue clear_value = {};
+  clear_value.color.float32[0] = 0.5f;
+  clear_value.color.float32[3] = 1.0f;
+
+  const auto info =
+      make_rendering_attachment_info(image_view,
+                                     VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                                     VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                     VK_ATTACHMENT_STORE_OP_STORE,
+                                     clear_value);
+
+  EXPECT_EQ(info.sType, VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR);
+  EXPECT_EQ(info.pNext, nullptr);
+  EXPECT_EQ(info.imageView, image_view);
+  EXPECT_EQ(info.imageLayout, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  EXPECT_EQ(info.resolveMode, VK_RESOLVE_MODE_NONE);
+  EXPECT_EQ(info.resolveImageView, VK_NULL_HANDLE);
+  EXPECT_EQ(info.loadOp, VK_ATTACHMENT_LOAD_OP_CLEAR);
+  EXPECT_EQ(info.storeOp, VK_ATTACHMENT_STORE_OP_STORE);
+  EXPECT_EQ(info.clearValue.color.float32[0], 0.5f);
+  EXPECT_EQ(info.clearValue.color.float32[3], 1.0f);
+}
+
+TEST(Rendering, MakeRenderingInfo)
+{
+  const VkRect2D render_area = {{0, 0}, {800, 600}};
+
+  const std::array color_attachments = {
+      make_rendering_attachment_info(make_fake_ptr<VkImageView>(1),
+                                     VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL),
+      make_rendering_attachment_info(make_fake_ptr<VkImageView>(2),
+                                     VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL),
+  };
+
+  const auto depth_attachment =
+      make_rendering_attachment_info(make_fake_ptr<VkImageView>(3),
+                                     VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                                     VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                     VK_ATTACHMENT_STORE_OP_DONT_CARE);
+
+  const auto info =
+      make_rendering_info(render_area, color_attachments, &depth_attachment);
+
+  EXPECT_EQ(info.sType, VK_STRUCTURE_TYPE_RENDERING_INFO_KHR);
+  EXPECT_EQ(info.pNext, nullptr);
+  EXPECT_EQ(info.flags, 0u);
+  EXPECT_EQ(info.renderArea.extent.width, 800u);
+  EXPECT_EQ(info.renderArea.extent.height, 600u);
+  EXPECT_EQ(info.layerCount, 1u);
+  EXPECT_EQ(info.viewMask, 0u);
+  EXPECT_EQ(info.colorAttachmentCount, 2u);
+  EXPECT_EQ(info.pColorAttachments, color_attachments.data());
+  EXPECT_EQ(info.pDepthAttachment, &depth_attachment);
+  EXPECT_EQ(info.pStencilAttachment, nullptr);
+}
+
+GRACE_TEST_FIXTURE(RenderingFixture);
+
+TEST_F(RenderingFixture, RenderWithoutRenderPass)
+{
+  const auto functions = get_dynamic_rendering_functions(mDevice);
+  if (!functions.vkCmdBeginRenderingKHR || !functions.vkCmdEndRenderingKHR) {
+    GTEST_SKIP() << "VK_KHR_dynamic_rendering is not supported";
+  }
+
+  constexpr VkFormat color_format = VK_FORMAT_B8G8R8A8_UNORM;
+  const VkExtent2D extent = {64, 64};
+
+  auto objects = make_test_pipeline_objects(mDevice);
+  ASSERT_TRUE(objects.pipeline_layout);
+
+  // The pipeline isn't tied to any render pass, only to the attachment formats
+  VkResult result = VK_ERROR_UNKNOWN;
+  auto pipeline = make_test_pipeline_builder(mDevice, objects)
+                      .with_render_pass(VK_NULL_HANDLE, 0)
+                      .with_rendering_formats({color_format})
+                      .build(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  ASSERT_TRUE(pipeline);
+
+  auto image = Image::make(mAllocator,
+                           VK_IMAGE_TYPE_2D,
+                           {extent.width, extent.height, 1},
+                           color_format,
+                           VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT);
+  ASSERT_TRUE(image);
+
+  const auto image_view = image.get_view({}, &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  const auto graphics_family = get_queue_family_indices(mGPU, mSurface).graphics;
+  ASSERT_TRUE(graphics_family.has_value());
+
+  VkQueue queue = VK_NULL_HANDLE;
+  vkGetDeviceQueue(mDevice, graphics_family.value(), 0, &queue);
+
+  auto cmd_pool = CommandPool::make(mDevice, graphics_family.value());
+  ASSERT_TRUE(cmd_pool);
+
+  const std::array color_attachments = {
+      make_rendering_attachment_info(image_view,
+                                     VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL),
+  };
+
+  const VkRect2D render_area = {{0, 0}, extent};
+  const VkViewport viewport = {0, 0, 64, 64, 0, 1};
+
+  result = cmd_pool.execute_now(queue, [&](VkCommandBuffer cmd_buf) {
+    cmd_transition_to_color_attachment(cmd_buf, image);
+
+    cmd_begin_rendering(functions, cmd_buf, render_area, color_attachments);
+
+    vkCmdBindPipeline(cmd_buf, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    vkCmdSetViewport(cmd_buf, 0, 1, &viewport);
+    vkCmdSetScissor(cmd_buf, 0, 1, &render_area);
+
+    cmd_end_rendering(functions, cmd_buf);
+  });
+  EXPECT_EQ(result, VK_SUCCESS);
+}
+
+#endif  // VK_KHR_dynamic_rendering
@@ -0,0 +1,89 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/sampler_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include "test_utils.hpp"
+
+using namespace grace;
+
+GRACE_TEST_FIXTURE(SamplerCacheFixture);
+
+TEST_F(SamplerCacheFixture, Defaults)
+{
+  SamplerCache cache;
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.device(), VK_NULL_HANDLE);
+  EXPECT_NO_THROW(cache.clear());
+}
+
+TEST_F(SamplerCacheFixture, GetDeduplicatesSamplers)
+{
+  SamplerCache cache {mDevice, mGPU};
+
+  VkResult result = VK_ERROR_UNKNOWN;
+  VkSampler a = cache.get(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT, &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  ASSERT_NE(a, VK_NULL_HANDLE);
+
+  VkSampler b = cache.get(VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT, &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(cache.size(), 1);
+
+  VkSampler c = cache.get(VK_FILTER_NEAREST, VK_SAMPLER_ADDRESS_MODE_REPEAT, &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  EXPECT_NE(a, c);
+  EXPECT_EQ(cache.size(), 2);
+
+  cache.clear();
+  EXPECT_EQ(cache.size(), 0);
+}
+
+TEST_F(SamplerCacheFixture, MakeSamplerInfoUsesDeviceSnapshot)
+{
+  const SamplerCache cache {mDevice, mGPU};
+  const auto& gpu_info = cache.gpu_info();
+
+  const auto sampler_info = make_sampler_info(gpu_info,
+                                              VK_FILTER_NEAREST,
+                                              VK_FILTER_LINEAR,
+                                              VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+                                              1.0f,
+                                              8.0f);
+
+  EXPECT_EQ(sampler_info.sType, VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO);
+  EXPECT_EQ(sampler_info.pNext, nullptr);
+  EXPECT_EQ(sampler_info.minFilter, VK_FILTER_NEAREST);
+  EXPECT_EQ(sampler_info.magFilter, VK_FILTER_LINEAR);
+  EXPECT_EQ(sampler_info.addressModeU, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+  EXPECT_EQ(sampler_info.addressModeV, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+  EXPECT_EQ(sampler_info.addressModeW, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+  EXPECT_EQ(sampler_info.anisotropyEnable, gpu_info.features.samplerAnisotropy);
+  EXPECT_EQ(sampler_info.maxAnisotropy, gpu_info.properties.limits.maxSamplerAnisotropy);
+  EXPECT_EQ(sampler_info.minLod, 1.0f);
+  EXPECT_EQ(sampler_info.maxLod, 8.0f);
+}
@@ -0,0 +1,116 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/shader_hot_reload.hpp"
+
+#include <thread>  // yield
+
+#include <gtest/gtest.h>
+
+#include "test_utils.hpp"
+
+using namespace grace;
+
+GRACE_TEST_FIXTURE(ShaderHotReloadFixture);
+
+TEST_F(ShaderHotReloadFixture, ReloadIncompletePipeline)
+{
+  ThreadPool pool {1};
+  ShaderLibrary library {mDevice};
+  ShaderHotReloader reloader {pool, 2, &library};
+
+  GraphicsPipelineBuilder builder {mDevice};
+  builder.with_shader_library(&library)
+      .vertex_shader("assets/shaders/test.vert.spv")
+      .fragment_shader("assets/shaders/test.frag.spv");
+
+  // Pipelines are registered even if they can't be built
+  VkResult result = VK_SUCCESS;
+  const auto id = reloader.add(builder, &result);
+  EXPECT_EQ(result, VK_INCOMPLETE);
+  EXPECT_EQ(reloader.size(), 1u);
+  EXPECT_EQ(reloader.get(id), VK_NULL_HANDLE);
+
+  EXPECT_EQ(reloader.reload("assets/shaders/missing.spv"), 0u);
+  EXPECT_EQ(reloader.reload("assets/shaders/../shaders/test.vert.spv"), 1u);
+  EXPECT_EQ(reloader.pending_count(), 1u);
+
+  usize swap_count = 0;
+  while (reloader.pending_count() != 0) {
+    swap_count += reloader.update();
+    std::this_thread::yield();
+  }
+
+  EXPECT_EQ(swap_count, 0u);
+  EXPECT_EQ(reloader.retired_count(), 0u);
+  EXPECT_EQ(reloader.result(id), VK_INCOMPLETE);
+  EXPECT_EQ(reloader.get(id), VK_NULL_HANDLE);
+}
+
+TEST_F(ShaderHotReloadFixture, ReloadCompletePipeline)
+{
+  auto objects = make_test_pipeline_objects(mDevice);
+  ASSERT_TRUE(objects.render_pass);
+  ASSERT_TRUE(objects.pipeline_layout);
+
+  const uint32 frames_in_flight = 2;
+
+  // The builder's own shader library is invalidated by reloads
+  ThreadPool pool {1};
+  ShaderLibrary library {mDevice};
+  ShaderHotReloader reloader {pool, frames_in_flight};
+
+  auto builder = make_test_pipeline_builder(mDevice, objects);
+  builder.with_shader_library(&library);
+
+  VkResult result = VK_ERROR_UNKNOWN;
+  const auto id = reloader.add(builder, &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  const auto original_pipeline = reloader.get(id);
+  ASSERT_NE(original_pipeline, VK_NULL_HANDLE);
+
+  EXPECT_EQ(reloader.reload("assets/shaders/test.frag.spv"), 1u);
+  EXPECT_EQ(reloader.pending_count(), 1u);
+
+  usize swap_count = 0;
+  while (reloader.pending_count() != 0) {
+    swap_count += reloader.update();
+    std::this_thread::yield();
+  }
+
+  EXPECT_EQ(swap_count, 1u);
+  EXPECT_EQ(reloader.result(id), VK_SUCCESS);
+  EXPECT_NE(reloader.get(id), VK_NULL_HANDLE);
+  EXPECT_NE(reloader.get(id), original_pipeline);
+
+  // The replaced pipeline is destroyed once the frames in flight have retired
+  EXPECT_EQ(reloader.retired_count(), 1u);
+
+  for (uint32 frame = 0; frame < frames_in_flight; ++frame) {
+    EXPECT_EQ(reloader.update(), 0u);
+  }
+
+  EXPECT_EQ(reloader.retired_count(), 0u);
+}
@@ -0,0 +1,113 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/shader_library.hpp"
+
+#include <gtest/gtest.h>
+
+#include "grace/shader_module.hpp"
+#include "test_shaders.hpp"
+#include "test_utils.hpp"
+
+using namespace grace;
+
+GRACE_TEST_FIXTURE(ShaderLibraryFixture);
+
+TEST_F(ShaderLibraryFixture, GetModuleByPath)
+{
+  ShaderLibrary library {mDevice};
+  EXPECT_EQ(library.module_count(), 0u);
+
+  VkResult result = VK_ERROR_UNKNOWN;
+
+  const auto vertex_shader = library.get_module("assets/shaders/test.vert.spv", &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  ASSERT_NE(vertex_shader, VK_NULL_HANDLE);
+
+  EXPECT_EQ(library.get_module("assets/shaders/test.vert.spv"), vertex_shader);
+  EXPECT_EQ(library.module_count(), 1u);
+
+  const auto fragment_shader = library.get_module("assets/shaders/test.frag.spv");
+  EXPECT_NE(fragment_shader, VK_NULL_HANDLE);
+  EXPECT_NE(fragment_shader, vertex_shader);
+  EXPECT_EQ(library.module_count(), 2u);
+
+  library.clear();
+  EXPECT_EQ(library.module_count(), 0u);
+}
+
+TEST_F(ShaderLibraryFixture, GetModuleByContent)
+{
+  ShaderLibrary library {mDevice};
+
+  const auto code = read_binary_file("assets/shaders/test.vert.spv");
+  ASSERT_FALSE(code.empty());
+
+  // Identical code from different sources results in a single shader module
+  const auto module_from_code = library.get_module(code.data(), code.size());
+  const auto module_from_path = library.get_module("assets/shaders/test.vert.spv");
+
+  EXPECT_NE(module_from_code, VK_NULL_HANDLE);
+  EXPECT_EQ(module_from_code, module_from_path);
+  EXPECT_EQ(library.module_count(), 1u);
+}
+
+TEST_F(ShaderLibraryFixture, GetModuleByEmbeddedCode)
+{
+  ShaderLibrary library {mDevice};
+
+  const auto module_from_code =
+      library.get_module(test_shaders::kTestVertSpv, sizeof test_shaders::kTestVertSpv);
+  const auto module_from_path = library.get_module("assets/shaders/test.vert.spv");
+
+  EXPECT_NE(module_from_code, VK_NULL_HANDLE);
+  EXPECT_EQ(module_from_code, module_from_path);
+  EXPECT_EQ(library.module_count(), 1u);
+}
+
+TEST_F(ShaderLibraryFixture, GetReflection)
+{
+  ShaderLibrary library {mDevice};
+
+  VkResult result = VK_ERROR_UNKNOWN;
+  const auto reflection = library.get_reflection("assets/shaders/test.vert.spv", &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  EXPECT_EQ(reflection.stages, VK_SHADER_STAGE_VERTEX_BIT);
+  EXPECT_EQ(reflection.descriptors.size(), 1u);
+  EXPECT_EQ(library.module_count(), 1u);
+
+  (void) library.get_reflection("assets/shaders/missing.spv", &result);
+  EXPECT_NE(result, VK_SUCCESS);
+}
+
+TEST_F(ShaderLibraryFixture, MissingFile)
+{
+  ShaderLibrary library {mDevice};
+
+  VkResult result = VK_SUCCESS;
+  EXPECT_EQ(library.get_module("assets/shaders/missing.spv", &result), VK_NULL_HANDLE);
+  EXPECT_NE(result, VK_SUCCESS);
+  EXPECT_EQ(library.module_count(), 0u);
+}
@@ -0,0 +1,173 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/shader_object.hpp"
+
+#include <array>  // array
+
+#include <gtest/gtest.h>
+
+#include "grace/command_pool.hpp"
+#include "grace/descriptor_set_layout.hpp"
+#include "grace/physical_device.hpp"
+#include "test_shaders.hpp"
+#include "test_utils.hpp"
+
+using namespace grace;
+
+#ifdef VK_EXT_shader_object
+
+static_assert(WrapperType<ShaderObject, VkShaderEXT>);
+
+TEST(ShaderObject, MakeShaderObjectInfo)
+{
+  const std::array set_layouts = {make_fake_ptr<VkDescriptorSetLayout>(0x10)};
+  const std::array push_constant_ranges = {
+      VkPushConstantRange {VK_SHADER_STAGE_VERTEX_BIT, 0, 64}};
+
+  const VkShaderStageFlags next_stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+  const auto info = make_shader_object_info(VK_SHADER_STAGE_VERTEX_BIT,
+                                            next_stage,
+                                            test_shaders::kTestVertSpv,
+                                            "main",
+                                            set_layouts,
+                                            push_constant_ranges);
+
+  EXPECT_EQ(info.sType, VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT);
+  EXPECT_EQ(info.pNext, nullptr);
+  EXPECT_EQ(info.flags, 0u);
+  EXPECT_EQ(info.stage, VK_SHADER_STAGE_VERTEX_BIT);
+  EXPECT_EQ(info.nextStage, next_stage);
+  EXPECT_EQ(info.codeType, VK_SHADER_CODE_TYPE_SPIRV_EXT);
+  EXPECT_EQ(info.codeSize, sizeof test_shaders::kTestVertSpv);
+  EXPECT_EQ(info.pCode, test_shaders::kTestVertSpv);
+  EXPECT_STREQ(info.pName, "main");
+  EXPECT_EQ(info.setLayoutCount, 1u);
+  EXPECT_EQ(info.pSetLayouts, set_layouts.data());
+  EXPECT_EQ(info.pushConstantRangeCount, 1u);
+  EXPECT_EQ(info.pPushConstantRanges, push_constant_ranges.data());
+  EXPECT_EQ(info.pSpecializationInfo, nullptr);
+}
+
+GRACE_TEST_FIXTURE(ShaderObjectFixture);
+
+TEST_F(ShaderObjectFixture, DefaultConstructor)
+{
+  ShaderObject shader;
+  EXPECT_FALSE(shader);
+  EXPECT_EQ(shader.device(), VK_NULL_HANDLE);
+  EXPECT_EQ(shader.get(), VK_NULL_HANDLE);
+  EXPECT_EQ(static_cast<VkShaderEXT>(shader), VK_NULL_HANDLE);
+  EXPECT_NO_THROW(shader.destroy());
+}
+
+TEST_F(ShaderObjectFixture, MakeWithoutExtension)
+{
+  const ShaderObjectFunctions functions;
+  const auto info = make_shader_object_info(VK_SHADER_STAGE_FRAGMENT_BIT,
+                                            0,
+                                            test_shaders::kTestFragSpv);
+
+  VkResult result = VK_SUCCESS;
+  EXPECT_FALSE(ShaderObject::make(mDevice, functions, info, &result));
+  EXPECT_EQ(result, VK_ERROR_EXTENSION_NOT_PRESENT);
+}
+
+TEST_F(ShaderObjectFixture, BindLinkedShaders)
+{
+  const auto functions = get_shader_object_functions(mDevice);
+  if (!functions.vkCreateShadersEXT) {
+    GTEST_SKIP() << "VK_EXT_shader_object is not supported";
+  }
+
+  VkResult result = VK_ERROR_UNKNOWN;
+
+  auto set_layout =
+      DescriptorSetLayoutBuilder {mDevice}
+          .descriptor(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT)
+          .build(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  const std::array set_layouts = {set_layout.get()};
+  const std::array push_constant_ranges = {
+      VkPushConstantRange {VK_SHADER_STAGE_VERTEX_BIT, 0, 16 * sizeof(float)}};
+
+  std::array shader_infos = {
+      make_shader_object_info(VK_SHADER_STAGE_VERTEX_BIT,
+                              VK_SHADER_STAGE_FRAGMENT_BIT,
+                              test_shaders::kTestVertSpv,
+                              "main",
+                              set_layouts,
+                              push_constant_ranges),
+      make_shader_object_info(VK_SHADER_STAGE_FRAGMENT_BIT,
+                              0,
+                              test_shaders::kTestFragSpv,
+                              "main",
+                              set_layouts,
+                              push_constant_ranges),
+  };
+
+  for (auto& info : shader_infos) {
+    info.flags = VK_SHADER_CREATE_LINK_STAGE_BIT_EXT;
+  }
+
+  auto shaders = ShaderObject::make_all(mDevice, functions, shader_infos, &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  ASSERT_EQ(shaders.size(), 2u);
+  EXPECT_TRUE(shaders[0]);
+  EXPECT_TRUE(shaders[1]);
+
+  const auto queue_families = get_queue_family_indices(mGPU, mSurface);
+  ASSERT_TRUE(queue_families.graphics.has_value());
+
+  auto command_pool = CommandPool::make(mDevice, *queue_families.graphics, 0, &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  auto* cmd_buf = alloc_command_buffer(mDevice, command_pool, &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  // The state is taken from a pipeline builder, as if it were baked into a pipeline
+  GraphicsPipelineBuilder builder {mDevice};
+  builder.vertex_input_binding(0, 8 * sizeof(float))
+      .vertex_attribute(0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0)
+      .rasterization(VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT)
+      .depth_test(true)
+      .depth_write(true)
+      .color_blend_attachment(false)
+      .viewport(0, 0, 800, 600)
+      .scissor(0, 0, 800, 600);
+
+  const auto begin_info = make_command_buffer_begin_info();
+  ASSERT_EQ(vkBeginCommandBuffer(cmd_buf, &begin_info), VK_SUCCESS);
+
+  // The test context enables neither tessellation nor geometry shaders, so only the
+  // vertex and fragment stages are bound
+  cmd_bind_graphics_shaders(functions, cmd_buf, mEnabledFeatures, shaders[0], shaders[1]);
+  cmd_set_graphics_state(functions, cmd_buf, builder);
+
+  EXPECT_EQ(vkEndCommandBuffer(cmd_buf), VK_SUCCESS);
+}
+
+#endif  // VK_EXT_shader_object
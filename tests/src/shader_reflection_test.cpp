@@ -0,0 +1,341 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/shader_reflection.hpp"
+
+#include <initializer_list>  // initializer_list
+#include <vector>            // vector
+
+#include <gtest/gtest.h>
+
+#include "grace/compute_pipeline.hpp"
+#include "grace/descriptor_set_layout.hpp"
+#include "grace/pipeline.hpp"
+#include "grace/pipeline_layout.hpp"
+#include "grace/shader_module.hpp"
+#include "test_utils.hpp"
+
+using namespace grace;
+
+namespace {
+
+inline constexpr uint32 kOpEntryPoint = 15;
+inline constexpr uint32 kOpTypeInt = 21;
+inline constexpr uint32 kOpTypeFloat = 22;
+inline constexpr uint32 kOpTypeVector = 23;
+inline constexpr uint32 kOpTypeImage = 25;
+inline constexpr uint32 kOpTypeSampledImage = 27;
+inline constexpr uint32 kOpTypeArray = 28;
+inline constexpr uint32 kOpTypeRuntimeArray = 29;
+inline constexpr uint32 kOpTypeStruct = 30;
+inline constexpr uint32 kOpTypePointer = 32;
+inline constexpr uint32 kOpConstant = 43;
+inline constexpr uint32 kOpSpecConstant = 50;
+inline constexpr uint32 kOpVariable = 59;
+inline constexpr uint32 kOpDecorate = 71;
+
+inline constexpr uint32 kDecorationLocation = 30;
+inline constexpr uint32 kDecorationBinding = 33;
+inline constexpr uint32 kDecorationDescriptorSet = 34;
+
+inline constexpr uint32 kStorageClassUniformConstant = 0;
+inline constexpr uint32 kStorageClassInput = 1;
+inline constexpr uint32 kStorageClassPushConstant = 9;
+
+// Assembles SPIR-V modules with a "main" entry point, without any function bodies.
+class SpirvAssembler final {
+ public:
+  explicit SpirvAssembler(const uint32 execution_model)
+      : mWords {0x07230203, 0x00010000, 0, 100, 0}
+  {
+    op(kOpEntryPoint, {execution_model, 1, 0x6E69616D, 0});
+  }
+
+  void op(const uint32 opcode, const std::initializer_list<uint32> operands)
+  {
+    const auto word_count = static_cast<uint32>(operands.size() + 1);
+    mWords.push_back((word_count << 16u) | opcode);
+    mWords.insert(mWords.end(), operands);
+  }
+
+  [[nodiscard]] auto reflect(VkResult* result) const -> ShaderReflection
+  {
+    return reflect_shader(mWords.data(), mWords.size() * sizeof(uint32), result);
+  }
+
+ private:
+  std::vector<uint32> mWords;
+};
+
+// Declares a sampler array sized by a specialization constant, and a runtime array.
+[[nodiscard]] auto make_descriptor_array_spirv() -> SpirvAssembler
+{
+  SpirvAssembler spirv {4};
+  spirv.op(kOpDecorate, {10, kDecorationDescriptorSet, 1});
+  spirv.op(kOpDecorate, {10, kDecorationBinding, 0});
+  spirv.op(kOpDecorate, {11, kDecorationDescriptorSet, 1});
+  spirv.op(kOpDecorate, {11, kDecorationBinding, 1});
+  spirv.op(kOpTypeFloat, {2, 32});
+  spirv.op(kOpTypeImage, {3, 2, 1, 0, 0, 0, 1, 0});
+  spirv.op(kOpTypeSampledImage, {4, 3});
+  spirv.op(kOpTypeInt, {5, 32, 0});
+  spirv.op(kOpSpecConstant, {5, 6, 4});
+  spirv.op(kOpTypeArray, {7, 4, 6});
+  spirv.op(kOpTypeRuntimeArray, {8, 4});
+  spirv.op(kOpTypePointer, {20, kStorageClassUniformConstant, 7});
+  spirv.op(kOpTypePointer, {21, kStorageClassUniformConstant, 8});
+  spirv.op(kOpVariable, {20, 10, kStorageClassUniformConstant});
+  spirv.op(kOpVariable, {21, 11, kStorageClassUniformConstant});
+
+  return spirv;
+}
+
+}  // namespace
+
+TEST(ShaderReflection, VertexShader)
+{
+  const auto code = read_binary_file("assets/shaders/test.vert.spv");
+  ASSERT_FALSE(code.empty());
+
+  VkResult result = VK_ERROR_UNKNOWN;
+  const auto reflection = reflect_shader(code.data(), code.size(), &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  EXPECT_EQ(reflection.stages, VK_SHADER_STAGE_VERTEX_BIT);
+  EXPECT_EQ(reflection.entry_point, "main");
+
+  // Unused inputs are stripped by the shader compiler
+  ASSERT_EQ(reflection.vertex_inputs.size(), 1u);
+  EXPECT_EQ(reflection.vertex_inputs[0].location, 0u);
+  EXPECT_EQ(reflection.vertex_inputs[0].format, VK_FORMAT_R32G32B32_SFLOAT);
+  EXPECT_EQ(reflection.vertex_inputs[0].size, 12u);
+
+  ASSERT_EQ(reflection.descriptors.size(), 1u);
+  EXPECT_EQ(reflection.descriptors[0].set, 0u);
+  EXPECT_EQ(reflection.descriptors[0].binding, 0u);
+  EXPECT_EQ(reflection.descriptors[0].type, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+  EXPECT_EQ(reflection.descriptors[0].count, 1u);
+  EXPECT_EQ(reflection.descriptors[0].stages, VK_SHADER_STAGE_VERTEX_BIT);
+
+  EXPECT_EQ(reflection.push_constant_offset, 0u);
+  EXPECT_EQ(reflection.push_constant_size, 64u);
+}
+
+TEST(ShaderReflection, FragmentShader)
+{
+  const auto code = read_binary_file("assets/shaders/test.frag.spv");
+  ASSERT_FALSE(code.empty());
+
+  VkResult result = VK_ERROR_UNKNOWN;
+  const auto reflection = reflect_shader(code.data(), code.size(), &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  EXPECT_EQ(reflection.stages, VK_SHADER_STAGE_FRAGMENT_BIT);
+  EXPECT_TRUE(reflection.descriptors.empty());
+  EXPECT_TRUE(reflection.vertex_inputs.empty());
+  EXPECT_EQ(reflection.push_constant_size, 0u);
+}
+
+TEST(ShaderReflection, MergeReflections)
+{
+  const auto vertex_code = read_binary_file("assets/shaders/test.vert.spv");
+  const auto fragment_code = read_binary_file("assets/shaders/test.frag.spv");
+
+  const auto vertex = reflect_shader(vertex_code.data(), vertex_code.size());
+  const auto fragment = reflect_shader(fragment_code.data(), fragment_code.size());
+
+  const auto merged = merge_shader_reflections(fragment, vertex);
+  EXPECT_EQ(merged.stages, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT);
+  EXPECT_EQ(merged.descriptors.size(), 1u);
+  EXPECT_EQ(merged.vertex_inputs.size(), 1u);
+  EXPECT_EQ(merged.push_constant_size, 64u);
+}
+
+TEST(ShaderReflection, MalformedCode)
+{
+  const uint32 garbage[] = {0xDEADBEEF, 1, 2, 3, 4, 5};
+
+  VkResult result = VK_SUCCESS;
+  const auto reflection = reflect_shader(garbage, sizeof garbage, &result);
+  EXPECT_EQ(result, VK_ERROR_UNKNOWN);
+  EXPECT_EQ(reflection.stages, 0u);
+
+  result = VK_SUCCESS;
+  (void) reflect_shader(garbage, 3, &result);
+  EXPECT_EQ(result, VK_ERROR_UNKNOWN);
+}
+
+TEST(ShaderReflection, DescriptorArrays)
+{
+  VkResult result = VK_ERROR_UNKNOWN;
+  const auto reflection = make_descriptor_array_spirv().reflect(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  ASSERT_EQ(reflection.descriptors.size(), 2u);
+
+  // The length of the array is the default value of the specialization constant
+  EXPECT_EQ(reflection.descriptors[0].set, 1u);
+  EXPECT_EQ(reflection.descriptors[0].binding, 0u);
+  EXPECT_EQ(reflection.descriptors[0].type, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+  EXPECT_EQ(reflection.descriptors[0].count, 4u);
+
+  EXPECT_EQ(reflection.descriptors[1].binding, 1u);
+  EXPECT_EQ(reflection.descriptors[1].count, 0u);
+}
+
+TEST(ShaderReflection, UnsupportedVertexInput)
+{
+  SpirvAssembler spirv {0};
+  spirv.op(kOpDecorate, {10, kDecorationLocation, 0});
+  spirv.op(kOpDecorate, {11, kDecorationLocation, 1});
+  spirv.op(kOpTypeInt, {2, 8, 0});
+  spirv.op(kOpTypeFloat, {3, 32});
+  spirv.op(kOpTypeVector, {4, 3, 2});
+  spirv.op(kOpTypePointer, {5, kStorageClassInput, 2});
+  spirv.op(kOpTypePointer, {6, kStorageClassInput, 4});
+  spirv.op(kOpVariable, {5, 10, kStorageClassInput});
+  spirv.op(kOpVariable, {6, 11, kStorageClassInput});
+
+  VkResult result = VK_ERROR_UNKNOWN;
+  const auto reflection = spirv.reflect(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  // There is no vertex format for 8-bit integers
+  ASSERT_EQ(reflection.vertex_inputs.size(), 1u);
+  EXPECT_EQ(reflection.vertex_inputs[0].location, 1u);
+  EXPECT_EQ(reflection.vertex_inputs[0].format, VK_FORMAT_R32G32_SFLOAT);
+  EXPECT_EQ(reflection.vertex_inputs[0].size, 8u);
+}
+
+TEST(ShaderReflection, CyclicTypes)
+{
+  SpirvAssembler spirv {5};
+  spirv.op(kOpDecorate, {11, kDecorationBinding, 0});
+  spirv.op(kOpTypeStruct, {2, 2});
+  spirv.op(kOpTypeInt, {3, 32, 0});
+  spirv.op(kOpConstant, {3, 4, 2});
+  spirv.op(kOpTypeArray, {5, 5, 4});
+  spirv.op(kOpTypePointer, {6, kStorageClassPushConstant, 2});
+  spirv.op(kOpTypePointer, {7, kStorageClassUniformConstant, 5});
+  spirv.op(kOpVariable, {6, 10, kStorageClassPushConstant});
+  spirv.op(kOpVariable, {7, 11, kStorageClassUniformConstant});
+
+  VkResult result = VK_ERROR_UNKNOWN;
+  const auto reflection = spirv.reflect(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  EXPECT_EQ(reflection.stages, VK_SHADER_STAGE_COMPUTE_BIT);
+  EXPECT_TRUE(reflection.descriptors.empty());
+  EXPECT_EQ(reflection.push_constant_size, 0u);
+}
+
+GRACE_TEST_FIXTURE(ShaderReflectionFixture);
+
+TEST_F(ShaderReflectionFixture, PopulateGraphicsPipeline)
+{
+  const auto vertex_code = read_binary_file("assets/shaders/test.vert.spv");
+  const auto fragment_code = read_binary_file("assets/shaders/test.frag.spv");
+
+  const auto vertex = reflect_shader(vertex_code.data(), vertex_code.size());
+  const auto fragment = reflect_shader(fragment_code.data(), fragment_code.size());
+  const auto reflection = merge_shader_reflections(vertex, fragment);
+
+  VkResult result = VK_ERROR_UNKNOWN;
+
+  DescriptorSetLayoutBuilder set_layout_builder {mDevice};
+  populate_descriptor_set_layout(reflection, 0, set_layout_builder);
+
+  auto set_layout = set_layout_builder.build(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  ASSERT_TRUE(set_layout);
+
+  PipelineLayoutBuilder layout_builder {mDevice};
+  layout_builder.descriptor_set_layout(set_layout);
+  populate_push_constants(reflection, layout_builder);
+
+  auto layout = layout_builder.build(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  ASSERT_TRUE(layout);
+
+  auto objects = make_test_pipeline_objects(mDevice);
+  ASSERT_TRUE(objects.render_pass);
+
+  GraphicsPipelineBuilder builder {mDevice};
+  builder.with_layout(layout)
+      .with_render_pass(objects.render_pass, 0)
+      .vertex_shader("assets/shaders/test.vert.spv")
+      .fragment_shader("assets/shaders/test.frag.spv")
+      .color_blend_attachment(false)
+      .dynamic_state(VK_DYNAMIC_STATE_VIEWPORT)
+      .dynamic_state(VK_DYNAMIC_STATE_SCISSOR);
+  populate_vertex_input(reflection, builder);
+
+  auto pipeline = builder.build(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  EXPECT_TRUE(pipeline);
+}
+
+TEST_F(ShaderReflectionFixture, PopulateComputePipeline)
+{
+  const auto code = read_binary_file("assets/shaders/test.comp.spv");
+
+  VkResult result = VK_ERROR_UNKNOWN;
+  const auto reflection = reflect_shader(code.data(), code.size(), &result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  ASSERT_EQ(reflection.descriptors.size(), 1u);
+  EXPECT_EQ(reflection.descriptors[0].type, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+  EXPECT_EQ(reflection.local_size[0], 64u);
+
+  DescriptorSetLayoutBuilder set_layout_builder {mDevice};
+  populate_descriptor_set_layout(reflection, 0, set_layout_builder);
+
+  auto set_layout = set_layout_builder.build(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  auto layout =
+      PipelineLayoutBuilder {mDevice}.descriptor_set_layout(set_layout).build(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  ComputePipelineBuilder builder {mDevice};
+  builder.with_layout(layout).shader("assets/shaders/test.comp.spv");
+
+  auto pipeline = builder.build(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  EXPECT_TRUE(pipeline);
+}
+
+TEST_F(ShaderReflectionFixture, PopulateDescriptorArrays)
+{
+  VkResult result = VK_ERROR_UNKNOWN;
+  const auto reflection = make_descriptor_array_spirv().reflect(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+
+  // The runtime array would otherwise have no descriptors
+  DescriptorSetLayoutBuilder builder {mDevice};
+  populate_descriptor_set_layout(reflection, 1, builder, 8);
+
+  auto set_layout = builder.build(&result);
+  ASSERT_EQ(result, VK_SUCCESS);
+  EXPECT_TRUE(set_layout);
+}
@@ -0,0 +1,95 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/specialization_constants.hpp"
+
+#include <cstring>  // memcpy
+
+#include <gtest/gtest.h>
+
+using namespace grace;
+
+TEST(SpecializationConstants, Defaults)
+{
+  const SpecializationConstants constants;
+  EXPECT_TRUE(constants.empty());
+  EXPECT_EQ(constants.size(), 0u);
+
+  const auto info = constants.info();
+  EXPECT_EQ(info.mapEntryCount, 0u);
+  EXPECT_EQ(info.pMapEntries, nullptr);
+  EXPECT_EQ(info.dataSize, 0u);
+  EXPECT_EQ(info.pData, nullptr);
+}
+
+TEST(SpecializationConstants, Set)
+{
+  SpecializationConstants constants;
+  constants.set(2, 1.5f).set(0, true).set(1, uint64 {42});
+
+  ASSERT_EQ(constants.size(), 3u);
+
+  const auto info = constants.info();
+  ASSERT_EQ(info.mapEntryCount, 3u);
+  EXPECT_EQ(info.dataSize, sizeof(VkBool32) + sizeof(uint64) + sizeof(float));
+
+  // The entries are sorted by constant ID
+  EXPECT_EQ(info.pMapEntries[0].constantID, 0u);
+  EXPECT_EQ(info.pMapEntries[0].offset, 0u);
+  EXPECT_EQ(info.pMapEntries[0].size, sizeof(VkBool32));
+
+  EXPECT_EQ(info.pMapEntries[1].constantID, 1u);
+  EXPECT_EQ(info.pMapEntries[1].offset, 4u);
+  EXPECT_EQ(info.pMapEntries[1].size, sizeof(uint64));
+
+  EXPECT_EQ(info.pMapEntries[2].constantID, 2u);
+  EXPECT_EQ(info.pMapEntries[2].offset, 12u);
+  EXPECT_EQ(info.pMapEntries[2].size, sizeof(float));
+
+  const auto* data = static_cast<const std::byte*>(info.pData);
+
+  VkBool32 bool_value = VK_FALSE;
+  std::memcpy(&bool_value, data, sizeof bool_value);
+  EXPECT_EQ(bool_value, VK_TRUE);
+
+  float float_value = 0;
+  std::memcpy(&float_value, data + 12, sizeof float_value);
+  EXPECT_EQ(float_value, 1.5f);
+}
+
+TEST(SpecializationConstants, Overwrite)
+{
+  SpecializationConstants a;
+  a.set(0, 1).set(1, 2.0f);
+
+  SpecializationConstants b;
+  b.set(1, 2.0f).set(0, 5).set(0, 1);
+
+  EXPECT_EQ(a.size(), b.size());
+  EXPECT_EQ(a.get_data(), b.get_data());
+
+  b.clear();
+  EXPECT_TRUE(b.empty());
+  EXPECT_TRUE(b.get_data().empty());
+}
@@ -24,12 +24,28 @@
 
 #include "test_utils.hpp"
 
-#include <vector>  // vector
+#include <algorithm>  // any_of
+#include <cstring>    // strcmp
+#include <vector>     // vector
 
+#include "grace/dynamic_state.hpp"
+#include "grace/image.hpp"
 #include "grace/physical_device.hpp"
+#include "grace/pipeline_library.hpp"
+#include "grace/rendering.hpp"
 
 namespace grace {
 
+auto has_device_extension(VkPhysicalDevice gpu, const char* name) -> bool
+{
+  const auto extensions = get_extensions(gpu);
+  return std::any_of(extensions.begin(),
+                     extensions.end(),
+                     [name](const VkExtensionProperties& extension) {
+                       return std::strcmp(extension.extensionName, name) == 0;
+                     });
+}
+
 auto make_test_context() -> TestContext
 {
   TestContext ctx;
@@ -58,11 +74,130 @@ auto make_test_context() -> TestContext
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
   indexing_features.descriptorBindingPartiallyBound = VK_TRUE;
 
+  // Optional features are appended to the feature chain when they're supported
+  void** next_features = &indexing_features.pNext;
+
+  [[maybe_unused]] bool has_dynamic_rendering = false;
+
+#ifdef VK_KHR_dynamic_rendering
+  VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamic_rendering_features = {};
+  dynamic_rendering_features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+  dynamic_rendering_features.dynamicRendering = VK_TRUE;
+
+  if (has_device_extension(ctx.gpu, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME) &&
+      is_dynamic_rendering_supported(ctx.gpu)) {
+    device_extensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+    *next_features = &dynamic_rendering_features;
+    next_features = &dynamic_rendering_features.pNext;
+    has_dynamic_rendering = true;
+  }
+#endif  // VK_KHR_dynamic_rendering
+
+#ifdef VK_EXT_shader_object
+  // Shader objects are optional, so that their tests can be skipped on other devices
+  VkPhysicalDeviceShaderObjectFeaturesEXT shader_object_features = {};
+  shader_object_features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT;
+  shader_object_features.shaderObject = VK_TRUE;
+
+  // Shader objects require dynamic rendering
+  if (has_device_extension(ctx.gpu, VK_EXT_SHADER_OBJECT_EXTENSION_NAME) &&
+      has_dynamic_rendering) {
+    device_extensions.push_back(VK_EXT_SHADER_OBJECT_EXTENSION_NAME);
+    *next_features = &shader_object_features;
+    next_features = &shader_object_features.pNext;
+  }
+#endif  // VK_EXT_shader_object
+
+#ifdef VK_EXT_graphics_pipeline_library
+  VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT library_features = {};
+  library_features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+  library_features.graphicsPipelineLibrary = VK_TRUE;
+
+  if (is_graphics_pipeline_library_supported(ctx.gpu)) {
+    device_extensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+    device_extensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+    *next_features = &library_features;
+    next_features = &library_features.pNext;
+  }
+#endif  // VK_EXT_graphics_pipeline_library
+
+#ifdef VK_EXT_host_image_copy
+  VkPhysicalDeviceHostImageCopyFeaturesEXT host_image_copy_features = {};
+  host_image_copy_features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT;
+  host_image_copy_features.hostImageCopy = VK_TRUE;
+
+  if (is_host_image_copy_supported(ctx.gpu)) {
+    device_extensions.push_back(VK_KHR_COPY_COMMANDS_2_EXTENSION_NAME);
+    device_extensions.push_back(VK_KHR_FORMAT_FEATURE_FLAGS_2_EXTENSION_NAME);
+    device_extensions.push_back(VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME);
+    *next_features = &host_image_copy_features;
+    next_features = &host_image_copy_features.pNext;
+  }
+#endif  // VK_EXT_host_image_copy
+
+  [[maybe_unused]] const auto dynamic_state_support =
+      get_extended_dynamic_state_support(ctx.gpu);
+
+#ifdef VK_EXT_extended_dynamic_state
+  VkPhysicalDeviceExtendedDynamicStateFeaturesEXT dynamic_state1_features = {};
+  dynamic_state1_features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+  dynamic_state1_features.extendedDynamicState = VK_TRUE;
+
+  if (has_device_extension(ctx.gpu, VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME) &&
+      dynamic_state_support.state1) {
+    device_extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+    *next_features = &dynamic_state1_features;
+    next_features = &dynamic_state1_features.pNext;
+  }
+#endif  // VK_EXT_extended_dynamic_state
+
+#ifdef VK_EXT_extended_dynamic_state2
+  VkPhysicalDeviceExtendedDynamicState2FeaturesEXT dynamic_state2_features = {};
+  dynamic_state2_features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT;
+  dynamic_state2_features.extendedDynamicState2 = VK_TRUE;
+  dynamic_state2_features.extendedDynamicState2LogicOp = VK_TRUE;
+
+  if (has_device_extension(ctx.gpu, VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME) &&
+      dynamic_state_support.state2) {
+    device_extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME);
+    *next_features = &dynamic_state2_features;
+    next_features = &dynamic_state2_features.pNext;
+  }
+#endif  // VK_EXT_extended_dynamic_state2
+
+#ifdef VK_EXT_extended_dynamic_state3
+  VkPhysicalDeviceExtendedDynamicState3FeaturesEXT dynamic_state3_features = {};
+  dynamic_state3_features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+  dynamic_state3_features.extendedDynamicState3PolygonMode = VK_TRUE;
+  dynamic_state3_features.extendedDynamicState3DepthClampEnable = VK_TRUE;
+  dynamic_state3_features.extendedDynamicState3LogicOpEnable = VK_TRUE;
+
+  if (has_device_extension(ctx.gpu, VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME) &&
+      dynamic_state_support.state3) {
+    device_extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+    *next_features = &dynamic_state3_features;
+    next_features = &dynamic_state3_features.pNext;
+  }
+#endif  // VK_EXT_extended_dynamic_state3
+
+#ifdef VK_EXT_pipeline_creation_feedback
+  if (has_device_extension(ctx.gpu, VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME)) {
+    device_extensions.push_back(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+  }
+#endif  // VK_EXT_pipeline_creation_feedback
+
   const auto device_queue_infos = make_device_queue_infos(ctx.gpu, ctx.surface);
   const auto device_info = make_device_info(device_queue_infos.queues,
                                             layers,
                                             device_extensions,
-                                            nullptr,
+                                            &ctx.enabled_features,
                                             &indexing_features);
 
   ctx.device = Device::make(ctx.gpu, device_info);
@@ -71,4 +206,49 @@ auto make_test_context() -> TestContext
   return ctx;
 }
 
+auto make_test_pipeline_objects(VkDevice device) -> TestPipelineObjects
+{
+  TestPipelineObjects objects;
+
+  objects.render_pass = RenderPassBuilder {device}
+                            .color_attachment(VK_FORMAT_B8G8R8A8_UNORM)
+                            .begin_subpass()
+                            .use_color_attachment(0)
+                            .end_subpass()
+                            .build();
+
+  objects.descriptor_set_layout =
+      DescriptorSetLayoutBuilder {device}
+          .use_push_descriptors()
+          .descriptor(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT)
+          .build();
+
+  objects.pipeline_layout =
+      PipelineLayoutBuilder {device}
+          .descriptor_set_layout(objects.descriptor_set_layout)
+          .push_constant(VK_SHADER_STAGE_VERTEX_BIT, 0, 16 * sizeof(float))
+          .build();
+
+  return objects;
+}
+
+auto make_test_pipeline_builder(VkDevice device, TestPipelineObjects& objects)
+    -> GraphicsPipelineBuilder
+{
+  GraphicsPipelineBuilder builder {device};
+  builder.with_layout(objects.pipeline_layout)
+      .with_render_pass(objects.render_pass, 0)
+      .vertex_shader("assets/shaders/test.vert.spv")
+      .fragment_shader("assets/shaders/test.frag.spv")
+      .vertex_input_binding(0, 8 * sizeof(float))
+      .vertex_attribute(0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0)
+      .vertex_attribute(0, 1, VK_FORMAT_R32G32B32_SFLOAT, 3 * sizeof(float))
+      .vertex_attribute(0, 2, VK_FORMAT_R32G32_SFLOAT, 6 * sizeof(float))
+      .color_blend_attachment(false)
+      .dynamic_state(VK_DYNAMIC_STATE_VIEWPORT)
+      .dynamic_state(VK_DYNAMIC_STATE_SCISSOR);
+
+  return builder;
+}
+
 }  // namespace grace
@@ -36,9 +36,13 @@
 
 #include "grace/allocator.hpp"
 #include "grace/common.hpp"
+#include "grace/descriptor_set_layout.hpp"
 #include "grace/device.hpp"
 #include "grace/extras/window.hpp"
 #include "grace/instance.hpp"
+#include "grace/pipeline.hpp"
+#include "grace/pipeline_layout.hpp"
+#include "grace/render_pass.hpp"
 #include "grace/surface.hpp"
 
 namespace grace {
@@ -48,12 +52,30 @@ struct TestContext final {
   Instance instance;
   Surface surface;
   VkPhysicalDevice gpu {VK_NULL_HANDLE};
+  VkPhysicalDeviceFeatures enabled_features {};
   Device device;
   Allocator allocator;
 };
 
 [[nodiscard]] auto make_test_context() -> TestContext;
 
+// Indicates whether a device extension is available, and thus enabled in test contexts.
+[[nodiscard]] auto has_device_extension(VkPhysicalDevice gpu, const char* name) -> bool;
+
+/// The objects required to build pipelines that use the test shaders.
+struct TestPipelineObjects final {
+  RenderPass render_pass;
+  DescriptorSetLayout descriptor_set_layout;
+  PipelineLayout pipeline_layout;
+};
+
+[[nodiscard]] auto make_test_pipeline_objects(VkDevice device) -> TestPipelineObjects;
+
+// Returns a complete builder that loads the test shaders from files.
+[[nodiscard]] auto make_test_pipeline_builder(VkDevice device,
+                                              TestPipelineObjects& objects)
+    -> GraphicsPipelineBuilder;
+
 template <typename Ptr>
 [[nodiscard]] auto make_fake_ptr(const usize value) -> Ptr
 {
@@ -85,39 +107,42 @@ concept WrapperType = std::default_initializable<T> &&         //
 };  // namespace grace
 
 // Shorthand for creating a test fixture that properly configures a test context.
-#define GRACE_TEST_FIXTURE(Name)                            \
-  class Name : public testing::Test {                       \
-   public:                                                  \
-    static void SetUpTestSuite()                            \
-    {                                                       \
-      mCtx = grace::make_test_context();                    \
-      mWindow = mCtx->window.get();                         \
-      mInstance = mCtx->instance.get();                     \
-      mSurface = mCtx->surface.get();                       \
-      mGPU = mCtx->gpu;                                     \
-      mDevice = mCtx->device.get();                         \
-      mAllocator = mCtx->allocator.get();                   \
-    }                                                       \
-                                                            \
-    static void TearDownTestSuite()                         \
-    {                                                       \
-      mCtx.reset();                                         \
-      mWindow = nullptr;                                    \
-      mInstance = VK_NULL_HANDLE;                           \
-      mSurface = VK_NULL_HANDLE;                            \
-      mGPU = VK_NULL_HANDLE;                                \
-      mDevice = VK_NULL_HANDLE;                             \
-      mAllocator = VK_NULL_HANDLE;                          \
-    }                                                       \
-                                                            \
-   private:                                                 \
-    inline static std::optional<grace::TestContext> mCtx;   \
-                                                            \
-   protected:                                               \
-    inline static SDL_Window* mWindow {};                   \
-    inline static VkInstance mInstance {VK_NULL_HANDLE};    \
-    inline static VkSurfaceKHR mSurface {VK_NULL_HANDLE};   \
-    inline static VkPhysicalDevice mGPU {VK_NULL_HANDLE};   \
-    inline static VkDevice mDevice {VK_NULL_HANDLE};        \
-    inline static VmaAllocator mAllocator {VK_NULL_HANDLE}; \
+#define GRACE_TEST_FIXTURE(Name)                                \
+  class Name : public testing::Test {                           \
+   public:                                                      \
+    static void SetUpTestSuite()                                \
+    {                                                           \
+      mCtx = grace::make_test_context();                        \
+      mWindow = mCtx->window.get();                             \
+      mInstance = mCtx->instance.get();                         \
+      mSurface = mCtx->surface.get();                           \
+      mGPU = mCtx->gpu;                                         \
+      mEnabledFeatures = mCtx->enabled_features;                \
+      mDevice = mCtx->device.get();                             \
+      mAllocator = mCtx->allocator.get();                       \
+    }                                                           \
+                                                                \
+    static void TearDownTestSuite()                             \
+    {                                                           \
+      mCtx.reset();                                             \
+      mWindow = nullptr;                                        \
+      mInstance = VK_NULL_HANDLE;                               \
+      mSurface = VK_NULL_HANDLE;                                \
+      mGPU = VK_NULL_HANDLE;                                    \
+      mEnabledFeatures = {};                                    \
+      mDevice = VK_NULL_HANDLE;                                 \
+      mAllocator = VK_NULL_HANDLE;                              \
+    }                                                           \
+                                                                \
+   private:                                                     \
+    inline static std::optional<grace::TestContext> mCtx;       \
+                                                                \
+   protected:                                                   \
+    inline static SDL_Window* mWindow {};                       \
+    inline static VkInstance mInstance {VK_NULL_HANDLE};        \
+    inline static VkSurfaceKHR mSurface {VK_NULL_HANDLE};       \
+    inline static VkPhysicalDevice mGPU {VK_NULL_HANDLE};       \
+    inline static VkPhysicalDeviceFeatures mEnabledFeatures {}; \
+    inline static VkDevice mDevice {VK_NULL_HANDLE};            \
+    inline static VmaAllocator mAllocator {VK_NULL_HANDLE};     \
   }
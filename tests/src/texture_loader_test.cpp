@@ -0,0 +1,168 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/texture_loader.hpp"
+
+#include <cstdio>     // sscanf
+#include <cstring>    // memset
+#include <stdexcept>  // runtime_error
+
+#include <gtest/gtest.h>
+
+#include "grace/command_pool.hpp"
+#include "grace/physical_device.hpp"
+#include "grace/thread_pool.hpp"
+#include "test_utils.hpp"
+
+using namespace grace;
+
+namespace {
+
+// Decodes "<width>x<height>" file names into RGBA8 images filled with a single value
+[[nodiscard]] auto decode_fake_image(const std::filesystem::path& path,
+                                     TextureStagingArea& staging) -> bool
+{
+  const auto name = path.filename().string();
+  if (name == "throw") {
+    throw std::runtime_error {"Decoder failure"};
+  }
+
+  uint32 width = 0;
+  uint32 height = 0;
+  if (std::sscanf(name.c_str(), "%ux%u", &width, &height) != 2) {
+    return false;
+  }
+
+  const uint64 data_size = uint64 {width} * uint64 {height} * 4;
+
+  void* data = staging.allocate({width, height}, VK_FORMAT_R8G8B8A8_UNORM, data_size);
+  if (!data) {
+    return false;
+  }
+
+  std::memset(data, 0x7F, data_size);
+  return true;
+}
+
+}  // namespace
+
+GRACE_TEST_FIXTURE(TextureLoaderFixture);
+
+TEST_F(TextureLoaderFixture, StagingAreaAllocateAndFinish)
+{
+  TextureStagingArea staging {mAllocator};
+
+  void* data = staging.allocate({4, 2}, VK_FORMAT_R8G8B8A8_UNORM, 32);
+  ASSERT_NE(data, nullptr);
+  std::memset(data, 0, 32);
+
+  const auto staged = staging.finish(true);
+  EXPECT_EQ(staged.result, VK_SUCCESS);
+  EXPECT_TRUE(staged.buffer);
+  EXPECT_EQ(staged.extent.width, 4);
+  EXPECT_EQ(staged.extent.height, 2);
+  EXPECT_EQ(staged.format, VK_FORMAT_R8G8B8A8_UNORM);
+}
+
+TEST_F(TextureLoaderFixture, StagingAreaFailedDecode)
+{
+  TextureStagingArea staging {mAllocator};
+  ASSERT_NE(staging.allocate({4, 4}, VK_FORMAT_R8G8B8A8_UNORM, 64), nullptr);
+
+  const auto staged = staging.finish(false);
+  EXPECT_EQ(staged.result, VK_ERROR_INITIALIZATION_FAILED);
+}
+
+TEST_F(TextureLoaderFixture, StagingAreaDataSizeMismatch)
+{
+  TextureStagingArea staging {mAllocator};
+
+  // A 4x4 RGBA8 texture requires 64 bytes
+  EXPECT_EQ(staging.allocate({4, 4}, VK_FORMAT_R8G8B8A8_UNORM, 32), nullptr);
+
+  const auto staged = staging.finish(true);
+  EXPECT_EQ(staged.result, VK_ERROR_VALIDATION_FAILED_EXT);
+  EXPECT_FALSE(staged.buffer);
+}
+
+TEST_F(TextureLoaderFixture, StagingAreaFinishWithoutAllocation)
+{
+  TextureStagingArea staging {mAllocator};
+
+  const auto staged = staging.finish(true);
+  EXPECT_EQ(staged.result, VK_ERROR_INITIALIZATION_FAILED);
+  EXPECT_FALSE(staged.buffer);
+}
+
+TEST_F(TextureLoaderFixture, Flush)
+{
+  const auto graphics_family = get_queue_family_indices(mGPU, mSurface).graphics;
+  ASSERT_TRUE(graphics_family.has_value());
+
+  VkQueue queue = VK_NULL_HANDLE;
+  vkGetDeviceQueue(mDevice, graphics_family.value(), 0, &queue);
+
+  auto cmd_pool = CommandPool::make(mDevice, graphics_family.value());
+  ASSERT_TRUE(cmd_pool);
+
+  const CommandContext ctx {
+      .device = mDevice,
+      .queue = queue,
+      .cmd_pool = cmd_pool.get(),
+  };
+
+  ThreadPool pool {2};
+  TextureLoader loader {mDevice, mAllocator, pool, &decode_fake_image};
+
+  EXPECT_EQ(loader.enqueue("16x8"), 0);
+  EXPECT_EQ(loader.enqueue("invalid"), 1);
+  EXPECT_EQ(loader.enqueue("throw"), 2);
+  EXPECT_EQ(loader.enqueue("4x4", false), 3);
+  EXPECT_EQ(loader.pending_count(), 4);
+
+  VkResult result = VK_SUCCESS;
+  const auto textures = loader.flush(ctx, &result);
+
+  EXPECT_EQ(result, VK_ERROR_INITIALIZATION_FAILED);
+  EXPECT_EQ(loader.pending_count(), 0);
+  ASSERT_EQ(textures.size(), 4);
+
+  ASSERT_TRUE(textures[0]);
+  EXPECT_EQ(textures[0].image.info().extent.width, 16);
+  EXPECT_EQ(textures[0].image.info().extent.height, 8);
+  EXPECT_EQ(textures[0].image.info().mip_levels, 5);
+  EXPECT_EQ(textures[0].image.info().layout, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+  EXPECT_FALSE(textures[1]);
+  EXPECT_FALSE(textures[2]);
+
+  ASSERT_TRUE(textures[3]);
+  EXPECT_EQ(textures[3].image.info().mip_levels, 1);
+  EXPECT_EQ(textures[3].image.info().layout, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+  // The batch is cleared, even though some of the textures failed to load
+  result = VK_ERROR_UNKNOWN;
+  EXPECT_TRUE(loader.flush(ctx, &result).empty());
+  EXPECT_EQ(result, VK_SUCCESS);
+}
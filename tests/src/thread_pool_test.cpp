@@ -0,0 +1,68 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 Albin Johansson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grace/thread_pool.hpp"
+
+#include <atomic>  // atomic
+#include <future>  // future
+#include <vector>  // vector
+
+#include <gtest/gtest.h>
+
+using namespace grace;
+
+TEST(ThreadPool, AtLeastOneThread)
+{
+  const ThreadPool pool {0};
+  EXPECT_EQ(pool.thread_count(), 1u);
+}
+
+TEST(ThreadPool, Submit)
+{
+  ThreadPool pool {4};
+  EXPECT_EQ(pool.thread_count(), 4u);
+
+  std::vector<std::future<int>> futures;
+  for (int i = 0; i < 100; ++i) {
+    futures.push_back(pool.submit([i] { return i * i; }));
+  }
+
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(futures[static_cast<usize>(i)].get(), i * i);
+  }
+}
+
+TEST(ThreadPool, PendingTasksCompleteBeforeDestruction)
+{
+  std::atomic_int counter {0};
+
+  {
+    ThreadPool pool {2};
+    for (int i = 0; i < 50; ++i) {
+      (void) pool.submit([&counter] { ++counter; });
+    }
+  }
+
+  EXPECT_EQ(counter.load(), 50);
+}